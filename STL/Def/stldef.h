@@ -65,6 +65,13 @@ using is_nothrow_move_constructible = ::std::is_nothrow_move_constructible<T>;
 template <class T>
 using is_nothrow_move_assignable = ::std::is_nothrow_move_assignable<T>;
 
+// whether a object of T can be moved to other address by memmove, and the
+// source is then raw memory without calling destructor.
+// specialize it for such type which is not trivially copyable, e.g. a type
+// holding only a unique_ptr.
+template <class T>
+struct is_trivially_relocatable : ::std::is_trivially_copyable<T> {};
+
 /* using some utilities of namespace std */
 // default allocator
 template <class T>
@@ -177,6 +184,36 @@ using pair = ::std::pair<T1, T2>;
 template <class T>
 using initializer_list = ::std::initializer_list<T>;
 
+// whether container C has append_range for range R
+template <class C, class R, class = void_t<>>
+struct __has_append_range : false_type {};
+
+template <class C, class R>
+struct __has_append_range<
+    C, R,
+    void_t<decltype(::std::declval<C &>().append_range(::std::declval<R>()))>>
+    : true_type {};
+
+// append element of rg at the end of container c, by its append_range or
+// insert at end
+template <class Container, class Range>
+void __append_range(Container &c, Range &&rg, true_type) {
+  c.append_range(::std::forward<Range>(rg));
+}
+
+template <class Container, class Range>
+void __append_range(Container &c, Range &&rg, false_type) {
+  using ::std::begin;
+  using ::std::end;
+  c.insert(c.end(), begin(rg), end(rg));
+}
+
+template <class Container, class Range>
+void __append_range(Container &c, Range &&rg) {
+  __append_range(c, ::std::forward<Range>(rg),
+                 __has_append_range<Container, Range &&>());
+}
+
 STL_END
 
 #endif  // !_STLDEF_H__
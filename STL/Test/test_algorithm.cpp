@@ -0,0 +1,726 @@
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../algorithm.h"
+#include "../deque.h"
+#include "../list.h"
+#include "gtest/gtest.h"
+
+class AlgorithmTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    std::mt19937 gen(42);
+    for (int n : {0, 1, 2, 3, 7, 8, 9, 64, 65, 1000, 4097}) {
+      std::vector<int> v(n);
+      for (int &x : v) x = gen() % (n / 2 + 1);
+      test_data.push_back(v);
+    }
+  }
+
+  virtual void TearDown() {}
+
+  std::vector<std::vector<int>> test_data;
+};
+
+// make, push, pop and sort of a heap of Arity
+template <std::size_t Arity, class Compare>
+void heap_operation(std::vector<int> v, Compare comp) {
+  std::vector<int> sorted = v;
+  std::sort(sorted.begin(), sorted.end(), comp);
+  stl::make_heap<Arity>(v.begin(), v.end(), comp);
+  EXPECT_EQ(true, stl::is_heap<Arity>(v.begin(), v.end(), comp));
+  // pop half and push them back one by one
+  auto mid = v.end() - v.size() / 2;
+  for (auto last = v.end(); last != mid; --last) {
+    stl::pop_heap<Arity>(v.begin(), last, comp);
+    EXPECT_EQ(false, comp(*(last - 1), *std::max_element(v.begin(), last, comp)));
+    EXPECT_EQ(true, stl::is_heap<Arity>(v.begin(), last - 1, comp));
+  }
+  for (auto last = mid; last != v.end();)
+    stl::push_heap<Arity>(v.begin(), ++last, comp);
+  EXPECT_EQ(true, stl::is_heap<Arity>(v.begin(), v.end(), comp));
+  stl::sort_heap<Arity>(v.begin(), v.end(), comp);
+  EXPECT_EQ(sorted, v);
+}
+
+TEST_F(AlgorithmTest, HeapOperation) {
+  for (auto &v : test_data) {
+    heap_operation<2>(v, std::less<int>());
+    heap_operation<3>(v, std::greater<int>());
+    heap_operation<4>(v, std::less<int>());
+    heap_operation<8>(v, std::less<int>());
+  }
+  // binary heap is the same as std
+  std::vector<int> v = test_data.back();
+  stl::make_heap(v.begin(), v.end());
+  EXPECT_EQ(true, std::is_heap(v.begin(), v.end()));
+  std::vector<int> sv = v;
+  stl::pop_heap(v.begin(), v.end());
+  std::pop_heap(sv.begin(), sv.end());
+  EXPECT_EQ(sv.back(), v.back());
+  EXPECT_EQ(true, std::is_heap(v.begin(), v.end() - 1));
+  stl::push_heap(v.begin(), v.end());
+  stl::sort_heap(v.begin(), v.end());
+  EXPECT_EQ(true, std::is_sorted(v.begin(), v.end()));
+}
+
+TEST_F(AlgorithmTest, IsHeap) {
+  std::vector<int> v{9, 5, 8, 1, 2, 3, 4, 7, 6};
+  EXPECT_EQ(true, stl::is_heap(v.begin(), v.begin() + 7));
+  EXPECT_EQ(v.begin() + 7, stl::is_heap_until(v.begin(), v.end()));
+  // node 1 has children 4, 5, 6, 7
+  EXPECT_EQ(v.begin() + 7, stl::is_heap_until<4>(v.begin(), v.end()));
+  EXPECT_EQ(true, stl::is_heap<8>(v.begin(), v.end()));
+  EXPECT_EQ(v.begin() + 1,
+            stl::is_heap_until(v.begin(), v.end(), std::greater<int>()));
+}
+
+TEST_F(AlgorithmTest, HeapOfDequeAndMoveOnly) {
+  stl::deque<int> d(test_data.back().begin(), test_data.back().end());
+  stl::make_heap<4>(d.begin(), d.end());
+  EXPECT_EQ(true, stl::is_heap<4>(d.begin(), d.end()));
+  stl::sort_heap<4>(d.begin(), d.end());
+  EXPECT_EQ(true, std::is_sorted(d.begin(), d.end()));
+
+  std::vector<std::unique_ptr<int>> up;
+  for (int i = 0; i < 100; ++i) up.emplace_back(new int((i * 37) % 100));
+  auto comp = [](const std::unique_ptr<int> &a, const std::unique_ptr<int> &b) {
+    return *a < *b;
+  };
+  stl::make_heap<4>(up.begin(), up.end(), comp);
+  stl::sort_heap<4>(up.begin(), up.end(), comp);
+  for (int i = 0; i < 100; ++i) EXPECT_EQ(i, *up[i]);
+}
+
+// input patterns sort has special case for, n element
+std::vector<std::vector<int>> sort_patterns(int n) {
+  std::mt19937 gen(7);
+  std::vector<std::vector<int>> patterns(7, std::vector<int>(n));
+  for (int i = 0; i < n; ++i) {
+    patterns[0][i] = gen();                      // random
+    patterns[1][i] = i;                          // sorted
+    patterns[2][i] = n - i;                      // reverse
+    patterns[3][i] = gen() % 4;                  // few unique
+    patterns[4][i] = 0;                          // all equal
+    patterns[5][i] = i < n / 2 ? i : n - i;      // organ pipe
+    patterns[6][i] = i % 2 ? i : n - i;          // interleaved
+  }
+  // sorted but a few
+  if (n > 2) std::swap(patterns[1][n / 3], patterns[1][n - 1]);
+  return patterns;
+}
+
+TEST_F(AlgorithmTest, Sort) {
+  for (auto &v : test_data) {
+    std::vector<int> sorted = v;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> sv = v;
+    stl::sort(sv.begin(), sv.end());
+    EXPECT_EQ(sorted, sv);
+    sv = v;
+    // not branch-free
+    stl::sort(sv.begin(), sv.end(), [](int a, int b) { return a < b; });
+    EXPECT_EQ(sorted, sv);
+    sv = v;
+    stl::sort(sv.begin(), sv.end(), std::greater<int>());
+    EXPECT_EQ(true, std::is_sorted(sv.begin(), sv.end(), std::greater<int>()));
+  }
+  for (int n : {10, 100, 1000, 100000}) {
+    for (auto &v : sort_patterns(n)) {
+      std::vector<int> sorted = v;
+      std::sort(sorted.begin(), sorted.end());
+      std::vector<int> sv = v;
+      stl::sort(sv.begin(), sv.end());
+      EXPECT_EQ(sorted, sv);
+      std::vector<double> dv(v.begin(), v.end());
+      stl::sort(dv.begin(), dv.end(), std::less<>());
+      EXPECT_EQ(true, std::is_sorted(dv.begin(), dv.end()));
+      // comparison is bounded by O(n log n) on every pattern
+      long long count = 0;
+      sv = v;
+      stl::sort(sv.begin(), sv.end(), [&count](int a, int b) {
+        ++count;
+        return a < b;
+      });
+      EXPECT_EQ(sorted, sv);
+      EXPECT_GT(4LL * n * 17, count);
+    }
+  }
+}
+
+TEST_F(AlgorithmTest, SortOfDequeAndMoveOnly) {
+  std::mt19937 gen(3);
+  stl::deque<int> d;
+  for (int i = 0; i < 5000; ++i) d.push_back(gen() % 1000);
+  stl::sort(d.begin(), d.end());
+  EXPECT_EQ(true, std::is_sorted(d.begin(), d.end()));
+
+  std::vector<std::string> sv;
+  for (int i = 0; i < 1000; ++i) sv.push_back(std::to_string(gen() % 300));
+  std::vector<std::string> sorted = sv;
+  std::sort(sorted.begin(), sorted.end());
+  stl::sort(sv.begin(), sv.end());
+  EXPECT_EQ(sorted, sv);
+
+  std::vector<std::unique_ptr<int>> up;
+  for (int i = 0; i < 1000; ++i) up.emplace_back(new int((i * 37) % 1000));
+  stl::sort(up.begin(), up.end(),
+            [](const std::unique_ptr<int> &a, const std::unique_ptr<int> &b) {
+              return *a < *b;
+            });
+  for (int i = 0; i < 1000; ++i) EXPECT_EQ(i, *up[i]);
+}
+
+template <class T>
+void radix_sort_of(std::vector<T> v) {
+  std::vector<T> sorted = v;
+  std::sort(sorted.begin(), sorted.end());
+  stl::radix_sort(v.begin(), v.end());
+  EXPECT_EQ(sorted, v);
+}
+
+TEST_F(AlgorithmTest, RadixSort) {
+  std::mt19937_64 gen(5);
+  for (int n : {0, 1, 10, 63, 64, 1000, 300000}) {
+    std::vector<std::uint32_t> u32(n);
+    std::vector<std::int64_t> i64(n);
+    std::vector<short> i16(n);
+    std::vector<float> f(n);
+    std::vector<double> d(n);
+    for (int i = 0; i < n; ++i) {
+      u32[i] = static_cast<std::uint32_t>(gen());
+      i64[i] = static_cast<std::int64_t>(gen());
+      i16[i] = static_cast<short>(gen() % 100) - 50;
+      f[i] = static_cast<float>(static_cast<std::int64_t>(gen() % 2001) - 1000) / 7;
+      d[i] = static_cast<double>(static_cast<std::int64_t>(gen())) * 1e-300;
+    }
+    radix_sort_of(u32);
+    radix_sort_of(i64);
+    radix_sort_of(i16);
+    radix_sort_of(f);
+    radix_sort_of(d);
+  }
+  // every digit is the same but the lowest one
+  std::vector<std::uint64_t> same(1000, 0xabcdef0000ULL);
+  for (int i = 0; i < 1000; ++i) same[i] += (i * 37) % 256;
+  radix_sort_of(same);
+  // sorted on the deque
+  stl::deque<int> dq(test_data.back().begin(), test_data.back().end());
+  stl::radix_sort(dq.begin(), dq.end());
+  EXPECT_EQ(true, std::is_sorted(dq.begin(), dq.end()));
+}
+
+TEST_F(AlgorithmTest, RadixSortByKey) {
+  // stable, the element of the same key keeps its order
+  std::mt19937 gen(9);
+  for (int n : {50, 5000, 50000}) {
+    std::vector<std::pair<int, std::string>> v;
+    for (int i = 0; i < n; ++i)
+      v.emplace_back(static_cast<int>(gen() % 100) - 50, std::to_string(i));
+    std::vector<std::pair<int, std::string>> sorted = v;
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const std::pair<int, std::string> &a,
+                        const std::pair<int, std::string> &b) {
+                       return a.first < b.first;
+                     });
+    stl::radix_sort(v.begin(), v.end(),
+                    [](const std::pair<int, std::string> &x) { return x.first; });
+    EXPECT_EQ(sorted, v);
+  }
+  // descending by negating the key
+  std::vector<int> v = test_data.back();
+  stl::radix_sort(v.begin(), v.end(), [](int x) { return -static_cast<long>(x); });
+  EXPECT_EQ(true, std::is_sorted(v.begin(), v.end(), std::greater<int>()));
+}
+
+// sort_small of every size up to past the network
+template <class T, class Sort>
+void sort_small_sizes(Sort sort, std::mt19937 &gen) {
+  std::vector<T> special = {std::numeric_limits<T>::max(),
+                            std::numeric_limits<T>::lowest(), T(0), T(1)};
+  for (std::size_t n = 0; n <= 70; ++n) {
+    for (int rep = 0; rep < 20; ++rep) {
+      std::vector<T> v(n);
+      for (T &x : v)
+        x = gen() % 4 == 0 ? special[gen() % special.size()]
+                           : static_cast<T>(static_cast<int>(gen() % 200) - 100);
+      std::vector<T> sorted = v;
+      std::sort(sorted.begin(), sorted.end());
+      sort(v);
+      EXPECT_EQ(sorted, v);
+    }
+  }
+}
+
+template <class T>
+void sort_small_all(std::mt19937 &gen) {
+  sort_small_sizes<T>(
+      [](std::vector<T> &v) { stl::sort_small(v.begin(), v.end()); }, gen);
+  sort_small_sizes<T>([](std::vector<T> &v) {
+    stl::deque<T> d(v.begin(), v.end());
+    stl::sort_small(d.begin(), d.end(), std::less<T>());
+    std::copy(d.begin(), d.end(), v.begin());
+  }, gen);
+}
+
+// network kernel of every instruction set the machine has
+template <class T>
+void sort_network_kernels(std::mt19937 &gen) {
+#ifdef __STL_SORT_NETWORK
+  auto kernel = [](void (*k)(T *, std::size_t)) {
+    return [k](std::vector<T> &v) {
+      if (v.size() <= stl::__sort_network_max)
+        k(v.data(), v.size());
+      else
+        stl::sort(v.begin(), v.end());
+    };
+  };
+  sort_small_sizes<T>(kernel(stl::__sort_network_sse2<T>), gen);
+  if (__builtin_cpu_supports("avx2"))
+    sort_small_sizes<T>(kernel(stl::__sort_network_avx2<T>), gen);
+  if (__builtin_cpu_supports("avx512f"))
+    sort_small_sizes<T>(kernel(stl::__sort_network_avx512<T>), gen);
+#endif
+}
+
+TEST_F(AlgorithmTest, SortSmall) {
+  std::mt19937 gen(11);
+  sort_small_all<int>(gen);
+  sort_small_all<unsigned>(gen);
+  sort_small_all<float>(gen);
+  sort_small_all<std::int64_t>(gen);
+  sort_small_all<short>(gen);
+  sort_network_kernels<int>(gen);
+  sort_network_kernels<unsigned>(gen);
+  sort_network_kernels<float>(gen);
+  // -0.0 and 0.0 are equal, infinity at either end
+  std::vector<float> v = {0.0f, -0.0f, std::numeric_limits<float>::infinity(),
+                          -1.5f, -std::numeric_limits<float>::infinity(), 2.0f};
+  stl::sort_small(v.begin(), v.end());
+  EXPECT_EQ(true, std::is_sorted(v.begin(), v.end()));
+  // other order is sorted by sort
+  std::vector<int> w = test_data[9];
+  w.resize(50);
+  stl::sort_small(w.begin(), w.end(), std::greater<int>());
+  EXPECT_EQ(true, std::is_sorted(w.begin(), w.end(), std::greater<int>()));
+}
+
+// element of key and its position, to check stability
+typedef std::pair<int, int> keyed;
+
+std::vector<keyed> keyed_of(const std::vector<int> &v) {
+  std::vector<keyed> kv;
+  for (std::size_t i = 0; i < v.size(); ++i)
+    kv.emplace_back(v[i] / 4, static_cast<int>(i));
+  return kv;
+}
+
+bool key_less(const keyed &a, const keyed &b) { return a.first < b.first; }
+
+// allocator counting its allocations
+template <class T>
+struct counting_allocator : std::allocator<T> {
+  template <class U>
+  struct rebind {
+    typedef counting_allocator<U> other;
+  };
+
+  explicit counting_allocator(int *count) : count(count) {}
+
+  template <class U>
+  counting_allocator(const counting_allocator<U> &other)
+      : count(other.count) {}
+
+  T *allocate(std::size_t n) {
+    ++*count;
+    return std::allocator<T>::allocate(n);
+  }
+
+  int *count;
+};
+
+TEST_F(AlgorithmTest, StableSort) {
+  std::vector<int> sizes = {0, 1, 2, 31, 32, 33, 100, 1000, 100000};
+  for (int n : sizes) {
+    for (auto &v : sort_patterns(n)) {
+      std::vector<keyed> expected = keyed_of(v);
+      std::stable_sort(expected.begin(), expected.end(), key_less);
+      std::vector<keyed> kv = keyed_of(v);
+      stl::stable_sort(kv.begin(), kv.end(), key_less);
+      EXPECT_EQ(expected, kv);
+      // a buffer of every size, none is in place
+      for (std::size_t size : {std::size_t(0), std::size_t(7),
+                               std::size_t(n / 8), std::size_t(n / 2 + 1)}) {
+        std::vector<keyed> buffer(size);
+        kv = keyed_of(v);
+        stl::stable_sort(kv.begin(), kv.end(), key_less, buffer.data(), size);
+        EXPECT_EQ(expected, kv);
+      }
+      std::vector<int> sorted = v;
+      std::sort(sorted.begin(), sorted.end());
+      std::vector<int> sv = v;
+      stl::stable_sort(sv.begin(), sv.end());
+      EXPECT_EQ(sorted, sv);
+    }
+  }
+  // a given allocator allocates the buffer once
+  int count = 0;
+  std::vector<int> v = sort_patterns(10000)[0];
+  stl::stable_sort(v.begin(), v.end(), std::less<int>(),
+                   counting_allocator<int>(&count));
+  EXPECT_EQ(1, count);
+  EXPECT_EQ(true, std::is_sorted(v.begin(), v.end()));
+
+  // comparisons grow with the number of runs: a sorted input with an
+  // unsorted tail is linear
+  std::vector<int> log(1000000);
+  for (int i = 0; i < 1000000; ++i) log[i] = i;
+  std::mt19937 gen(5);
+  for (int i = 999000; i < 1000000; ++i) log[i] = gen() % 1000000;
+  long long comparisons = 0;
+  stl::stable_sort(log.begin(), log.end(), [&comparisons](int a, int b) {
+    ++comparisons;
+    return a < b;
+  });
+  EXPECT_EQ(true, std::is_sorted(log.begin(), log.end()));
+  EXPECT_GT(2000000LL, comparisons);
+
+  // element that is not trivially copyable, deque iterator
+  std::vector<std::string> strings;
+  for (int i = 0; i < 5000; ++i) strings.push_back(std::to_string(gen() % 700));
+  std::vector<std::string> sorted_strings = strings;
+  std::sort(sorted_strings.begin(), sorted_strings.end());
+  stl::stable_sort(strings.begin(), strings.end());
+  EXPECT_EQ(sorted_strings, strings);
+  std::vector<std::string> buffer(100);
+  stl::deque<std::string> d(sorted_strings.rbegin(), sorted_strings.rend());
+  stl::stable_sort(d.begin(), d.end(), std::less<std::string>(),
+                   buffer.data(), buffer.size());
+  EXPECT_EQ(true, std::equal(d.begin(), d.end(), sorted_strings.begin()));
+}
+
+TEST_F(AlgorithmTest, InplaceMerge) {
+  std::mt19937 gen(9);
+  for (int n : {0, 1, 2, 10, 1000, 50000}) {
+    for (int left : {0, 1, n / 3, n / 2, n - 1, n}) {
+      if (left < 0 || left > n) continue;
+      std::vector<int> v(n);
+      for (int &x : v) x = gen() % (n / 4 + 1);
+      std::vector<keyed> kv = keyed_of(v);
+      std::stable_sort(kv.begin(), kv.begin() + left, key_less);
+      std::stable_sort(kv.begin() + left, kv.end(), key_less);
+      std::vector<keyed> expected = kv;
+      std::inplace_merge(expected.begin(), expected.begin() + left,
+                         expected.end(), key_less);
+      stl::inplace_merge(kv.begin(), kv.begin() + left, kv.end(), key_less);
+      EXPECT_EQ(expected, kv);
+
+      // bidirectional iterator
+      std::sort(v.begin(), v.begin() + left);
+      std::sort(v.begin() + left, v.end());
+      stl::list<int> l(v.begin(), v.end());
+      auto middle = l.begin();
+      std::advance(middle, left);
+      stl::inplace_merge(l.begin(), middle, l.end());
+      std::sort(v.begin(), v.end());
+      EXPECT_EQ(true, std::equal(l.begin(), l.end(), v.begin()));
+    }
+  }
+}
+
+// v[nth] is the nth of sorted, nothing before is greater and nothing after
+// is less
+template <class Compare>
+void expect_nth(const std::vector<int> &v, const std::vector<int> &sorted,
+                std::size_t nth, Compare comp) {
+  EXPECT_EQ(sorted[nth], v[nth]);
+  for (std::size_t i = 0; i < nth; ++i) EXPECT_EQ(false, comp(v[nth], v[i]));
+  for (std::size_t i = nth + 1; i < v.size(); ++i)
+    EXPECT_EQ(false, comp(v[i], v[nth]));
+}
+
+TEST_F(AlgorithmTest, NthElement) {
+  for (auto &v : test_data) {
+    std::vector<int> sorted = v;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t nth = 0; nth < v.size(); nth += 1 + v.size() / 10) {
+      std::vector<int> sv = v;
+      stl::nth_element(sv.begin(), sv.begin() + nth, sv.end());
+      expect_nth(sv, sorted, nth, std::less<int>());
+    }
+    std::vector<int> sv = v;
+    stl::nth_element(sv.begin(), sv.end(), sv.end());
+    EXPECT_EQ(v, sv);
+  }
+  for (int n : {1000, 100000}) {
+    for (auto &v : sort_patterns(n)) {
+      std::vector<int> sorted = v;
+      std::sort(sorted.begin(), sorted.end());
+      for (int nth : {0, 1, n / 100, n / 2, n - n / 1000 - 1, n - 1}) {
+        // comparison is linear on every pattern
+        long long count = 0;
+        std::vector<int> sv = v;
+        stl::nth_element(sv.begin(), sv.begin() + nth, sv.end(),
+                         [&count](int a, int b) {
+                           ++count;
+                           return a < b;
+                         });
+        expect_nth(sv, sorted, nth, std::less<int>());
+        EXPECT_GT(8LL * n, count);
+        // branch-free partition and the median of medians
+        sv = v;
+        stl::nth_element(sv.begin(), sv.begin() + nth, sv.end());
+        expect_nth(sv, sorted, nth, std::less<int>());
+        sv = v;
+        std::less<int> comp;
+        stl::__introselect<false>(sv.begin(), sv.begin() + nth, sv.end(),
+                                  comp, 0, true);
+        expect_nth(sv, sorted, nth, std::less<int>());
+      }
+    }
+  }
+  // about 1.5 n comparison for the median of random input
+  std::mt19937 gen(5);
+  std::vector<int> v(1000000);
+  for (int &x : v) x = static_cast<int>(gen());
+  long long count = 0;
+  stl::nth_element(v.begin(), v.begin() + v.size() / 2, v.end(),
+                   [&count](int a, int b) {
+                     ++count;
+                     return a < b;
+                   });
+  EXPECT_GT(2LL * 1000000, count);
+
+  std::vector<std::string> words;
+  for (int i = 0; i < 5000; ++i) words.push_back(std::to_string(gen() % 700));
+  std::vector<std::string> sorted = words;
+  std::sort(sorted.begin(), sorted.end());
+  stl::nth_element(words.begin(), words.begin() + 4000, words.end(),
+                   std::greater<std::string>());
+  EXPECT_EQ(sorted[999], words[4000]);
+}
+
+TEST_F(AlgorithmTest, NthElements) {
+  for (int n : {0, 1, 10, 1000, 100000}) {
+    for (auto &v : sort_patterns(n)) {
+      std::vector<int> sorted = v;
+      std::sort(sorted.begin(), sorted.end());
+      std::vector<int> sv = v;
+      // percentiles, repeated and at both ends
+      std::vector<std::vector<int>::iterator> kth;
+      for (double q : {0.0, 0.5, 0.5, 0.9, 0.99, 0.999})
+        kth.push_back(sv.begin() + static_cast<int>(q * n));
+      if (n > 0) kth.push_back(sv.end() - 1);
+      stl::nth_elements(sv.begin(), sv.end(), kth.begin(), kth.end());
+      for (std::size_t i = 0; i < kth.size(); ++i) {
+        const std::size_t nth = kth[i] - sv.begin();
+        if (nth < sv.size()) expect_nth(sv, sorted, nth, std::less<int>());
+      }
+    }
+  }
+  std::mt19937 gen(6);
+  std::deque<int> d;
+  for (int i = 0; i < 20000; ++i) d.push_back(gen() % 5000);
+  std::vector<int> sorted(d.begin(), d.end());
+  std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+  std::vector<std::deque<int>::iterator> kth;
+  for (int i = 0; i < 20000; i += 1000) kth.push_back(d.begin() + i);
+  stl::nth_elements(d.begin(), d.end(), kth.begin(), kth.end(),
+                    std::greater<int>());
+  std::vector<int> v(d.begin(), d.end());
+  for (int i = 0; i < 20000; i += 1000)
+    expect_nth(v, sorted, i, std::greater<int>());
+}
+
+TEST_F(AlgorithmTest, PartialSort) {
+  for (auto &v : test_data) {
+    std::vector<int> sorted = v;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t k : {std::size_t(0), std::size_t(1), v.size() / 3,
+                          v.size() / 2 + 1, v.size()}) {
+      if (k > v.size()) continue;
+      std::vector<int> sv = v;
+      stl::partial_sort(sv.begin(), sv.begin() + k, sv.end());
+      EXPECT_EQ(true, std::equal(sorted.begin(), sorted.begin() + k,
+                                 sv.begin()));
+      std::sort(sv.begin(), sv.end());
+      EXPECT_EQ(sorted, sv);
+
+      // result shorter and longer than the input
+      std::vector<int> result(k + 3, -1);
+      stl::list<int> l(v.begin(), v.end());
+      auto end = stl::partial_sort_copy(l.begin(), l.end(), result.begin(),
+                                        result.begin() + k);
+      EXPECT_EQ(result.begin() + k, end);
+      EXPECT_EQ(true, std::equal(sorted.begin(), sorted.begin() + k,
+                                 result.begin()));
+      end = stl::partial_sort_copy(v.begin(), v.end(), result.begin(),
+                                   result.end(), std::greater<int>());
+      const std::size_t n = std::min(v.size(), result.size());
+      EXPECT_EQ(result.begin() + n, end);
+      EXPECT_EQ(true, std::equal(sorted.rbegin(), sorted.rbegin() + n,
+                                 result.begin()));
+    }
+  }
+  for (int n : {1000, 100000}) {
+    for (auto &v : sort_patterns(n)) {
+      std::vector<int> sorted = v;
+      std::sort(sorted.begin(), sorted.end());
+      for (int k : {1, 10, 100, n / 3}) {
+        // linear on every pattern, a heap would be n log k on reverse input
+        long long count = 0;
+        std::vector<int> sv = v;
+        stl::partial_sort(sv.begin(), sv.begin() + k, sv.end(),
+                          [&count](int a, int b) {
+                            ++count;
+                            return a < b;
+                          });
+        EXPECT_EQ(true, std::equal(sorted.begin(), sorted.begin() + k,
+                                   sv.begin()));
+        EXPECT_GT(8LL * n + 4LL * k * 17, count);
+        sv = v;
+        stl::partial_sort(sv.begin(), sv.begin() + k, sv.end(),
+                          std::greater<int>());
+        EXPECT_EQ(true, std::equal(sorted.rbegin(), sorted.rbegin() + k,
+                                   sv.begin()));
+      }
+    }
+  }
+  std::vector<std::unique_ptr<int>> up;
+  for (int i = 0; i < 1000; ++i) up.emplace_back(new int((i * 37) % 1000));
+  stl::partial_sort(up.begin(), up.begin() + 10, up.end(),
+                    [](const std::unique_ptr<int> &a,
+                       const std::unique_ptr<int> &b) { return *a < *b; });
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(i, *up[i]);
+}
+
+// every bound of every value in and around sorted container c, checked by
+// std on the sorted vector v of the same element
+template <class Container, class Compare>
+void binary_search_of(const Container &c, const std::vector<int> &v,
+                      Compare comp) {
+  const int lo = v.empty() ? 0 : std::min(v.front(), v.back()) - 2;
+  const int hi = v.empty() ? 0 : std::max(v.front(), v.back()) + 2;
+  for (int value = lo; value <= hi; ++value) {
+    const auto lower = std::lower_bound(v.begin(), v.end(), value, comp);
+    const auto upper = std::upper_bound(v.begin(), v.end(), value, comp);
+    EXPECT_EQ(std::distance(v.begin(), lower),
+              std::distance(c.begin(), stl::lower_bound(c.begin(), c.end(),
+                                                        value, comp)));
+    EXPECT_EQ(std::distance(v.begin(), upper),
+              std::distance(c.begin(), stl::upper_bound(c.begin(), c.end(),
+                                                        value, comp)));
+    auto range = stl::equal_range(c.begin(), c.end(), value, comp);
+    EXPECT_EQ(std::distance(v.begin(), lower),
+              std::distance(c.begin(), range.first));
+    EXPECT_EQ(std::distance(v.begin(), upper),
+              std::distance(c.begin(), range.second));
+    EXPECT_EQ(lower != upper,
+              stl::binary_search(c.begin(), c.end(), value, comp));
+  }
+}
+
+TEST_F(AlgorithmTest, BinarySearch) {
+  for (auto v : test_data) {
+    std::sort(v.begin(), v.end());
+    // branch-free, with and without prefetch of memory
+    binary_search_of(v, v, std::less<int>());
+    stl::deque<int> d(v.begin(), v.end());
+    binary_search_of(d, v, std::less<int>());
+    // forward iterator and a comparison with branch
+    stl::list<int> l(v.begin(), v.end());
+    binary_search_of(l, v, std::less<int>());
+    binary_search_of(v, v, [](int a, int b) { return a < b; });
+    std::vector<int> r(v.rbegin(), v.rend());
+    binary_search_of(r, r, std::greater<int>());
+
+    // default comparison of element and value of different types
+    std::vector<double> dv(v.begin(), v.end());
+    for (int value : {-1, 0, 1, 2, 500, 5000}) {
+      EXPECT_EQ(std::lower_bound(v.begin(), v.end(), value) - v.begin(),
+                stl::lower_bound(dv.begin(), dv.end(), value) - dv.begin());
+      EXPECT_EQ(std::upper_bound(v.begin(), v.end(), value) - v.begin(),
+                stl::upper_bound(dv.begin(), dv.end(), value) - dv.begin());
+      auto range = stl::equal_range(dv.begin(), dv.end(), value + 0.5);
+      EXPECT_EQ(range.first, range.second);
+      EXPECT_EQ(std::binary_search(v.begin(), v.end(), value),
+                stl::binary_search(dv.begin(), dv.end(), value));
+    }
+  }
+  std::vector<std::string> words = {"apple", "banana", "banana", "fig"};
+  EXPECT_EQ(1, stl::lower_bound(words.begin(), words.end(), "banana") -
+                   words.begin());
+  EXPECT_EQ(3, stl::upper_bound(words.begin(), words.end(),
+                                std::string("banana")) -
+                   words.begin());
+  EXPECT_EQ(false, stl::binary_search(words.begin(), words.end(), "cherry"));
+}
+
+// lower bound of every key in sorted container c by lower_bound_batch,
+// checked by std on the sorted vector v of the same element
+template <class Container, class Compare>
+void lower_bound_batch_of(const Container &c, const std::vector<int> &v,
+                          const std::vector<int> &keys, Compare comp) {
+  std::vector<typename Container::const_iterator> bounds(keys.size());
+  EXPECT_EQ(bounds.end(),
+            stl::lower_bound_batch(c.begin(), c.end(), keys.begin(),
+                                   keys.end(), bounds.begin(), comp));
+  for (std::size_t i = 0; i < keys.size(); ++i)
+    EXPECT_EQ(std::lower_bound(v.begin(), v.end(), keys[i], comp) - v.begin(),
+              std::distance(c.begin(), bounds[i]));
+}
+
+TEST_F(AlgorithmTest, LowerBoundBatch) {
+  std::mt19937 gen(7);
+  for (auto v : test_data) {
+    std::sort(v.begin(), v.end());
+    // a group not full, one full group and several
+    for (int count : {0, 1, 15, 16, 17, 100}) {
+      std::vector<int> keys(count);
+      for (int &key : keys) key = int(gen() % (v.size() + 4)) - 2;
+      lower_bound_batch_of(v, v, keys, std::less<int>());
+      stl::list<int> l(v.begin(), v.end());
+      lower_bound_batch_of(l, v, keys, std::less<int>());
+      std::vector<int> r(v.rbegin(), v.rend());
+      lower_bound_batch_of(r, r, keys, std::greater<int>());
+    }
+  }
+  // key read once by an input iterator, of another type than the element
+  std::vector<int> v = {1, 3, 3, 5, 8};
+  std::istringstream in("9 3 0 4.5 8");
+  std::vector<std::vector<int>::iterator> bounds;
+  stl::lower_bound_batch(v.begin(), v.end(), std::istream_iterator<double>(in),
+                         std::istream_iterator<double>(),
+                         std::back_inserter(bounds));
+  ASSERT_EQ(5u, bounds.size());
+  EXPECT_EQ(v.begin() + 5, bounds[0]);
+  EXPECT_EQ(v.begin() + 1, bounds[1]);
+  EXPECT_EQ(v.begin() + 0, bounds[2]);
+  EXPECT_EQ(v.begin() + 3, bounds[3]);
+  EXPECT_EQ(v.begin() + 4, bounds[4]);
+  // a range out of cache and many key, they are sorted first
+  std::vector<int> large(std::size_t(1) << 23);
+  for (std::size_t i = 0; i < large.size(); ++i)
+    large[i] = int(i / 2) - (1 << 21);
+  std::vector<int> keys(large.size() / 32);
+  for (int &key : keys) key = int(gen() % (1 << 23)) - (1 << 22);
+  std::vector<std::vector<int>::iterator> large_bounds(keys.size());
+  stl::lower_bound_batch(large.begin(), large.end(), keys.begin(), keys.end(),
+                         large_bounds.begin());
+  for (std::size_t i = 0; i < keys.size(); ++i)
+    EXPECT_EQ(std::lower_bound(large.begin(), large.end(), keys[i]),
+              large_bounds[i]);
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../concurrent_stack.h"
+#include "gtest/gtest.h"
+
+class ConcurrentStackTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {}
+
+  virtual void TearDown() {}
+
+  stl::concurrent_stack<int> ts;
+};
+
+TEST_F(ConcurrentStackTest, IsEmptyInitialized) {
+  int val = 0;
+  EXPECT_EQ(true, ts.empty());
+  EXPECT_EQ(false, ts.try_pop(val));
+}
+
+TEST_F(ConcurrentStackTest, SingleThread) {
+  for (int i = 0; i < 10; ++i) ts.push(i);
+  int val = 0;
+  for (int i = 9; i >= 0; --i) {
+    EXPECT_EQ(true, ts.try_pop(val));
+    EXPECT_EQ(i, val);
+  }
+  EXPECT_EQ(true, ts.empty());
+}
+
+TEST_F(ConcurrentStackTest, PushRange) {
+  std::vector<int> data{1, 2, 3, 4, 5};
+  ts.push_range(data.begin(), data.end());
+  stl::forward_list<int> fl{10, 11, 12};
+  ts.push_range(fl);
+  EXPECT_EQ(true, fl.empty());
+  int val = 0;
+  for (int expect : {10, 11, 12, 5, 4, 3, 2, 1}) {
+    EXPECT_EQ(true, ts.try_pop(val));
+    EXPECT_EQ(expect, val);
+  }
+  EXPECT_EQ(false, ts.try_pop(val));
+}
+
+TEST_F(ConcurrentStackTest, OwnsValueOnDestruction) {
+  stl::concurrent_stack<std::vector<int>> tv;
+  tv.emplace(100, 1);
+  tv.push(std::vector<int>(10, 2));
+  std::vector<int> val;
+  EXPECT_EQ(true, tv.try_pop(val));
+  EXPECT_EQ(10, val.size());
+}
+
+TEST_F(ConcurrentStackTest, MultiThread) {
+  const int thread_num = 8;
+  const int per_thread = 20000;
+  std::atomic<long long> pop_sum(0);
+  std::atomic<int> pop_count(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&, t] {
+      int val = 0;
+      for (int i = 0; i < per_thread; ++i) {
+        if (i % 16 == 0) {
+          int batch[4] = {1, 1, 1, 1};
+          ts.push_range(batch, batch + 4);
+        } else
+          ts.push(1);
+        if (ts.try_pop(val)) {
+          pop_sum += val;
+          ++pop_count;
+        }
+      }
+    });
+  }
+  for (auto &th : threads) th.join();
+  int val = 0;
+  for (; ts.try_pop(val); ++pop_count) pop_sum += val;
+  const int pushed = thread_num * (per_thread + (per_thread + 15) / 16 * 3);
+  EXPECT_EQ(pushed, pop_count.load());
+  EXPECT_EQ(pushed, pop_sum.load());
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,642 @@
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "../algorithm.h"
+#include "../deque.h"
+#include "gtest/gtest.h"
+
+template <typename C1, typename C2>
+void test_range(const C1 &c1, const C2 &c2) {
+  EXPECT_EQ(c1.size(), c2.size());
+  for (std::size_t i = 0; i < c1.size(); ++i) EXPECT_EQ(c1[i], c2[i]);
+}
+
+// relocatable but not trivially copyable, moved by memmove in deque
+struct Owner {
+  Owner(int v) : p(new int(v)) {}
+  std::unique_ptr<int> p;
+};
+
+// copy throws for negative value
+struct Thrower {
+  Thrower(int v) : v(v) {}
+  Thrower(const Thrower &x) : v(x.v) {
+    if (v < 0) throw std::runtime_error("negative");
+  }
+  Thrower &operator=(const Thrower &) = default;
+  int v;
+};
+
+namespace stl {
+template <>
+struct is_trivially_relocatable<Owner> : true_type {};
+template <>
+struct is_trivially_relocatable<Thrower> : true_type {};
+}  // namespace stl
+
+// count block allocation of deque
+static int allocate_count = 0;
+
+template <class T>
+struct CountAllocator : std::allocator<T> {
+  template <class U>
+  struct rebind {
+    typedef CountAllocator<U> other;
+  };
+
+  CountAllocator() = default;
+
+  template <class U>
+  CountAllocator(const CountAllocator<U> &) {}
+
+  T *allocate(std::size_t n) {
+    ++allocate_count;
+    return std::allocator<T>::allocate(n);
+  }
+};
+
+// count global operator new while new_counting is set
+static bool new_counting = false;
+static int new_count = 0;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void *operator new(std::size_t n) {
+  if (new_counting) ++new_count;
+  if (void *p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
+
+class DequeTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    test_data.resize(10);
+    std::iota(test_data.begin(), test_data.end(), 0);
+  }
+
+  virtual void TearDown() {}
+
+  stl::deque<int> td;
+  std::deque<int> sd;
+  std::vector<int> test_data;
+};
+
+TEST_F(DequeTest, IsEmptyInitialized) {
+  EXPECT_EQ(0, td.size());
+  EXPECT_EQ(true, td.empty());
+  EXPECT_EQ(td.begin(), td.end());
+  EXPECT_EQ(0, td.end() - td.begin());
+}
+
+TEST_F(DequeTest, Construction) {
+  stl::deque<int> td1(5000, 7);
+  std::deque<int> sd1(5000, 7);
+  test_range(sd1, td1);
+
+  stl::deque<int> td2(test_data.begin(), test_data.end());
+  test_range(test_data, td2);
+
+  std::istringstream is("1 2 3 4 5");
+  stl::deque<int> td3((std::istream_iterator<int>(is)),
+                      std::istream_iterator<int>());
+  test_range(std::vector<int>{1, 2, 3, 4, 5}, td3);
+
+  stl::deque<int> td4(td1);
+  test_range(sd1, td4);
+
+  stl::deque<int> td5(std::move(td4));
+  test_range(sd1, td5);
+  EXPECT_EQ(true, td4.empty());
+
+  stl::deque<std::string> td6(3000);
+  EXPECT_EQ(3000, td6.size());
+  EXPECT_EQ("", td6[2999]);
+}
+
+TEST_F(DequeTest, AssignmentOperation) {
+  sd = {1, 2, 3, 4, 5};
+  td = {1, 2, 3, 4, 5};
+  test_range(sd, td);
+
+  auto td2 = td;
+  test_range(sd, td2);
+
+  auto td3 = std::move(td);
+  test_range(sd, td3);
+  EXPECT_EQ(0, td.size());
+
+  td = td3;
+  test_range(sd, td);
+  td3 = std::move(td2);
+  test_range(sd, td3);
+
+  sd.assign(10000, 1);
+  td.assign(10000, 1);
+  test_range(sd, td);
+
+  sd.assign(test_data.begin(), test_data.end());
+  td.assign(test_data.begin(), test_data.end());
+  test_range(sd, td);
+
+  td.assign({1, 2, 3, 4, 5});
+  sd.assign({1, 2, 3, 4, 5});
+  test_range(sd, td);
+}
+
+TEST_F(DequeTest, AccessOperation) {
+  for (int i = 0; i < 3000; ++i) {
+    sd.push_back(i);
+    td.push_back(i);
+    sd.push_front(-i);
+    td.push_front(-i);
+  }
+  EXPECT_EQ(sd.back(), td.back());
+  EXPECT_EQ(sd.front(), td.front());
+  for (std::size_t i = 0; i < sd.size(); ++i) {
+    EXPECT_EQ(sd[i], td[i]);
+    EXPECT_EQ(sd.at(i), td.at(i));
+  }
+  EXPECT_THROW(td.at(td.size()), std::out_of_range);
+
+  const stl::deque<int> &ctd = td;
+  EXPECT_EQ(sd.size(), ctd.end() - ctd.begin());
+  EXPECT_EQ(true, std::equal(sd.rbegin(), sd.rend(), ctd.rbegin()));
+  for (int step : {1, 7, 511, 1023, 1024, 1025, 4000}) {
+    for (std::size_t i = 0; i + step < sd.size(); i += 997) {
+      auto iter = td.begin() + i;
+      EXPECT_EQ(sd[i + step], *(iter + step));
+      EXPECT_EQ(sd[i], *(iter + step - step));
+      EXPECT_EQ(step, (iter + step) - iter);
+      EXPECT_EQ(true, iter < iter + step);
+    }
+  }
+}
+
+TEST_F(DequeTest, CapacityOperation) {
+  td.resize(10000);
+  sd.resize(10000);
+  test_range(sd, td);
+  td.resize(10, 1);
+  sd.resize(10, 1);
+  test_range(sd, td);
+  td.resize(3000, 2);
+  sd.resize(3000, 2);
+  test_range(sd, td);
+  td.erase(td.begin(), td.begin() + 2500);
+  sd.erase(sd.begin(), sd.begin() + 2500);
+  td.shrink_to_fit();
+  test_range(sd, td);
+  td.clear();
+  td.shrink_to_fit();
+  EXPECT_EQ(true, td.empty());
+  td.push_back(1);
+  EXPECT_EQ(1, td.front());
+}
+
+TEST_F(DequeTest, InsertOperation) {
+  td = {0, 0, 0, 0, 0};
+  sd = {0, 0, 0, 0, 0};
+
+  auto iter_td = td.insert(td.begin() + 3, {1, 2, 3, 4, 5});
+  auto iter_sd = sd.insert(sd.begin() + 3, {1, 2, 3, 4, 5});
+  EXPECT_EQ(*iter_sd, *iter_td);
+  test_range(sd, td);
+
+  iter_td = td.insert(td.begin() + 1, 2000, 9);
+  iter_sd = sd.insert(sd.begin() + 1, 2000, 9);
+  EXPECT_EQ(iter_sd - sd.begin(), iter_td - td.begin());
+  test_range(sd, td);
+
+  iter_td = td.insert(td.end() - 1, test_data.begin(), test_data.end());
+  iter_sd = sd.insert(sd.end() - 1, test_data.begin(), test_data.end());
+  EXPECT_EQ(iter_sd - sd.begin(), iter_td - td.begin());
+  test_range(sd, td);
+
+  std::istringstream is("1 2 3 4 5");
+  td.insert(td.begin() + 2, std::istream_iterator<int>(is),
+            std::istream_iterator<int>());
+  sd.insert(sd.begin() + 2, {1, 2, 3, 4, 5});
+  test_range(sd, td);
+
+  // value refers to element of itself
+  td.insert(td.begin() + 3, 3000, td[5]);
+  sd.insert(sd.begin() + 3, 3000, sd[5]);
+  test_range(sd, td);
+  td.insert(td.end() - 3, td.back());
+  sd.insert(sd.end() - 3, sd.back());
+  test_range(sd, td);
+
+  stl::deque<std::string> tsd;
+  std::deque<std::string> ssd;
+  for (int i = 0; i < 300; ++i) {
+    int pos = (i * 7) % (tsd.size() + 1);
+    tsd.emplace(tsd.begin() + pos, 20, 'a' + i % 26);
+    ssd.emplace(ssd.begin() + pos, 20, 'a' + i % 26);
+  }
+  test_range(ssd, tsd);
+}
+
+TEST_F(DequeTest, RangeOperation) {
+  // more than a block at both end, from pointer (memcpy) and other range
+  std::vector<int> data(5000);
+  std::iota(data.begin(), data.end(), 0);
+  std::list<int> ls(data.begin(), data.begin() + 3000);
+  for (int round = 0; round < 3; ++round) {
+    td.append_range(data);
+    sd.insert(sd.end(), data.begin(), data.end());
+    td.prepend_range(ls);
+    sd.insert(sd.begin(), ls.begin(), ls.end());
+    td.prepend_range(std::vector<int>(data.begin() + 7, data.begin() + 9));
+    sd.insert(sd.begin(), data.begin() + 7, data.begin() + 9);
+    td.append_range(std::vector<int>());
+    test_range(sd, td);
+  }
+  std::istringstream is("1 2 3 4 5");
+  td.prepend_range(std::vector<int>(std::istream_iterator<int>(is),
+                                    std::istream_iterator<int>()));
+  sd.insert(sd.begin(), {1, 2, 3, 4, 5});
+  test_range(sd, td);
+
+  stl::deque<std::string> tsd;
+  std::vector<std::string> sv(700, std::string(20, 'a'));
+  tsd.append_range(sv);
+  tsd.prepend_range(sv);
+  EXPECT_EQ(1400, std::count(tsd.begin(), tsd.end(), sv[0]));
+
+  // deque is unchanged if a constructor throws
+  stl::deque<Thrower, std::allocator<Thrower>, stl::deque_block_elements<5>>
+      tt;
+  for (int i = 0; i < 10; ++i) tt.push_back(i);
+  std::list<Thrower> bad_list;
+  for (int i = 0; i < 12; ++i) bad_list.emplace_back(i == 9 ? -1 : i);
+  EXPECT_THROW(tt.append_range(bad_list), std::runtime_error);
+  EXPECT_THROW(tt.prepend_range(bad_list), std::runtime_error);
+  EXPECT_EQ(10, tt.size());
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(i, tt[i].v);
+}
+
+TEST_F(DequeTest, EraseOperation) {
+  td.assign(5000, 0);
+  sd.assign(5000, 0);
+  std::iota(td.begin(), td.end(), 0);
+  std::iota(sd.begin(), sd.end(), 0);
+
+  td.pop_back();
+  sd.pop_back();
+  td.pop_front();
+  sd.pop_front();
+  test_range(sd, td);
+
+  auto iter_td = td.erase(td.begin() + 10);
+  auto iter_sd = sd.erase(sd.begin() + 10);
+  EXPECT_EQ(*iter_sd, *iter_td);
+  iter_td = td.erase(td.end() - 10);
+  iter_sd = sd.erase(sd.end() - 10);
+  EXPECT_EQ(*iter_sd, *iter_td);
+  test_range(sd, td);
+
+  iter_td = td.erase(td.begin() + 100, td.begin() + 2100);
+  iter_sd = sd.erase(sd.begin() + 100, sd.begin() + 2100);
+  EXPECT_EQ(*iter_sd, *iter_td);
+  iter_td = td.erase(td.end() - 1100, td.end() - 100);
+  iter_sd = sd.erase(sd.end() - 1100, sd.end() - 100);
+  EXPECT_EQ(*iter_sd, *iter_td);
+  test_range(sd, td);
+
+  td.erase(td.begin(), td.end());
+  EXPECT_EQ(true, td.empty());
+}
+
+// random operation on td, checked by std::deque
+template <class D>
+void random_operation(D &td) {
+  std::deque<int> sd;
+  std::mt19937 gen(42);
+  for (int i = 0; i < 20000; ++i) {
+    int op = gen() % 8;
+    int val = gen() % 1000;
+    switch (op) {
+      case 0:
+      case 1:
+        td.push_back(val);
+        sd.push_back(val);
+        break;
+      case 2:
+      case 3:
+        td.push_front(val);
+        sd.push_front(val);
+        break;
+      case 4:
+        if (!sd.empty()) {
+          td.pop_back();
+          sd.pop_back();
+        }
+        break;
+      case 5:
+        if (!sd.empty()) {
+          td.pop_front();
+          sd.pop_front();
+        }
+        break;
+      case 6: {
+        int pos = gen() % (sd.size() + 1);
+        // sometimes insert more than a block
+        int n = val % 5 + (val % 97 == 0 ? 1500 : 0);
+        td.insert(td.begin() + pos, n, val);
+        sd.insert(sd.begin() + pos, n, val);
+        break;
+      }
+      default:
+        if (!sd.empty()) {
+          int pos = gen() % sd.size();
+          int n = std::min<int>(gen() % 5, sd.size() - pos);
+          td.erase(td.begin() + pos, td.begin() + pos + n);
+          sd.erase(sd.begin() + pos, sd.begin() + pos + n);
+        }
+    }
+  }
+  test_range(sd, td);
+}
+
+TEST_F(DequeTest, RelocatableElement) {
+  stl::deque<Owner> to;
+  std::deque<int> sd1;
+  std::mt19937 gen(7);
+  for (int i = 0; i < 3000; ++i) {
+    int pos = gen() % (sd1.size() + 1);
+    if (i % 5 == 4) {
+      int n = std::min<int>(gen() % 300, sd1.size() - pos);
+      to.erase(to.begin() + pos, to.begin() + pos + n);
+      sd1.erase(sd1.begin() + pos, sd1.begin() + pos + n);
+    } else {
+      to.emplace(to.begin() + pos, i);
+      sd1.insert(sd1.begin() + pos, i);
+    }
+  }
+  EXPECT_EQ(sd1.size(), to.size());
+  for (std::size_t i = 0; i < sd1.size(); ++i) EXPECT_EQ(sd1[i], *to[i].p);
+
+  // relocated element is moved back if constructor throws
+  stl::deque<Thrower, std::allocator<Thrower>, stl::deque_block_elements<5>>
+      tt;
+  for (int i = 0; i < 100; ++i) tt.push_back(i);
+  Thrower data[] = {1000, 1001, -1, 1003};
+  for (int pos : {0, 3, 20, 50, 80, 97, 100}) {
+    EXPECT_THROW(tt.insert(tt.begin() + pos, data, data + 4),
+                 std::runtime_error);
+    EXPECT_EQ(100, tt.size());
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(i, tt[i].v);
+  }
+}
+
+TEST_F(DequeTest, RandomOperation) { random_operation(td); }
+
+TEST_F(DequeTest, BlockPolicy) {
+  stl::deque<int, std::allocator<int>, stl::deque_block_elements<1>> td1;
+  random_operation(td1);
+  stl::deque<int, std::allocator<int>, stl::deque_block_elements<2>> td2;
+  random_operation(td2);
+  stl::deque<int, std::allocator<int>, stl::deque_block_elements<3>> td3;
+  random_operation(td3);
+  stl::deque<int, std::allocator<int>, stl::deque_block_bytes<64>> td4;
+  random_operation(td4);
+
+  stl::deque<char, std::allocator<char>, stl::deque_huge_page_block> td5(
+      5000, 'a');
+  td5.push_front('b');
+  EXPECT_EQ('b', td5.front());
+  EXPECT_EQ(5001, td5.end() - td5.begin());
+
+  struct Message {
+    char data[300];
+  };
+  EXPECT_EQ(64, stl::deque_default_block::block_size<Message>::value);
+  EXPECT_EQ(512, stl::deque_default_block::block_size<long>::value);
+  EXPECT_EQ(16, stl::deque_block_bytes<1024>::block_size<Message>::value);
+
+  // rounded to power of two, except deque_block_elements
+  struct Point {
+    int x, y, z;
+  };
+  EXPECT_EQ(256, stl::deque_default_block::block_size<Point>::value);
+  EXPECT_EQ(128, stl::deque_block_bytes<2000>::block_size<Point>::value);
+  EXPECT_EQ(4, (stl::deque_block_bytes<64, 3>::block_size<Message>::value));
+  EXPECT_EQ(3, stl::deque_block_elements<3>::block_size<Point>::value);
+  stl::deque<Point> td6(1000);
+  for (int i = 0; i < 1000; ++i) td6[i].x = i;
+  for (int i = 0; i < 1000; i += 37)
+    for (int j = 0; j < 1000; j += 91)
+      EXPECT_EQ(j, (td6.begin() + i)[j - i].x);
+}
+
+TEST_F(DequeTest, BlockRecycle) {
+  stl::deque<int, CountAllocator<int>> queue;
+  for (int i = 0; i < 10000; ++i) queue.push_back(i);
+  // a FIFO queue moves across many block boundaries
+  allocate_count = 0;
+  for (int i = 0; i < 100000; ++i) {
+    queue.push_back(i);
+    queue.pop_front();
+  }
+  EXPECT_EQ(10000, queue.size());
+  EXPECT_GE(1, allocate_count);
+
+  // oscillate around a block boundary at both end
+  queue.clear();
+  allocate_count = 0;
+  for (int i = 0; i < 100000; ++i) {
+    queue.push_front(i);
+    queue.push_back(i);
+    queue.pop_front();
+    queue.pop_back();
+  }
+  EXPECT_EQ(0, allocate_count);
+}
+
+TEST_F(DequeTest, PoolAllocator) {
+  stl::deque<int, stl::deque_pool_allocator<int>> tp;
+  random_operation(tp);
+  stl::deque<int, stl::deque_pool_allocator<int>> tp1(tp);
+  EXPECT_EQ(true, tp == tp1);
+  // block too small for a free link and large element
+  stl::deque<char, stl::deque_pool_allocator<char, stl::deque_block_elements<2>>,
+             stl::deque_block_elements<2>>
+      tc(1000, 'a');
+  EXPECT_EQ(1000, std::count(tc.begin(), tc.end(), 'a'));
+  stl::deque<std::string, stl::deque_pool_allocator<std::string>> ts(
+      1000, std::string(20, 'b'));
+  EXPECT_EQ(1000, ts.size());
+
+  // warm pool, short-lived deque then takes block and map from the pool
+  auto short_lived = [] {
+    for (int round = 0; round < 100; ++round) {
+      stl::deque<int, stl::deque_pool_allocator<int>> tq;
+      for (int i = 0; i < 5000; ++i) {
+        tq.push_back(i);
+        if (i % 3 == 0) tq.push_front(i);
+        if (i % 5 == 0) tq.pop_front();
+      }
+    }
+  };
+  short_lived();
+  new_count = 0;
+  new_counting = true;
+  short_lived();
+  new_counting = false;
+  EXPECT_EQ(0, new_count);
+
+  // block allocated by one thread and freed by another
+  for (int round = 0; round < 10; ++round) {
+    stl::deque<int, stl::deque_pool_allocator<int>> tq;
+    std::thread producer([&tq] {
+      for (int i = 0; i < 100000; ++i) tq.push_back(i);
+    });
+    producer.join();
+    std::thread consumer([&tq] {
+      stl::deque<int, stl::deque_pool_allocator<int>> tq1(std::move(tq));
+      tq1.shrink_to_fit();
+    });
+    consumer.join();
+  }
+  short_lived();
+}
+
+// pooled deque outliving the thread cache of the pool, it is destroyed
+// after the cache of its thread
+stl::deque<int, stl::deque_pool_allocator<int>> global_pooled;
+
+TEST_F(DequeTest, PoolAllocatorOutlivesCache) {
+  for (int i = 0; i < 100000; ++i) global_pooled.push_back(i);
+  std::thread worker([] {
+    // constructed before the cache, which is made by the first push
+    static thread_local stl::deque<int, stl::deque_pool_allocator<int>>
+        local_pooled;
+    for (int i = 0; i < 100000; ++i) local_pooled.push_front(i);
+    EXPECT_EQ(100000, local_pooled.size());
+  });
+  worker.join();
+  EXPECT_EQ(100000, global_pooled.size());
+}
+
+TEST_F(DequeTest, Trim) {
+  // pop keeps 2 spare block at each end, trim gives them back
+  stl::deque<int, CountAllocator<int>> queue;
+  for (int i = 0; i < 100000; ++i) queue.push_back(i);
+  for (int i = 0; i < 50000; ++i) queue.pop_front();
+  for (int i = 0; i < 49990; ++i) queue.pop_back();
+  queue.trim(1024 * 1024);
+  allocate_count = 0;
+  for (int i = 0; i < 2048; ++i) queue.push_back(i);
+  EXPECT_EQ(0, allocate_count);
+  queue.resize(10);
+  queue.trim();
+  EXPECT_EQ(10, queue.size());
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(50000 + i, queue[i]);
+  allocate_count = 0;
+  for (int i = 0; i < 2048; ++i) queue.push_front(i);
+  for (int i = 0; i < 2048; ++i) queue.push_back(i);
+  EXPECT_LE(2, allocate_count);
+  EXPECT_EQ(2047, queue.front());
+  EXPECT_EQ(2047, queue.back());
+
+  // large block stays in map after its pages are dropped
+  stl::deque<int, CountAllocator<int>, stl::deque_block_bytes<1 << 18>> large;
+  for (int i = 0; i < 1000000; ++i) large.push_back(i);
+  for (int i = 0; i < 999000; ++i) large.pop_back();
+  large.trim();
+  EXPECT_EQ(1000, large.size());
+  for (int i = 0; i < 1000; ++i) EXPECT_EQ(i, large[i]);
+  allocate_count = 0;
+  for (int i = 0; i < 100000; ++i) large.push_back(i);
+  EXPECT_EQ(0, allocate_count);
+  EXPECT_EQ(99999, large.back());
+
+  stl::deque<int> empty;
+  empty.trim();
+  EXPECT_EQ(true, empty.empty());
+}
+
+// segmented algorithm over every sub range of td, checked by std algorithm
+template <class D>
+void segmented_algorithm(D &td) {
+  const int n = td.size();
+  std::vector<int> sv(n);
+  for (int first = 0; first < n; first += 37) {
+    for (int last = first; last <= n; last += 29) {
+      auto tf = td.begin() + first, tl = td.begin() + last;
+      auto cf = td.cbegin() + first, cl = td.cbegin() + last;
+      EXPECT_EQ(std::count(tf, tl, 3), stl::count(cf, cl, 3));
+      EXPECT_EQ(std::find(tf, tl, first + 3) - tf,
+                stl::find(tf, tl, first + 3) - tf);
+      EXPECT_EQ(tl, stl::find(tf, tl, 100000));
+      int sum = 0;
+      stl::for_each(cf, cl, [&sum](int v) { sum += v; });
+      EXPECT_EQ(std::accumulate(tf, tl, 0), sum);
+      EXPECT_EQ(sv.begin() + (last - first), stl::copy(cf, cl, sv.begin()));
+      EXPECT_EQ(true, std::equal(tf, tl, sv.begin()));
+    }
+  }
+  // copy between deque, each side has different offset in block
+  std::vector<int> data(n);
+  std::iota(data.begin(), data.end(), 1000);
+  D td2(n + 10, 0);
+  for (int offset : {0, 1, 2, 5, 10}) {
+    auto iter = stl::copy(data.begin(), data.end() - 10, td2.begin() + offset);
+    EXPECT_EQ(n - 10 + offset, iter - td2.begin());
+    EXPECT_EQ(true, std::equal(data.begin(), data.end() - 10, td2.begin() + offset));
+    iter = stl::copy(td.begin() + 3, td.end(), td2.begin() + offset);
+    EXPECT_EQ(n - 3 + offset, iter - td2.begin());
+    EXPECT_EQ(true, std::equal(td.begin() + 3, td.end(), td2.begin() + offset));
+  }
+  stl::fill(td2.begin() + 1, td2.end() - 1, 7);
+  EXPECT_EQ(n + 8, std::count(td2.begin(), td2.end(), 7));
+  stl::fill(td2.begin(), td2.end(), 7);
+  EXPECT_EQ(n + 10, stl::count(td2.begin(), td2.end(), 7));
+}
+
+TEST_F(DequeTest, SegmentedAlgorithm) {
+  for (int i = 0; i < 3000; ++i) td.push_back(i);
+  for (int i = 0; i < 500; ++i) td.push_front(-i);
+  segmented_algorithm(td);
+  stl::deque<int, std::allocator<int>, stl::deque_block_elements<3>> td1;
+  for (int i = 0; i < 100; ++i) td1.push_front(i % 10);
+  segmented_algorithm(td1);
+
+  // element is not trivially copyable
+  stl::deque<std::string> tsd(1000, "a");
+  std::vector<std::string> ssd(1000, "b");
+  stl::copy(ssd.begin(), ssd.begin() + 500, tsd.begin() + 300);
+  EXPECT_EQ(500, stl::count(tsd.cbegin(), tsd.cend(), "b"));
+  EXPECT_EQ(tsd.begin() + 300, stl::find(tsd.begin(), tsd.end(), "b"));
+  stl::copy(tsd.begin(), tsd.end(), ssd.begin());
+  EXPECT_EQ(true, std::equal(ssd.begin(), ssd.end(), tsd.begin()));
+}
+
+TEST_F(DequeTest, Comparison) {
+  stl::deque<int> td1 = {1, 2, 3};
+  stl::deque<int> td2 = {1, 2, 4};
+  EXPECT_EQ(true, td1 == td1);
+  EXPECT_EQ(true, td1 != td2);
+  EXPECT_EQ(true, td1 < td2);
+  EXPECT_EQ(true, td2 > td1);
+  EXPECT_EQ(true, td1 <= td2);
+  EXPECT_EQ(true, td2 >= td1);
+  swap(td1, td2);
+  EXPECT_EQ(4, td1.back());
+  EXPECT_EQ(3, td2.back());
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
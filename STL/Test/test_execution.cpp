@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../execution.h"
+#include "../vector.h"
+#include "gtest/gtest.h"
+
+class ExecutionTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    std::mt19937 gen(42);
+    for (int n : {0, 1, 1000, 4097, 100000, 300001}) {
+      stl::vector<int> v(n);
+      for (int &x : v) x = gen() % (n / 2 + 1);
+      test_data.push_back(v);
+    }
+  }
+
+  virtual void TearDown() {}
+
+  std::vector<stl::vector<int>> test_data;
+};
+
+// every algorithm runs with seq, par, par_unseq and a small grain
+template <class Test>
+void for_policies(Test test) {
+  test(stl::execution::seq);
+  test(stl::execution::par);
+  test(stl::execution::par_unseq);
+  test(stl::execution::par.with_grain(100));
+}
+
+TEST_F(ExecutionTest, ForEachTransformCopyFill) {
+  for (auto &v : test_data) {
+    for_policies([&](auto policy) {
+      stl::vector<int> w = v;
+      stl::for_each(policy, w.begin(), w.end(), [](int &x) { x *= 2; });
+      for (std::size_t i = 0; i < v.size(); ++i) EXPECT_EQ(v[i] * 2, w[i]);
+
+      stl::vector<long> t(v.size());
+      EXPECT_EQ(t.end(), stl::transform(policy, v.begin(), v.end(), t.begin(),
+                                        [](int x) { return x + 1L; }));
+      EXPECT_EQ(t.end(),
+                stl::transform(policy, v.begin(), v.end(), w.begin(),
+                               t.begin(), std::minus<long>()));
+      for (std::size_t i = 0; i < v.size(); ++i) EXPECT_EQ(-v[i], t[i]);
+
+      stl::vector<int> c(v.size());
+      EXPECT_EQ(c.end(), stl::copy(policy, v.begin(), v.end(), c.begin()));
+      EXPECT_EQ(true, std::equal(v.begin(), v.end(), c.begin()));
+
+      stl::fill(policy, c.begin(), c.end(), 7);
+      EXPECT_EQ(true, std::all_of(c.begin(), c.end(),
+                                  [](int x) { return x == 7; }));
+    });
+  }
+}
+
+TEST_F(ExecutionTest, FindAndCountIf) {
+  for (auto &v : test_data) {
+    for_policies([&](auto policy) {
+      for (int value : {0, 1, 500, -1}) {
+        EXPECT_EQ(std::find(v.begin(), v.end(), value),
+                  stl::find(policy, v.begin(), v.end(), value));
+      }
+      if (!v.empty()) {
+        // the first of all equal element
+        EXPECT_EQ(std::find(v.begin(), v.end(), v.back()),
+                  stl::find(policy, v.begin(), v.end(), v.back()));
+      }
+      auto odd = [](int x) { return x % 2 != 0; };
+      EXPECT_EQ(std::count_if(v.begin(), v.end(), odd),
+                stl::count_if(policy, v.begin(), v.end(), odd));
+    });
+  }
+}
+
+TEST_F(ExecutionTest, ReduceAndInclusiveScan) {
+  for (auto &v : test_data) {
+    for_policies([&](auto policy) {
+      const long sum = std::accumulate(v.begin(), v.end(), 0L);
+      EXPECT_EQ(sum, stl::reduce(policy, v.begin(), v.end(), 0L));
+      EXPECT_EQ(sum + 5, stl::reduce(policy, v.begin(), v.end(), 5L,
+                                     std::plus<long>()));
+      if (v.size() < 5000) {
+        EXPECT_EQ(static_cast<int>(sum),
+                  stl::reduce(policy, v.begin(), v.end()));
+      }
+
+      std::vector<long> expected(v.begin(), v.end());
+      std::partial_sum(expected.begin(), expected.end(), expected.begin());
+      stl::vector<long> s(v.size());
+      if (v.size() < 5000) {
+        EXPECT_EQ(s.end(),
+                  stl::inclusive_scan(policy, v.begin(), v.end(), s.begin()));
+        EXPECT_EQ(true, std::equal(expected.begin(), expected.end(), s.begin()));
+      }
+      stl::inclusive_scan(policy, v.begin(), v.end(), s.begin(),
+                          std::plus<long>(), 3L);
+      for (std::size_t i = 0; i < v.size(); ++i)
+        EXPECT_EQ(expected[i] + 3, s[i]);
+    });
+  }
+  // op associative but not commutative, string is also not trivial
+  std::vector<std::string> words(20000);
+  for (std::size_t i = 0; i < words.size(); ++i)
+    words[i] = std::string(1, static_cast<char>('a' + i % 26));
+  std::vector<std::string> expected(words.size()), s(words.size());
+  std::partial_sum(words.begin(), words.end(), expected.begin());
+  stl::inclusive_scan(stl::execution::par.with_grain(1000), words.begin(),
+                      words.end(), s.begin());
+  EXPECT_EQ(expected, s);
+}
+
+TEST_F(ExecutionTest, Merge) {
+  for (auto &v : test_data) {
+    for_policies([&](auto policy) {
+      stl::vector<int> a = v, b = v;
+      std::sort(a.begin(), a.begin() + a.size() / 3);
+      std::sort(b.begin() + b.size() / 3, b.end());
+      stl::vector<int> out(v.size()), expected(v.size());
+      std::merge(a.begin(), a.begin() + a.size() / 3, b.begin() + b.size() / 3,
+                 b.end(), expected.begin());
+      EXPECT_EQ(out.end(),
+                stl::merge(policy, a.begin(), a.begin() + a.size() / 3,
+                           b.begin() + b.size() / 3, b.end(), out.begin()));
+      EXPECT_EQ(expected, out);
+    });
+  }
+  // stable, the first range goes first
+  std::vector<std::pair<int, int>> a, b, out(200000), expected(200000);
+  for (int i = 0; i < 100000; ++i) {
+    a.emplace_back(i / 10, 0);
+    b.emplace_back(i / 7, 1);
+  }
+  auto comp = [](const std::pair<int, int> &x, const std::pair<int, int> &y) {
+    return x.first < y.first;
+  };
+  std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin(), comp);
+  stl::merge(stl::execution::par, a.begin(), a.end(), b.begin(), b.end(),
+             out.begin(), comp);
+  EXPECT_EQ(expected, out);
+}
+
+TEST_F(ExecutionTest, SortAndStableSort) {
+  for (auto &v : test_data) {
+    for_policies([&](auto policy) {
+      stl::vector<int> sorted = v;
+      std::sort(sorted.begin(), sorted.end());
+      stl::vector<int> w = v;
+      stl::sort(policy, w.begin(), w.end());
+      EXPECT_EQ(sorted, w);
+      w = v;
+      stl::sort(policy, w.begin(), w.end(), std::greater<int>());
+      EXPECT_EQ(true, std::is_sorted(w.begin(), w.end(), std::greater<int>()));
+      w = v;
+      stl::stable_sort(policy, w.begin(), w.end());
+      EXPECT_EQ(sorted, w);
+    });
+  }
+  // stability and element not trivially copyable
+  std::mt19937 gen(7);
+  std::vector<std::pair<int, std::string>> v(100000);
+  for (std::size_t i = 0; i < v.size(); ++i)
+    v[i] = {static_cast<int>(gen() % 1000), std::to_string(i)};
+  auto comp = [](const std::pair<int, std::string> &x,
+                 const std::pair<int, std::string> &y) {
+    return x.first < y.first;
+  };
+  auto expected = v;
+  std::stable_sort(expected.begin(), expected.end(), comp);
+  for_policies([&](auto policy) {
+    auto w = v;
+    stl::stable_sort(policy, w.begin(), w.end(), comp);
+    EXPECT_EQ(expected, w);
+  });
+  // a moved-from string compares unlike the one it was, every cut of a
+  // merge is searched before the merge moves
+  for (std::size_t n : {100000, 250000}) {
+    std::vector<std::string> words(n);
+    for (auto &word : words) word = std::to_string(gen() % 1000);
+    auto sorted = words;
+    std::sort(sorted.begin(), sorted.end());
+    for_policies([&](auto policy) {
+      auto w = words;
+      stl::sort(policy, w.begin(), w.end());
+      EXPECT_EQ(sorted, w);
+      w = words;
+      stl::stable_sort(policy, w.begin(), w.end());
+      EXPECT_EQ(sorted, w);
+    });
+  }
+}
+
+int main(int argc, char *argv[]) {
+  // run on a few thread even if the machine has one core
+  setenv("STL_NUM_THREADS", "4", 0);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <forward_list>
+#include "../forward_list.h"
+#include "gtest/gtest.h"
+
+template <typename C1, typename C2>
+void test_range(const C1 &c1, const C2 &c2) {
+  EXPECT_EQ(std::distance(c1.begin(), c1.end()),
+            std::distance(c2.begin(), c2.end()));
+  auto iter1 = c1.begin();
+  auto iter2 = c2.begin();
+  for(;iter1 != c1.end() && iter2 != c2.end(); ++iter1, ++iter2)
+    EXPECT_EQ(*iter1, *iter2);
+  EXPECT_EQ(iter1, c1.end());
+  EXPECT_EQ(iter2, c2.end());
+}
+
+class ForwardListTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    test_data.resize(10);
+    std::iota(test_data.begin(), test_data.end(), 0);
+  }
+
+  virtual void TearDown() {}
+
+  stl::forward_list<int> tc;
+  std::forward_list<int> sc;
+  std::forward_list<int> test_data;
+};
+
+TEST_F(ForwardListTest, IsEmptyInitialized) {
+  EXPECT_EQ(true, tc.empty());
+  EXPECT_EQ(tc.begin(), tc.end());
+}
+
+TEST_F(ForwardListTest, NodeLayout) {
+  // one link plus value
+  struct node_like { void *next; long value; };
+  EXPECT_EQ(sizeof(node_like),
+            sizeof(stl::__forward_list_node<long, void *>));
+}
+
+TEST_F(ForwardListTest, Construction) {
+  stl::forward_list<int> tc2(10);
+  std::forward_list<int> sc2(10);
+  test_range(sc2, tc2);
+  stl::forward_list<int> tc3(10, 1);
+  std::forward_list<int> sc3(10, 1);
+  test_range(sc3, tc3);
+  stl::forward_list<int> tc4{1, 2, 3, 4};
+  std::forward_list<int> sc4{1, 2, 3, 4};
+  test_range(sc4, tc4);
+  stl::forward_list<int> tc5(tc4);
+  std::forward_list<int> sc5(sc4);
+  test_range(sc4, tc4);
+  test_range(sc5, tc5);
+  stl::forward_list<int> tc6(::std::move(tc5));
+  std::forward_list<int> sc6(::std::move(sc5));
+  test_range(sc5, tc5);
+  test_range(sc6, tc6);
+  stl::forward_list<int> tc7(test_data.begin(), test_data.end());
+  test_range(test_data, tc7);
+}
+
+TEST_F(ForwardListTest, Assignment) {
+  stl::forward_list<int> tc1{1, 2, 3, 4, 5};
+  stl::forward_list<int> tc2{1, 2, 3};
+  std::forward_list<int> sc1{1, 2, 3, 4, 5};
+  std::forward_list<int> sc2{1, 2, 3};
+  tc1.assign({1});
+  sc1.assign({1});
+  test_range(sc1, tc1);
+  tc1.assign(7, 3);
+  sc1.assign(7, 3);
+  test_range(sc1, tc1);
+  tc1 = tc2;
+  sc1 = sc2;
+  test_range(sc1, tc1);
+  tc1 = {4, 5, 6, 7, 8, 9};
+  sc1 = {4, 5, 6, 7, 8, 9};
+  test_range(sc1, tc1);
+  tc1 = ::std::move(tc2);
+  sc1 = ::std::move(sc2);
+  test_range(sc1, tc1);
+  test_range(sc2, tc2);
+}
+
+TEST_F(ForwardListTest, InsertOperation) {
+  tc.emplace_front(1);
+  sc.emplace_front(1);
+  test_range(sc, tc);
+  for(int i = 0; i < 5; ++i) {
+    tc.push_front(i);
+    sc.push_front(i);
+    test_range(sc, tc);
+  }
+  auto iter_tc = std::next(tc.begin(), 2);
+  auto iter_sc = std::next(sc.begin(), 2);
+  auto iter_tc_r = tc.insert_after(iter_tc, 7);
+  auto iter_sc_r = sc.insert_after(iter_sc, 7);
+  EXPECT_EQ(std::distance(tc.begin(), iter_tc_r),
+            std::distance(sc.begin(), iter_sc_r));
+  test_range(sc, tc);
+  iter_tc_r = tc.emplace_after(iter_tc, 8);
+  iter_sc_r = sc.emplace_after(iter_sc, 8);
+  test_range(sc, tc);
+  iter_tc_r = tc.insert_after(iter_tc, 5, 1);
+  iter_sc_r = sc.insert_after(iter_sc, 5, 1);
+  EXPECT_EQ(std::distance(tc.begin(), iter_tc_r),
+            std::distance(sc.begin(), iter_sc_r));
+  test_range(sc, tc);
+  iter_tc_r = tc.insert_after(tc.before_begin(), {1, 2, 3, 4, 5});
+  iter_sc_r = sc.insert_after(sc.before_begin(), {1, 2, 3, 4, 5});
+  EXPECT_EQ(std::distance(tc.begin(), iter_tc_r),
+            std::distance(sc.begin(), iter_sc_r));
+  test_range(sc, tc);
+  tc.resize(30, 9);
+  sc.resize(30, 9);
+  test_range(sc, tc);
+  tc.resize(4);
+  sc.resize(4);
+  test_range(sc, tc);
+}
+
+TEST_F(ForwardListTest, EraseOperation) {
+  tc = {1, 2, 3, 4, 5, 6, 4};
+  sc = {1, 2, 3, 4, 5, 6, 4};
+  tc.pop_front();
+  sc.pop_front();
+  test_range(sc, tc);
+  auto iter_tc = tc.erase_after(tc.begin());
+  auto iter_sc = sc.erase_after(sc.begin());
+  EXPECT_EQ(*iter_tc, *iter_sc);
+  test_range(sc, tc);
+  tc.remove(4);
+  sc.remove(4);
+  test_range(sc, tc);
+  tc.remove_if([](int i){ return i == 5; });
+  sc.remove_if([](int i){ return i == 5; });
+  test_range(sc, tc);
+  iter_tc = tc.erase_after(tc.before_begin(), tc.end());
+  iter_sc = sc.erase_after(sc.before_begin(), sc.end());
+  EXPECT_EQ(iter_tc, tc.end());
+  test_range(sc, tc);
+  // erase and insert again reuse the cached node
+  for (int i = 0; i < 100; ++i) {
+    tc.push_front(i);
+    tc.pop_front();
+  }
+  EXPECT_EQ(true, tc.empty());
+}
+
+TEST_F(ForwardListTest, SpliceOperation) {
+  stl::forward_list<int> tc1{1, 2, 3};
+  stl::forward_list<int> tc2{4, 5, 6, 7};
+  std::forward_list<int> sc1{1, 2, 3};
+  std::forward_list<int> sc2{4, 5, 6, 7};
+  tc1.splice_after(tc1.begin(), tc2, tc2.begin());
+  sc1.splice_after(sc1.begin(), sc2, sc2.begin());
+  test_range(sc1, tc1);
+  test_range(sc2, tc2);
+  tc1.splice_after(tc1.before_begin(), tc2, tc2.before_begin(),
+                   std::next(tc2.begin()));
+  sc1.splice_after(sc1.before_begin(), sc2, sc2.before_begin(),
+                   std::next(sc2.begin()));
+  test_range(sc1, tc1);
+  test_range(sc2, tc2);
+  tc1.splice_after(tc1.before_begin(), tc2);
+  sc1.splice_after(sc1.before_begin(), sc2);
+  test_range(sc1, tc1);
+  test_range(sc2, tc2);
+}
+
+TEST_F(ForwardListTest, AlgorithmOperation) {
+  tc = {1,2,3,3,4,4,5,6,6,7};
+  sc.assign(tc.begin(), tc.end());
+  tc.unique();
+  sc.unique();
+  test_range(sc, tc);
+  tc = {1,2,3,3,4,4,5,6,6,7};
+  sc.assign(tc.begin(), tc.end());
+  tc.unique([](int l, int r) { return r - l == 1; });
+  sc.unique([](int l, int r) { return r - l == 1; });
+  test_range(sc, tc);
+  stl::forward_list<int> tc1{1,3,6,8,10};
+  std::forward_list<int> sc1 {tc1.begin(), tc1.end()};
+  stl::forward_list<int> tc2{1,2,4,8,9,10,11};
+  std::forward_list<int> sc2(tc2.begin(), tc2.end());
+  tc1.merge(tc2);
+  sc1.merge(sc2);
+  test_range(sc1, tc1);
+  test_range(sc2, tc2);
+  tc1 = {10,5,5,3,2,1};
+  tc2 = {11,8,6,6,3,3,2,1};
+  sc1.assign(tc1.begin(), tc1.end());
+  sc2.assign(tc2.begin(),  tc2.end());
+  tc1.merge(tc2, std::greater<int>());
+  sc1.merge(sc2, std::greater<int>());
+  test_range(sc1, tc1);
+  tc1 = {1,2,4,1,5,4,12,3,5,3,6,7,5};
+  sc1.assign(tc1.begin(), tc1.end());
+  tc1.sort();
+  sc1.sort();
+  test_range(sc1, tc1);
+  tc1.reverse();
+  sc1.reverse();
+  test_range(sc1, tc1);
+  // stable sort on key
+  stl::forward_list<std::pair<int, int>> tp;
+  std::forward_list<std::pair<int, int>> sp;
+  for (int i = 0; i < 200; ++i) {
+    tp.push_front({(i * 37) % 11, i});
+    sp.push_front({(i * 37) % 11, i});
+  }
+  auto by_key = [](const std::pair<int, int> &l, const std::pair<int, int> &r) {
+    return l.first < r.first;
+  };
+  tp.sort(by_key);
+  sp.sort(by_key);
+  test_range(sp, tp);
+}
+
+TEST_F(ForwardListTest, Comparison) {
+  stl::forward_list<int> tc1{1, 2, 3};
+  stl::forward_list<int> tc2{1, 2, 4};
+  EXPECT_TRUE(tc1 == tc1);
+  EXPECT_TRUE(tc1 != tc2);
+  EXPECT_TRUE(tc1 < tc2);
+  EXPECT_TRUE(tc2 >= tc1);
+  swap(tc1, tc2);
+  EXPECT_TRUE(tc2 < tc1);
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
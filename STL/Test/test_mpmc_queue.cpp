@@ -0,0 +1,110 @@
+#include <atomic>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../mpmc_queue.h"
+#include "gtest/gtest.h"
+
+class MpmcQueueTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {}
+
+  virtual void TearDown() {}
+
+  stl::mpmc_queue<int> tq{8};
+};
+
+TEST_F(MpmcQueueTest, IsEmptyInitialized) {
+  int val = 0;
+  EXPECT_EQ(true, tq.empty());
+  EXPECT_EQ(8, tq.capacity());
+  EXPECT_EQ(false, tq.try_pop(val));
+  stl::mpmc_queue<int> tq1(5);
+  EXPECT_EQ(8, tq1.capacity());
+}
+
+TEST_F(MpmcQueueTest, SingleThread) {
+  int val = 0;
+  // go around the ring several times
+  for (int round = 0; round < 5; ++round) {
+    for (int i = 0; i < 8; ++i) EXPECT_EQ(true, tq.try_push(i));
+    EXPECT_EQ(false, tq.try_push(8));
+    EXPECT_EQ(8, tq.size());
+    for (int i = 0; i < 8; ++i) {
+      EXPECT_EQ(true, tq.try_pop(val));
+      EXPECT_EQ(i, val);
+    }
+    EXPECT_EQ(false, tq.try_pop(val));
+  }
+  tq.push(1);
+  tq.pop(val);
+  EXPECT_EQ(1, val);
+}
+
+TEST_F(MpmcQueueTest, Batch) {
+  std::vector<int> data{1, 2, 3, 4, 5, 6};
+  EXPECT_EQ(6, tq.try_push_n(data.begin(), 6));
+  // only 2 cell left
+  EXPECT_EQ(2, tq.try_push_n(data.begin(), 6));
+  EXPECT_EQ(0, tq.try_push_n(data.begin(), 6));
+  std::vector<int> out;
+  EXPECT_EQ(5, tq.try_pop_n(std::back_inserter(out), 5));
+  EXPECT_EQ(3, tq.try_pop_n(std::back_inserter(out), 5));
+  EXPECT_EQ(0, tq.try_pop_n(std::back_inserter(out), 5));
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5, 6, 1, 2}), out);
+}
+
+TEST_F(MpmcQueueTest, OwnsValueOnDestruction) {
+  stl::mpmc_queue<std::string> ts(4);
+  ts.try_emplace(100, 'a');
+  ts.push(std::string(10, 'b'));
+  std::vector<std::string> data(3, "c");
+  EXPECT_EQ(2, ts.try_push_n(data.begin(), 3));
+  std::string val;
+  EXPECT_EQ(true, ts.try_pop(val));
+  EXPECT_EQ(100, val.size());
+}
+
+// every pushed value is popped exactly once
+TEST_F(MpmcQueueTest, MultiThread) {
+  const int thread_num = 4;
+  const int per_thread = 50000;
+  stl::mpmc_queue<int> tq1(64);
+  std::vector<std::atomic<int>> popped(thread_num * per_thread);
+  for (auto &p : popped) p.store(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    // blocking producer and consumer
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < per_thread; ++i) tq1.push(t * per_thread + i);
+    });
+    threads.emplace_back([&] {
+      int val = 0;
+      for (int i = 0; i < per_thread / 2; ++i) {
+        tq1.pop(val);
+        ++popped[val];
+      }
+    });
+    // batch consumer
+    threads.emplace_back([&] {
+      int buf[7];
+      for (int n = 0; n < per_thread / 2;) {
+        int k = tq1.try_pop_n(buf, std::min(7, per_thread / 2 - n));
+        for (int i = 0; i < k; ++i) ++popped[buf[i]];
+        if (k == 0) std::this_thread::yield();
+        n += k;
+      }
+    });
+  }
+  for (auto &th : threads) th.join();
+  int wrong = 0;
+  for (auto &p : popped) wrong += p.load() != 1;
+  EXPECT_EQ(0, wrong);
+  EXPECT_EQ(true, tq1.empty());
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include "../queue.h"
+#include "gtest/gtest.h"
+
+class QueueTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {}
+
+  virtual void TearDown() {}
+
+  stl::queue<int> tq;
+  std::queue<int> sq;
+};
+
+TEST_F(QueueTest, IsEmptyInitialized) {
+  EXPECT_EQ(true, tq.empty());
+  EXPECT_EQ(0, tq.size());
+  stl::priority_queue<int> tp;
+  EXPECT_EQ(true, tp.empty());
+}
+
+TEST_F(QueueTest, PushAndPop) {
+  for (int i = 0; i < 5000; ++i) {
+    tq.push(i);
+    sq.push(i);
+    if (i % 3 == 1) {
+      tq.pop();
+      sq.pop();
+    }
+    EXPECT_EQ(sq.front(), tq.front());
+    EXPECT_EQ(sq.back(), tq.back());
+  }
+  EXPECT_EQ(sq.size(), tq.size());
+  std::vector<int> data{-1, -2, -3};
+  tq.push_range(data);
+  EXPECT_EQ(-3, tq.back());
+  stl::queue<int, std::list<int>> tl;
+  tl.push_range(data);
+  tl.emplace(-4);
+  EXPECT_EQ(-1, tl.front());
+  EXPECT_EQ(-4, tl.back());
+
+  stl::queue<int> tq1(stl::deque<int>{1, 2, 3});
+  stl::queue<int> tq2(stl::deque<int>{1, 2, 4});
+  EXPECT_EQ(true, tq1 < tq2);
+  tq1.pop();
+  tq2.pop();
+  EXPECT_EQ(false, tq1 == tq2);
+}
+
+// checked by std::priority_queue with random push, push_range and pop
+template <class P, class Compare>
+void random_priority_queue(P &tp, Compare comp) {
+  std::priority_queue<int, std::vector<int>, Compare> sp(comp);
+  std::mt19937 gen(42);
+  for (int i = 0; i < 20000; ++i) {
+    int op = gen() % 8;
+    if (op < 4) {
+      int val = gen() % 1000;
+      tp.push(val);
+      sp.push(val);
+    } else if (op < 7) {
+      if (!sp.empty()) {
+        EXPECT_EQ(sp.top(), tp.top());
+        tp.pop();
+        sp.pop();
+      }
+    } else {
+      std::vector<int> data(gen() % (i % 100 == 0 ? 2000 : 10));
+      for (int &x : data) {
+        x = gen() % 1000;
+        sp.push(x);
+      }
+      tp.push_range(data);
+    }
+    EXPECT_EQ(sp.size(), tp.size());
+  }
+  std::vector<int> out;
+  tp.pop_n(tp.size() + 5, std::back_inserter(out));
+  EXPECT_EQ(sp.size(), out.size());
+  for (int x : out) {
+    EXPECT_EQ(sp.top(), x);
+    sp.pop();
+  }
+  EXPECT_EQ(true, tp.empty());
+}
+
+TEST_F(QueueTest, PriorityQueue) {
+  stl::priority_queue<int> tp2;
+  random_priority_queue(tp2, std::less<int>());
+  stl::priority_queue<int, stl::vector<int>, std::greater<int>, 4> tp4;
+  random_priority_queue(tp4, std::greater<int>());
+  stl::priority_queue<int, stl::deque<int>, std::less<int>, 8> tp8;
+  random_priority_queue(tp8, std::less<int>());
+  stl::priority_queue<int, stl::vector<int>, std::less<int>, 3> tp3;
+  random_priority_queue(tp3, std::less<int>());
+}
+
+TEST_F(QueueTest, PriorityQueueConstruction) {
+  std::vector<int> data(1000);
+  std::iota(data.begin(), data.end(), 0);
+  std::shuffle(data.begin(), data.end(), std::mt19937(1));
+  stl::priority_queue<int, stl::vector<int>, std::less<int>, 4> tp(
+      data.begin(), data.end());
+  stl::vector<int> out(10);
+  EXPECT_EQ(out.end(), tp.pop_n(10, out.begin()));
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(999 - i, out[i]);
+  EXPECT_EQ(990, tp.size());
+
+  stl::priority_queue<std::string> ts(std::less<std::string>(),
+                                      stl::vector<std::string>{"b", "c", "a"});
+  ts.emplace(3, 'd');
+  EXPECT_EQ("ddd", ts.top());
+  ts.pop();
+  EXPECT_EQ("c", ts.top());
+  stl::priority_queue<std::string> ts1;
+  swap(ts, ts1);
+  EXPECT_EQ(true, ts.empty());
+  EXPECT_EQ(3, ts1.size());
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../spsc_ring.h"
+#include "gtest/gtest.h"
+
+class SpscRingTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {}
+
+  virtual void TearDown() {}
+
+  stl::spsc_ring<int> tr{8};
+};
+
+TEST_F(SpscRingTest, IsEmptyInitialized) {
+  int val = 0;
+  EXPECT_EQ(true, tr.empty());
+  EXPECT_EQ(8, tr.capacity());
+  EXPECT_EQ(false, tr.try_pop(val));
+  EXPECT_EQ(0, tr.peek(4).size());
+  stl::spsc_ring<int> tr1(5);
+  EXPECT_EQ(8, tr1.capacity());
+}
+
+TEST_F(SpscRingTest, SingleThread) {
+  int val = 0;
+  for (int round = 0; round < 5; ++round) {
+    for (int i = 0; i < 8; ++i) EXPECT_EQ(true, tr.try_push(i));
+    EXPECT_EQ(false, tr.try_push(8));
+    EXPECT_EQ(8, tr.size());
+    for (int i = 0; i < 8; ++i) {
+      EXPECT_EQ(true, tr.try_pop(val));
+      EXPECT_EQ(i, val);
+    }
+    EXPECT_EQ(false, tr.try_pop(val));
+  }
+}
+
+TEST_F(SpscRingTest, ReserveCommit) {
+  int val = 0;
+  // move index to the middle of the ring
+  for (int i = 0; i < 5; ++i) tr.try_push(i);
+  for (int i = 0; i < 5; ++i) tr.try_pop(val);
+
+  auto r = tr.reserve(6);
+  EXPECT_EQ(6, r.size());
+  // wrapped at the end of the ring
+  EXPECT_EQ(3, r.first.size);
+  EXPECT_EQ(3, r.second.size);
+  int next = 10;
+  for (int &x : r.first) x = next++;
+  for (int &x : r.second) x = next++;
+  // nothing is visible before commit
+  EXPECT_EQ(0, tr.size());
+  tr.commit(5);
+  EXPECT_EQ(5, tr.size());
+  // only 3 slot left
+  EXPECT_EQ(3, tr.reserve(6).size());
+
+  auto p = tr.peek(8);
+  EXPECT_EQ(5, p.size());
+  EXPECT_EQ(3, p.first.size);
+  std::vector<int> out(p.first.begin(), p.first.end());
+  out.insert(out.end(), p.second.begin(), p.second.end());
+  EXPECT_EQ((std::vector<int>{10, 11, 12, 13, 14}), out);
+  tr.release(2);
+  EXPECT_EQ(3, tr.size());
+  EXPECT_EQ(true, tr.try_pop(val));
+  EXPECT_EQ(12, val);
+}
+
+TEST_F(SpscRingTest, OwnsValueOnDestruction) {
+  stl::spsc_ring<std::string> ts(4);
+  ts.try_emplace(100, 'a');
+  ts.try_push(std::string(10, 'b'));
+  ts.try_push("c");
+  std::string val;
+  EXPECT_EQ(true, ts.try_pop(val));
+  EXPECT_EQ(100, val.size());
+}
+
+// consumer sees every value in order, both side mix element and batch api
+TEST_F(SpscRingTest, MultiThread) {
+  const int total = 1000000;
+  stl::spsc_ring<int> tr1(256);
+  std::thread producer([&] {
+    int next = 0;
+    while (next < total) {
+      if (next % 3 == 0) {
+        if (!tr1.try_push(next))
+          std::this_thread::yield();
+        else
+          ++next;
+        continue;
+      }
+      auto r = tr1.reserve(std::min(total - next, 100));
+      for (int &x : r.first) x = next++;
+      for (int &x : r.second) x = next++;
+      tr1.commit(r.size());
+      if (r.size() == 0) std::this_thread::yield();
+    }
+  });
+  int expect = 0;
+  bool in_order = true;
+  while (expect < total) {
+    int val = 0;
+    if (expect % 2 == 0 && tr1.try_pop(val)) {
+      in_order &= val == expect++;
+      continue;
+    }
+    auto p = tr1.peek(64);
+    for (int x : p.first) in_order &= x == expect++;
+    for (int x : p.second) in_order &= x == expect++;
+    tr1.release(p.size());
+    if (p.size() == 0) std::this_thread::yield();
+  }
+  producer.join();
+  EXPECT_EQ(true, in_order);
+  EXPECT_EQ(true, tr1.empty());
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,76 @@
+#include <list>
+#include <stack>
+#include <vector>
+#include "../stack.h"
+#include "../vector.h"
+#include "gtest/gtest.h"
+
+class StackTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {}
+
+  virtual void TearDown() {}
+
+  stl::stack<int> ts;
+  std::stack<int> ss;
+};
+
+TEST_F(StackTest, IsEmptyInitialized) {
+  EXPECT_EQ(true, ts.empty());
+  EXPECT_EQ(0, ts.size());
+}
+
+TEST_F(StackTest, PushAndPop) {
+  for (int i = 0; i < 5000; ++i) {
+    ts.push(i);
+    ss.push(i);
+    if (i % 3 == 1) {
+      ts.pop();
+      ss.pop();
+    }
+    EXPECT_EQ(ss.top(), ts.top());
+  }
+  EXPECT_EQ(ss.size(), ts.size());
+  ts.emplace(-1);
+  EXPECT_EQ(-1, ts.top());
+  ts.top() = 7;
+  EXPECT_EQ(7, ts.top());
+}
+
+TEST_F(StackTest, PushRange) {
+  // deque appends by append_range, vector and list insert at end
+  std::vector<int> data{1, 2, 3, 4, 5};
+  ts.push_range(data);
+  stl::stack<int, stl::vector<int>> tv;
+  tv.push_range(data);
+  stl::stack<int, std::list<int>> tl;
+  tl.push_range(data);
+  for (int i = 5; i > 0; --i) {
+    EXPECT_EQ(i, ts.top());
+    EXPECT_EQ(i, tv.top());
+    EXPECT_EQ(i, tl.top());
+    ts.pop();
+    tv.pop();
+    tl.pop();
+  }
+  EXPECT_EQ(true, ts.empty() && tv.empty() && tl.empty());
+}
+
+TEST_F(StackTest, Comparison) {
+  stl::stack<int> ts1(stl::deque<int>{1, 2, 3});
+  stl::stack<int> ts2(stl::deque<int>{1, 2, 4});
+  EXPECT_EQ(true, ts1 < ts2);
+  EXPECT_EQ(true, ts1 != ts2);
+  ts1.pop();
+  ts1.push(4);
+  EXPECT_EQ(true, ts1 == ts2);
+  stl::stack<int> ts3;
+  swap(ts1, ts3);
+  EXPECT_EQ(true, ts1.empty());
+  EXPECT_EQ(4, ts3.top());
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+#include "../static_search_index.h"
+#include "gtest/gtest.h"
+
+// every bound of keys and the value around them, checked by std
+template <class Index, class T>
+void expect_bounds(const Index &index, const std::vector<T> &sorted,
+                   const std::vector<T> &queries) {
+  EXPECT_EQ(sorted.size(), index.size());
+  for (const T &x : queries) {
+    EXPECT_EQ(std::lower_bound(sorted.begin(), sorted.end(), x) -
+                  sorted.begin(),
+              index.lower_bound(x));
+    EXPECT_EQ(std::upper_bound(sorted.begin(), sorted.end(), x) -
+                  sorted.begin(),
+              index.upper_bound(x));
+  }
+}
+
+template <stl::search_layout Layout, class T>
+void search_sizes(std::mt19937 &gen) {
+  // every tree shape up to a few layer, and a large one
+  std::vector<std::size_t> sizes;
+  for (std::size_t n = 0; n <= 600; ++n) sizes.push_back(n);
+  sizes.push_back(16 * 17 * 17 + 5);
+  sizes.push_back(100000);
+  for (std::size_t n : sizes) {
+    std::vector<T> sorted(n);
+    for (T &x : sorted) x = static_cast<T>(gen() % (n + 1) * 2);
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<T> queries;
+    for (std::size_t i = 0; i <= 2 * n + 2; i += 1 + n / 300)
+      queries.push_back(static_cast<T>(i));
+    queries.push_back(std::numeric_limits<T>::lowest());
+    queries.push_back(std::numeric_limits<T>::max());
+    stl::static_search_index<T, Layout> index(sorted.begin(), sorted.end());
+    expect_bounds(index, sorted, queries);
+  }
+}
+
+TEST(StaticSearchIndexTest, IsEmptyInitialized) {
+  stl::static_search_index<int> s;
+  EXPECT_EQ(true, s.empty());
+  EXPECT_EQ(0, s.lower_bound(7));
+  stl::static_search_index<int, stl::search_layout::eytzinger> e;
+  EXPECT_EQ(0, e.upper_bound(7));
+}
+
+TEST(StaticSearchIndexTest, Eytzinger) {
+  std::mt19937 gen(1);
+  search_sizes<stl::search_layout::eytzinger, int>(gen);
+  search_sizes<stl::search_layout::eytzinger, std::uint64_t>(gen);
+  search_sizes<stl::search_layout::eytzinger, double>(gen);
+}
+
+TEST(StaticSearchIndexTest, STree) {
+  std::mt19937 gen(2);
+  search_sizes<stl::search_layout::s_tree, int>(gen);
+  search_sizes<stl::search_layout::s_tree, std::uint64_t>(gen);
+  search_sizes<stl::search_layout::s_tree, double>(gen);
+  search_sizes<stl::search_layout::s_tree, short>(gen);
+}
+
+TEST(StaticSearchIndexTest, LargestKeyAndCopy) {
+  // the largest key is the padding too
+  const int max = std::numeric_limits<int>::max();
+  std::vector<int> sorted = {-5, 0, 0, 3, max, max};
+  for (int i = 0; i < 40; ++i) sorted.insert(sorted.begin() + 3, 1);
+  std::vector<int> queries = {-6, -5, 0, 1, 2, 3, 4, max - 1, max};
+  stl::static_search_index<int> s(sorted.begin(), sorted.end());
+  stl::static_search_index<int, stl::search_layout::eytzinger> e(
+      sorted.begin(), sorted.end());
+  expect_bounds(s, sorted, queries);
+  expect_bounds(e, sorted, queries);
+
+  auto s_copy = s;
+  auto e_copy = e;
+  expect_bounds(s_copy, sorted, queries);
+  expect_bounds(e_copy, sorted, queries);
+  auto s_moved = std::move(s_copy);
+  expect_bounds(s_moved, sorted, queries);
+  EXPECT_EQ(true, s_copy.empty());
+  e_copy = std::move(e);
+  expect_bounds(e_copy, sorted, queries);
+  s_copy = s_moved;
+  expect_bounds(s_copy, sorted, queries);
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
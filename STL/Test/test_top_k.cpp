@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../top_k.h"
+#include "gtest/gtest.h"
+
+class TopKTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    std::mt19937 gen(42);
+    data.resize(100000);
+    for (int &x : data) x = gen() % 50000;
+  }
+
+  virtual void TearDown() {}
+
+  std::vector<int> data;
+};
+
+TEST_F(TopKTest, IsEmptyInitialized) {
+  stl::top_k<int> t(10);
+  EXPECT_EQ(true, t.empty());
+  EXPECT_EQ(0, t.size());
+  EXPECT_EQ(10, t.k());
+  EXPECT_EQ(true, t.sorted().empty());
+}
+
+TEST_F(TopKTest, PushOneByOne) {
+  for (std::size_t k : {0, 1, 7, 100, 5000}) {
+    stl::top_k<int, std::greater<int>> t(k);
+    std::vector<int> pushed;
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      t.push(data[i]);
+      pushed.push_back(data[i]);
+      // the result is right at any time
+      if (i == 3 || i == 1000) {
+        std::vector<int> expected = pushed;
+        std::sort(expected.begin(), expected.end(), std::greater<int>());
+        expected.resize(std::min(k, expected.size()));
+        auto result = t.sorted();
+        EXPECT_EQ(expected.size(), t.size());
+        EXPECT_EQ(true,
+                  std::equal(expected.begin(), expected.end(), result.begin(),
+                             result.end()));
+      }
+    }
+    std::vector<int> expected = data;
+    std::sort(expected.begin(), expected.end(), std::greater<int>());
+    expected.resize(k);
+    auto result = std::move(t).sorted();
+    EXPECT_EQ(true, std::equal(expected.begin(), expected.end(),
+                               result.begin(), result.end()));
+    EXPECT_EQ(true, t.empty());
+  }
+}
+
+TEST_F(TopKTest, PushBatchAndPattern) {
+  // ascending input passes the threshold every time for greater
+  std::vector<int> ascending(100000);
+  for (int i = 0; i < 100000; ++i) ascending[i] = i;
+  for (auto *v : {&data, &ascending}) {
+    stl::top_k<int, std::greater<int>> t(100);
+    t.push(v->begin(), v->begin() + 30000);
+    t.push(v->begin() + 30000, v->end());
+    std::vector<int> expected = *v;
+    std::partial_sort(expected.begin(), expected.begin() + 100, expected.end(),
+                      std::greater<int>());
+    expected.resize(100);
+    auto result = t.sorted();
+    EXPECT_EQ(true, std::equal(expected.begin(), expected.end(),
+                               result.begin(), result.end()));
+  }
+  // not trivially copyable
+  stl::top_k<std::string> s(3);
+  for (const char *w : {"pear", "fig", "apple", "kiwi", "date", "banana"})
+    s.push(std::string(w));
+  auto words = s.sorted();
+  ASSERT_EQ(3, words.size());
+  EXPECT_EQ("apple", words[0]);
+  EXPECT_EQ("banana", words[1]);
+  EXPECT_EQ("date", words[2]);
+}
+
+TEST_F(TopKTest, MergeAcrossThreads) {
+  const int num_threads = 4;
+  const std::size_t part = data.size() / num_threads;
+  std::vector<stl::top_k<int>> parts(num_threads, stl::top_k<int>(100));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i]() {
+      parts[i].push(data.begin() + i * part, data.begin() + (i + 1) * part);
+    });
+  }
+  for (auto &th : threads) th.join();
+  stl::top_k<int> all(100);
+  all.merge(parts[0]);
+  for (int i = 1; i < num_threads; ++i) all.merge(std::move(parts[i]));
+  EXPECT_EQ(true, parts[1].empty());
+  std::vector<int> expected = data;
+  std::sort(expected.begin(), expected.end());
+  expected.resize(100);
+  auto result = all.sorted();
+  EXPECT_EQ(true, std::equal(expected.begin(), expected.end(), result.begin(),
+                             result.end()));
+}
+
+TEST_F(TopKTest, MergeItself) {
+  // every element counted twice
+  std::vector<int> doubled = data;
+  doubled.insert(doubled.end(), data.begin(), data.end());
+  std::sort(doubled.begin(), doubled.end());
+  for (std::size_t k : {1, 10, 100, 1000}) {
+    std::vector<int> expected(doubled.begin(), doubled.begin() + k);
+    stl::top_k<int> t(k);
+    t.push(data.begin(), data.end());
+    t.merge(t);
+    auto result = t.sorted();
+    EXPECT_EQ(true, std::equal(expected.begin(), expected.end(),
+                               result.begin(), result.end()));
+    stl::top_k<int> u(k);
+    u.push(data.begin(), data.end());
+    u.merge(std::move(u));
+    result = u.sorted();
+    EXPECT_EQ(true, std::equal(expected.begin(), expected.end(),
+                               result.begin(), result.end()));
+  }
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
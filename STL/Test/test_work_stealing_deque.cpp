@@ -0,0 +1,114 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../work_stealing_deque.h"
+#include "gtest/gtest.h"
+
+class WorkStealingDequeTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {}
+
+  virtual void TearDown() {}
+
+  stl::work_stealing_deque<int> td;
+};
+
+TEST_F(WorkStealingDequeTest, IsEmptyInitialized) {
+  int val = 0;
+  EXPECT_EQ(true, td.empty());
+  EXPECT_EQ(0, td.size());
+  EXPECT_EQ(false, td.pop(val));
+  EXPECT_EQ(false, td.steal(val));
+}
+
+TEST_F(WorkStealingDequeTest, OwnerAndThief) {
+  for (int i = 0; i < 10; ++i) td.push(i);
+  EXPECT_EQ(10, td.size());
+  int val = 0;
+  // owner pops the newest, thief steals the oldest
+  EXPECT_EQ(true, td.pop(val));
+  EXPECT_EQ(9, val);
+  EXPECT_EQ(true, td.steal(val));
+  EXPECT_EQ(0, val);
+  for (int i = 8; i >= 1; --i) {
+    EXPECT_EQ(true, td.pop(val));
+    EXPECT_EQ(i, val);
+  }
+  EXPECT_EQ(false, td.pop(val));
+  EXPECT_EQ(false, td.steal(val));
+  // val is kept by a failed pop and steal
+  EXPECT_EQ(1, val);
+  EXPECT_EQ(true, td.empty());
+}
+
+TEST_F(WorkStealingDequeTest, Grow) {
+  stl::work_stealing_deque<int> td1(3);
+  EXPECT_EQ(4, td1.capacity());
+  int val = 0;
+  // wrap around the circular array before it grows
+  for (int i = 0; i < 3; ++i) td1.push(i);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(true, td1.steal(val));
+    EXPECT_EQ(i, val);
+  }
+  for (int i = 0; i < 1000; ++i) td1.push(i);
+  EXPECT_EQ(1024, td1.capacity());
+  for (int i = 0; i < 500; ++i) {
+    EXPECT_EQ(true, td1.steal(val));
+    EXPECT_EQ(i, val);
+  }
+  for (int i = 999; i >= 500; --i) {
+    EXPECT_EQ(true, td1.pop(val));
+    EXPECT_EQ(i, val);
+  }
+  EXPECT_EQ(true, td1.empty());
+}
+
+// every pushed value is taken exactly once by owner or thieves
+TEST_F(WorkStealingDequeTest, MultiThread) {
+  const int thief_num = 4;
+  const int total = 200000;
+  stl::work_stealing_deque<int> td1(2);
+  std::vector<std::atomic<int>> taken(total);
+  for (auto &t : taken) t.store(0);
+  std::atomic<bool> done(false);
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < thief_num; ++t) {
+    thieves.emplace_back([&] {
+      int val = 0;
+      while (!done.load()) {
+        if (td1.steal(val))
+          ++taken[val];
+        else
+          std::this_thread::yield();
+      }
+    });
+  }
+  int val = 0;
+  // a pop losing the last element to a thief keeps val
+  int overwritten = 0;
+  for (int i = 0; i < total; ++i) {
+    td1.push(i);
+    // owner keeps some work for itself, the deque grows meanwhile
+    if (i % 3 == 0) {
+      val = -1;
+      if (td1.pop(val))
+        ++taken[val];
+      else
+        overwritten += val != -1;
+    }
+  }
+  while (td1.pop(val)) ++taken[val];
+  done.store(true);
+  for (auto &th : thieves) th.join();
+  while (td1.steal(val)) ++taken[val];
+  int wrong = 0;
+  for (auto &t : taken) wrong += t.load() != 1;
+  EXPECT_EQ(0, wrong);
+  EXPECT_EQ(0, overwritten);
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
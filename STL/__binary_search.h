@@ -0,0 +1,171 @@
+#ifndef _BINARY_SEARCH_H__
+#define _BINARY_SEARCH_H__
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include "Def/stldef.h"
+
+STL_BEGIN
+
+// binary search of lower_bound and upper_bound.
+// a forward iterator halves [first, last) by advancing to the middle and
+// branches on the comparison. a random access iterator to cheap element
+// keeps only the base of the range and the length: the length is halved
+// unconditionally and the base moves by a conditional move, the loop has
+// log2(n) + 1 iterations for any value and no branch to mispredict. the
+// middle of both halves, one of which is the next one to read, is
+// prefetched, a large array misses cache at every level and the miss of
+// the next level overlaps the current one.
+
+// pred(*iter) is true for a prefix of [first, last), the end of it
+template <class ForwardIterator, class Predicate>
+ForwardIterator __partition_point(ForwardIterator first, ForwardIterator last,
+                                  Predicate pred, false_type) {
+  typedef typename iterator_traits<ForwardIterator>::difference_type
+      difference_type;
+  difference_type len = ::std::distance(first, last);
+  while (len > 0) {
+    const difference_type half = len / 2;
+    ForwardIterator middle = first;
+    ::std::advance(middle, half);
+    if (pred(*middle)) {
+      first = ++middle;
+      len -= half + 1;
+    } else {
+      len = half;
+    }
+  }
+  return first;
+}
+
+template <class RandomAccessIterator, class Predicate>
+RandomAccessIterator __partition_point(RandomAccessIterator first,
+                                       RandomAccessIterator last,
+                                       Predicate pred, true_type) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  difference_type len = last - first;
+  if (len == 0) return first;
+  // the end is in [first, first + len]
+  while (len > 1) {
+    const difference_type half = len / 2;
+    const difference_type next = len - half;
+    __builtin_prefetch(::std::addressof(first[next / 2]));
+    __builtin_prefetch(::std::addressof(first[half + next / 2]));
+    first = pred(first[half]) ? first + half : first;
+    len = next;
+  }
+  return first + (pred(*first) ? 1 : 0);
+}
+
+// element less than value by comp
+template <class T, class Compare>
+struct __less_than {
+  const T &value;
+  Compare &comp;
+
+  template <class U>
+  bool operator()(const U &elem) const {
+    return comp(elem, value);
+  }
+};
+
+// element not greater than value by comp
+template <class T, class Compare>
+struct __not_greater_than {
+  const T &value;
+  Compare &comp;
+
+  template <class U>
+  bool operator()(const U &elem) const {
+    return !comp(value, elem);
+  }
+};
+
+// Branchless selects the search by conditional move
+template <bool Branchless, class ForwardIterator, class T, class Compare>
+ForwardIterator __lower_bound(ForwardIterator first, ForwardIterator last,
+                              const T &value, Compare &comp) {
+  return STL_NAME::__partition_point(first, last,
+                                     __less_than<T, Compare>{value, comp},
+                                     integral_constant<bool, Branchless>());
+}
+
+template <bool Branchless, class ForwardIterator, class T, class Compare>
+ForwardIterator __upper_bound(ForwardIterator first, ForwardIterator last,
+                              const T &value, Compare &comp) {
+  return STL_NAME::__partition_point(
+      first, last, __not_greater_than<T, Compare>{value, comp},
+      integral_constant<bool, Branchless>());
+}
+
+// >>> batch search
+// many lower_bound of a random access range of cheap element. a single
+// search waits for the miss of every level in turn, a group of them
+// advances one level at a time: the group issues one independent load per
+// search a level, that many misses are in flight at once.
+//   lockstep: the search of a range of n has log2(n) + 1 level whatever the
+//     key, the group shares the length and keeps a base each. the next
+//     middle of a search is prefetched as soon as its base moves, it is
+//     read a level later, after the rest of the group.
+//   sorted key: the lower bound of ascending key ascends, the search of a
+//     key gallops from the bound of the one before, O(log gap) comparison
+//     on line mostly in cache. it wins once the key are dense in the range.
+
+// search of a group, the miss in flight of a level
+const ::std::size_t __batch_search_width = 16;
+
+// result[j] = lower bound of keys[j] in [first, first + len), j < count
+template <class RandomAccessIterator, class T, class Compare>
+void __lower_bound_group(
+    RandomAccessIterator first,
+    typename iterator_traits<RandomAccessIterator>::difference_type len,
+    const T *keys, ::std::size_t count, RandomAccessIterator *result,
+    Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  for (::std::size_t j = 0; j < count; ++j) result[j] = first;
+  if (len == 0) return;
+  while (len > 1) {
+    const difference_type half = len / 2;
+    const difference_type next = len - half;
+    for (::std::size_t j = 0; j < count; ++j) {
+      RandomAccessIterator base = result[j];
+      base = comp(base[half], keys[j]) ? base + half : base;
+      __builtin_prefetch(::std::addressof(base[next / 2]));
+      result[j] = base;
+    }
+    len = next;
+  }
+  for (::std::size_t j = 0; j < count; ++j)
+    result[j] += comp(*result[j], keys[j]) ? 1 : 0;
+}
+
+// lower bound of value in [from, first + len) if it is not before from.
+// the step doubles from from until an element is not less than value, the
+// bound is searched in the last step.
+template <class RandomAccessIterator, class T, class Compare>
+RandomAccessIterator __lower_bound_gallop(
+    RandomAccessIterator first, RandomAccessIterator from,
+    typename iterator_traits<RandomAccessIterator>::difference_type len,
+    const T &value, Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  difference_type low = from - first;
+  if (low == len || !comp(first[low], value)) return from;
+  // first[low] is less than value, the bound is in (low, low + step]
+  difference_type step = 1;
+  while (step < len - low && comp(first[low + step], value)) {
+    low += step;
+    step *= 2;
+  }
+  const difference_type high = step < len - low ? low + step : len;
+  return STL_NAME::__partition_point(first + (low + 1), first + high,
+                                     __less_than<T, Compare>{value, comp},
+                                     true_type());
+}
+
+STL_END
+
+#endif  // !_BINARY_SEARCH_H__
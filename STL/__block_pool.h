@@ -0,0 +1,215 @@
+#ifndef _BLOCK_POOL_H__
+#define _BLOCK_POOL_H__
+
+#include <cassert>
+#include <mutex>
+#include <new>
+#include <utility>
+#include "Def/stldef.h"
+
+STL_BEGIN
+
+// __block_pool is a process wide free list of memory blocks of Bytes bytes
+// aligned to Align, one pool per size class shared by all containers.
+// every thread keeps a cache of free blocks, allocate and deallocate only
+// touch the cache of the calling thread. the cache exchanges a batch of
+// blocks with a global depot (locked) when it runs empty or grows beyond two
+// batches, and only the depot gets new blocks from operator new.
+// a block may be deallocated by another thread than the allocating one.
+// free block is chained through its own storage. blocks in depot are never
+// given back to the system, the pool stays at its peak.
+template <::std::size_t Bytes, ::std::size_t Align>
+class __block_pool {
+  // link written into the storage of a free block
+  struct free_link_ {
+    free_link_ *next_;
+    free_link_ *next_batch_;  // only used by the first block of a batch
+  };
+
+  static_assert(Bytes >= sizeof(free_link_),
+                "block is too small to keep a free link");
+
+ public:
+  // blocks moved between thread cache and depot at once, about 64KiB
+  static const ::std::size_t batch_size =
+      65536 / Bytes < 4 ? 4 : (65536 / Bytes > 64 ? 64 : 65536 / Bytes);
+
+  // get a block, nothing is constructed in it
+  static void *allocate() {
+    if (cache_dead_()) return new_block_();
+    cache_ &cache = thread_cache_();
+    if (cache.free_ == nullptr) cache.refill_();
+    free_link_ *p = cache.free_;
+    cache.free_ = p->next_;
+    --cache.size_;
+    return p;
+  }
+
+  // give back a block from allocate() of any thread
+  static void deallocate(void *p) noexcept {
+    if (cache_dead_()) {
+      delete_block_(p);
+      return;
+    }
+    cache_ &cache = thread_cache_();
+    cache.free_ = ::new (p) free_link_{cache.free_, nullptr};
+    if (++cache.size_ > 2 * batch_size) cache.flush_(batch_size);
+  }
+
+ private:
+  // >>> global depot
+  // chain of full batches, first block of each batch links the next batch
+  struct depot_ {
+    ::std::mutex mutex_;
+    free_link_ *batches_ = nullptr;
+
+    // a batch of batch_size blocks, allocate new blocks if depot is empty
+    free_link_ *pop_batch_() {
+      {
+        ::std::lock_guard<::std::mutex> lock(mutex_);
+        if (batches_ != nullptr) {
+          free_link_ *batch = batches_;
+          batches_ = batch->next_batch_;
+          return batch;
+        }
+      }
+      free_link_ *batch = nullptr;
+      try {
+        for (::std::size_t i = 0; i < batch_size; ++i)
+          batch = ::new (new_block_()) free_link_{batch, nullptr};
+      } catch (...) {
+        while (batch != nullptr) {
+          free_link_ *next = batch->next_;
+          delete_block_(batch);
+          batch = next;
+        }
+        throw;
+      }
+      return batch;
+    }
+
+    void push_batch_(free_link_ *batch) noexcept {
+      ::std::lock_guard<::std::mutex> lock(mutex_);
+      batch->next_batch_ = batches_;
+      batches_ = batch;
+    }
+  };
+
+  // never destroyed, a thread may exit after static destruction
+  static depot_ &depot_instance_() {
+    static depot_ *depot = new depot_;
+    return *depot;
+  }
+
+  // >>> thread cache
+  struct cache_ {
+    free_link_ *free_ = nullptr;
+    ::std::size_t size_ = 0;
+
+    // give full batches back to depot when thread exits, depot only keeps
+    // full batch, so the rest goes back to system. a container of static or
+    // thread storage duration may outlive the cache, its block then comes
+    // from and goes back to the system.
+    ~cache_() {
+      while (size_ >= batch_size) flush_(batch_size);
+      while (free_ != nullptr) {
+        free_link_ *next = free_->next_;
+        delete_block_(free_);
+        free_ = next;
+      }
+      size_ = 0;
+      cache_dead_() = true;
+    }
+
+    void refill_() {
+      free_ = depot_instance_().pop_batch_();
+      size_ = batch_size;
+    }
+
+    // move the first n block to depot as a batch
+    void flush_(::std::size_t n) noexcept {
+      free_link_ *batch = free_;
+      free_link_ *last = free_;
+      for (::std::size_t i = 1; i < n; ++i) last = last->next_;
+      free_ = last->next_;
+      last->next_ = nullptr;
+      size_ -= n;
+      depot_instance_().push_batch_(batch);
+    }
+  };
+
+  static cache_ &thread_cache_() noexcept {
+    static thread_local cache_ cache;
+    return cache;
+  }
+
+  // the cache of the thread is destroyed, trivially destructible so it
+  // lives until the thread exits
+  static bool &cache_dead_() noexcept {
+    static thread_local bool dead = false;
+    return dead;
+  }
+
+  // >>> block from system
+  static void *new_block_() {
+    if (Align > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+      return ::operator new(Bytes, ::std::align_val_t(Align));
+    return ::operator new(Bytes);
+  }
+
+  static void delete_block_(void *p) noexcept {
+    if (Align > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+      ::operator delete(p, ::std::align_val_t(Align));
+    else
+      ::operator delete(p);
+  }
+};
+
+// power of two size class from min_bytes to max_bytes, each class is a
+// __block_pool. for small storage of different size like the map of deque.
+template <::std::size_t Align>
+class __size_class_pool {
+ public:
+  static const ::std::size_t min_bytes = 2 * sizeof(void *);
+  static const ::std::size_t max_bytes = 4096;
+
+  static void *allocate(::std::size_t bytes) {
+    return table_(::std::make_index_sequence<classes_>())[class_(bytes)]
+        .allocate_();
+  }
+
+  static void deallocate(void *p, ::std::size_t bytes) noexcept {
+    table_(::std::make_index_sequence<classes_>())[class_(bytes)]
+        .deallocate_(p);
+  }
+
+ private:
+  static constexpr ::std::size_t classes_ = 9;
+  static_assert((min_bytes << (classes_ - 1)) >= max_bytes,
+                "size class does not reach max_bytes");
+
+  // smallest class that holds bytes
+  static ::std::size_t class_(::std::size_t bytes) noexcept {
+    assert(bytes <= max_bytes);
+    ::std::size_t c = 0;
+    while ((min_bytes << c) < bytes) ++c;
+    return c;
+  }
+
+  struct entry_ {
+    void *(*allocate_)();
+    void (*deallocate_)(void *) noexcept;
+  };
+
+  template <::std::size_t... I>
+  static const entry_ *table_(::std::index_sequence<I...>) noexcept {
+    static const entry_ table[] = {
+        {&__block_pool<(min_bytes << I), Align>::allocate,
+         &__block_pool<(min_bytes << I), Align>::deallocate}...};
+    return table;
+  }
+};
+
+STL_END
+
+#endif  // !_BLOCK_POOL_H__
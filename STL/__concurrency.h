@@ -0,0 +1,153 @@
+#ifndef _CONCURRENCY_H__
+#define _CONCURRENCY_H__
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <climits>
+#include <thread>
+#include "Def/stldef.h"
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+STL_BEGIN
+
+// auxiliary of lock-free container, do not use it directly
+
+// size of destructive interference, member written by different thread is
+// aligned to it to avoid false sharing
+static const ::std::size_t __cache_line_size = 64;
+
+// hint cpu that we are in a spin loop
+inline void __cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+// exponential backoff for failed CAS
+// spin 1, 2, 4 ... MaxSpin times, then give up the time slice
+template <unsigned MaxSpin = 64>
+class __backoff {
+ public:
+  __backoff() noexcept : spin_(1) {}
+
+  void operator()() noexcept {
+    if (spin_ <= MaxSpin) {
+      for (unsigned i = 0; i < spin_; ++i) __cpu_relax();
+      spin_ <<= 1;
+    } else
+      ::std::this_thread::yield();
+  }
+
+  void reset() noexcept { spin_ = 1; }
+
+ private:
+  unsigned spin_;
+};
+
+// pointer and ABA tag packed into one word, so it can be swapped by a
+// single-word CAS. user space address of x86-64 and aarch64 fits in 48 bits,
+// the high 16 bits keep a counter bumped by every successful CAS.
+// it assumes 48-bit user space address: a pointer above it (5-level paging
+// mapping past 2^47 on request, pointer tagged in the top byte by aarch64
+// TBI or MTE) would overlap the tag, next asserts it does not.
+template <class Pointer>
+struct __tagged_pointer {
+  static_assert(sizeof(void *) == sizeof(::std::uint64_t),
+                "__tagged_pointer needs 64-bit pointer");
+
+  typedef ::std::uint64_t value_type;
+
+  static const int tag_shift = 48;
+  static const value_type pointer_mask = (value_type(1) << tag_shift) - 1;
+
+  static Pointer pointer(value_type v) noexcept {
+    return reinterpret_cast<Pointer>(static_cast<::std::uintptr_t>(v & pointer_mask));
+  }
+
+  // pack p with the next tag of old
+  static value_type next(value_type old, Pointer p) noexcept {
+    assert((static_cast<value_type>(reinterpret_cast<::std::uintptr_t>(p)) &
+            ~pointer_mask) == 0);
+    return (((old >> tag_shift) + 1) << tag_shift) |
+           static_cast<value_type>(reinterpret_cast<::std::uintptr_t>(p));
+  }
+};
+
+// block until *addr is not expected or woken by __futex_wake, may return
+// spuriously. without futex (not linux) it only gives up the time slice.
+inline void __futex_wait(::std::atomic<::std::uint32_t> *addr,
+                         ::std::uint32_t expected) noexcept {
+#ifdef __linux__
+  static_assert(sizeof(*addr) == sizeof(::std::uint32_t),
+                "futex word must be 32 bits");
+  ::syscall(SYS_futex, reinterpret_cast<::std::uint32_t *>(addr),
+            FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+  if (addr->load(::std::memory_order_acquire) == expected)
+    ::std::this_thread::yield();
+#endif
+}
+
+// wake at most n thread blocked in __futex_wait on addr
+inline void __futex_wake(::std::atomic<::std::uint32_t> *addr,
+                         int n = INT_MAX) noexcept {
+#ifdef __linux__
+  ::syscall(SYS_futex, reinterpret_cast<::std::uint32_t *>(addr),
+            FUTEX_WAKE_PRIVATE, n, nullptr, nullptr, 0);
+#else
+  (void)addr;
+  (void)n;
+#endif
+}
+
+// event for blocking operation of lock-free container.
+// a waiter registers in waiters_ before it checks its condition again and
+// sleeps on epoch_. notify is only a fence and a load when nobody waits.
+class __futex_event {
+ public:
+  __futex_event() noexcept : epoch_(0), waiters_(0) {}
+
+  __futex_event(const __futex_event &) = delete;
+
+  __futex_event &operator=(const __futex_event &) = delete;
+
+  // block until pred() returns true, pred is retried after every wake up
+  template <class Predicate>
+  void wait(Predicate pred) {
+    for (;;) {
+      ::std::uint32_t epoch = epoch_.load(::std::memory_order_acquire);
+      waiters_.fetch_add(1, ::std::memory_order_relaxed);
+      // pairs with the fence of notify: either pred sees the change, or the
+      // notifier sees the waiter and bumps epoch
+      ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+      bool done = pred();
+      if (!done) __futex_wait(&epoch_, epoch);
+      waiters_.fetch_sub(1, ::std::memory_order_relaxed);
+      if (done) return;
+    }
+  }
+
+  // wake at most n waiter, call it after the change pred depends on
+  void notify(int n = INT_MAX) noexcept {
+    ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+    if (waiters_.load(::std::memory_order_relaxed) == 0) return;
+    epoch_.fetch_add(1, ::std::memory_order_release);
+    __futex_wake(&epoch_, n);
+  }
+
+ private:
+  ::std::atomic<::std::uint32_t> epoch_;
+  ::std::atomic<::std::uint32_t> waiters_;
+};
+
+STL_END
+
+#endif  // !_CONCURRENCY_H__
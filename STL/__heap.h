@@ -0,0 +1,159 @@
+#ifndef _HEAP_H__
+#define _HEAP_H__
+
+#include <iterator>
+#include <utility>
+#include "Def/stldef.h"
+
+STL_BEGIN
+
+// d-ary max heap on [first, last) ordered by comp, the children of node i
+// are Arity * i + 1 ... Arity * i + Arity. a wider heap is shallower, a
+// sift-down touches fewer cache lines at the cost of more comparison per
+// level. the children of a node are one cache line if Arity * sizeof(T) is
+// the cache line size and first + 1 is aligned to it.
+
+// move the last element of [first, last) up to its place
+template <::std::size_t Arity, class RandomAccessIterator, class Compare>
+void __sift_up(RandomAccessIterator first, RandomAccessIterator last,
+               Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  typedef typename iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+  difference_type hole = last - first - 1;
+  if (hole <= 0) return;
+  difference_type parent = (hole - 1) / Arity;
+  if (!comp(first[parent], first[hole])) return;
+  value_type val(::std::move(first[hole]));
+  do {
+    first[hole] = ::std::move(first[parent]);
+    hole = parent;
+    parent = (hole - 1) / Arity;
+  } while (hole > 0 && comp(first[parent], val));
+  first[hole] = ::std::move(val);
+}
+
+// put val into hole of a heap of len element, hole is sifted down
+template <::std::size_t Arity, class RandomAccessIterator, class Compare,
+          class T>
+void __sift_down(RandomAccessIterator first, Compare &comp,
+                 typename iterator_traits<RandomAccessIterator>::difference_type
+                     len,
+                 typename iterator_traits<RandomAccessIterator>::difference_type
+                     hole,
+                 T &&val) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  for (;;) {
+    difference_type child = Arity * hole + 1;
+    if (child >= len) break;
+    // the largest child
+    difference_type last_child =
+        child + static_cast<difference_type>(Arity) < len
+            ? child + static_cast<difference_type>(Arity)
+            : len;
+    difference_type top = child;
+    for (++child; child < last_child; ++child)
+      if (comp(first[top], first[child])) top = child;
+    if (!comp(val, first[top])) break;
+    first[hole] = ::std::move(first[top]);
+    hole = top;
+  }
+  first[hole] = ::std::forward<T>(val);
+}
+
+// [first, last) is a heap but the last element, push it
+template <::std::size_t Arity, class RandomAccessIterator, class Compare>
+void __push_heap(RandomAccessIterator first, RandomAccessIterator last,
+                 Compare &comp) {
+  __sift_up<Arity>(first, last, comp);
+}
+
+// move the top to last - 1, [first, last - 1) is a heap again.
+// bottom-up (Wegener): the hole of top goes down to a leaf along the
+// largest child without comparing with the moved element, then the element
+// goes up from there. the last element usually belongs near the leaves, it
+// saves a comparison per level.
+template <::std::size_t Arity, class RandomAccessIterator, class Compare>
+void __pop_heap(RandomAccessIterator first, RandomAccessIterator last,
+                Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  typedef typename iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+  if (last - first <= 1) return;
+  --last;
+  value_type val(::std::move(*last));
+  *last = ::std::move(*first);
+  const difference_type len = last - first;
+  difference_type hole = 0;
+  // node with all Arity children, the loop has fixed count
+  for (;;) {
+    difference_type child = Arity * hole + 1;
+    if (child + static_cast<difference_type>(Arity) > len) break;
+    difference_type top = child;
+    for (::std::size_t k = 1; k < Arity; ++k)
+      top = comp(first[top], first[child + k]) ? child + k : top;
+    first[hole] = ::std::move(first[top]);
+    hole = top;
+  }
+  // at most one node has fewer children
+  difference_type child = Arity * hole + 1;
+  if (child < len) {
+    difference_type top = child;
+    for (++child; child < len; ++child)
+      if (comp(first[top], first[child])) top = child;
+    first[hole] = ::std::move(first[top]);
+    hole = top;
+  }
+  while (hole > 0) {
+    difference_type parent = (hole - 1) / Arity;
+    if (!comp(first[parent], val)) break;
+    first[hole] = ::std::move(first[parent]);
+    hole = parent;
+  }
+  first[hole] = ::std::move(val);
+}
+
+// Floyd: sift down every inner node from the last one, a node of height h
+// costs O(h), O(n) in total
+template <::std::size_t Arity, class RandomAccessIterator, class Compare>
+void __make_heap(RandomAccessIterator first, RandomAccessIterator last,
+                 Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  typedef typename iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+  const difference_type len = last - first;
+  if (len <= 1) return;
+  for (difference_type i = (len - 2) / Arity + 1; i > 0;) {
+    --i;
+    value_type val(::std::move(first[i]));
+    __sift_down<Arity>(first, comp, len, i, ::std::move(val));
+  }
+}
+
+// pop every element, [first, last) is sorted ascending by comp
+template <::std::size_t Arity, class RandomAccessIterator, class Compare>
+void __sort_heap(RandomAccessIterator first, RandomAccessIterator last,
+                 Compare &comp) {
+  for (; last - first > 1; --last) __pop_heap<Arity>(first, last, comp);
+}
+
+// the first element greater than its parent, or last
+template <::std::size_t Arity, class RandomAccessIterator, class Compare>
+RandomAccessIterator __is_heap_until(RandomAccessIterator first,
+                                     RandomAccessIterator last,
+                                     Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  const difference_type len = last - first;
+  for (difference_type i = 1; i < len; ++i)
+    if (comp(first[(i - 1) / Arity], first[i])) return first + i;
+  return last;
+}
+
+STL_END
+
+#endif  // !_HEAP_H__
@@ -0,0 +1,101 @@
+#ifndef _NODE_POOL_H__
+#define _NODE_POOL_H__
+
+#include "Def/stldef.h"
+
+STL_BEGIN
+
+// __node_pool is a auxiliary free list for node based container
+// node released by erase/pop is kept in the pool and handed out again by the
+// next insertion, so insert/erase churn do not hit the allocator every time.
+// free nodes are chained through their own storage, so the pool costs one
+// pointer and a counter per container and nothing per node.
+// the pool do not own an allocator, container pass its node allocator in.
+// at most MaxCache nodes are kept, the rest are deallocated immediately.
+template <class NodeAllocator, ::std::size_t MaxCache = 64>
+class __node_pool {
+  typedef allocator_traits<NodeAllocator> alloc_traits_;
+
+ public:
+  // >>> member types
+  typedef typename alloc_traits_::value_type node_type;
+  typedef typename alloc_traits_::pointer pointer;
+  typedef typename alloc_traits_::size_type size_type;
+
+  static_assert(sizeof(node_type) >= sizeof(void *),
+                "node is too small to keep a free link");
+
+  // >>> constructor
+  __node_pool() noexcept : free_(nullptr), size_(0) {}
+
+  // no copy operation
+  __node_pool(const __node_pool &) = delete;
+
+  __node_pool &operator=(const __node_pool &) = delete;
+
+  // >>> destructor
+  // owner must call release_() with its allocator before destruction
+  ~__node_pool() { assert(free_ == nullptr); }
+
+  // >>> capacity
+  size_type size() const noexcept { return size_; }
+
+  bool empty() const noexcept { return free_ == nullptr; }
+
+  // >>> modifier
+  // get a node from pool, allocate a new one if pool is empty
+  // the returned node is raw storage, nothing is constructed
+  pointer allocate_(NodeAllocator &alloc) {
+    if (free_ == nullptr) return alloc_traits_::allocate(alloc, 1);
+    free_link_ *p = free_;
+    free_ = p->next_;
+    --size_;
+    return pointer_traits<pointer>::pointer_to(
+        *reinterpret_cast<node_type *>(p));
+  }
+
+  // give back a node, value of node must be destroyed already
+  void deallocate_(NodeAllocator &alloc, pointer p) noexcept {
+    if (size_ >= MaxCache) {
+      alloc_traits_::deallocate(alloc, p, 1);
+      return;
+    }
+    free_link_ *link = ::new (static_cast<void *>(__to_raw_pointer(p)))
+        free_link_{free_};
+    free_ = link;
+    ++size_;
+  }
+
+  // deallocate all cached node
+  void release_(NodeAllocator &alloc) noexcept {
+    while (free_ != nullptr) {
+      free_link_ *p = free_;
+      free_ = p->next_;
+      alloc_traits_::deallocate(
+          alloc,
+          pointer_traits<pointer>::pointer_to(
+              *reinterpret_cast<node_type *>(p)),
+          1);
+    }
+    size_ = 0;
+  }
+
+  void swap(__node_pool &x) noexcept {
+    ::std::swap(free_, x.free_);
+    ::std::swap(size_, x.size_);
+  }
+
+ private:
+  // link written into the storage of a free node
+  struct free_link_ {
+    free_link_ *next_;
+  };
+
+  // >>> data member
+  free_link_ *free_;
+  size_type size_;
+};
+
+STL_END
+
+#endif  // !_NODE_POOL_H__
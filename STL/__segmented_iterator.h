@@ -0,0 +1,52 @@
+#ifndef _SEGMENTED_ITERATOR_H__
+#define _SEGMENTED_ITERATOR_H__
+
+#include "Def/stldef.h"
+
+STL_BEGIN
+
+// auxiliary of algorithm, do not use it directly
+
+// a segmented iterator walks a sequence of contiguous segments, e.g. blocks
+// of deque. its operator++ checks the segment boundary on every step, so
+// algorithm detects it by __is_segmented_iterator and loops over the plain
+// local iterator of each segment instead, which can be vectorized or turned
+// into memmove by compiler.
+//
+// a segmented iterator specializes __segmented_iterator_traits with:
+//   segment_iterator: iterator over segments
+//   local_iterator: iterator in a segment
+//   segment(it), local(it): split it into segment and local iterator
+//   begin(seg), end(seg): local range of whole segment seg
+//   compose(seg, local): iterator of local in seg, local may be end(seg)
+template <class Iterator>
+struct __segmented_iterator_traits {
+  typedef false_type is_segmented_iterator;
+};
+
+template <class Iterator>
+struct __is_segmented_iterator
+    : __segmented_iterator_traits<Iterator>::is_segmented_iterator {};
+
+// call func(seg, local_first, local_last) for every segment seg of
+// [first, last) in order, stop as soon as func returns false.
+// return false if stopped by func.
+template <class SegmentedIterator, class Function>
+bool __for_each_segment(SegmentedIterator first, SegmentedIterator last,
+                        Function &func) {
+  typedef __segmented_iterator_traits<SegmentedIterator> traits;
+  typename traits::segment_iterator seg_first = traits::segment(first);
+  typename traits::segment_iterator seg_last = traits::segment(last);
+  if (seg_first == seg_last)
+    return func(seg_first, traits::local(first), traits::local(last));
+  if (!func(seg_first, traits::local(first), traits::end(seg_first)))
+    return false;
+  for (++seg_first; seg_first != seg_last; ++seg_first)
+    if (!func(seg_first, traits::begin(seg_first), traits::end(seg_first)))
+      return false;
+  return func(seg_last, traits::begin(seg_last), traits::local(last));
+}
+
+STL_END
+
+#endif  // !_SEGMENTED_ITERATOR_H__
@@ -0,0 +1,1309 @@
+#ifndef _SORT_H__
+#define _SORT_H__
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <utility>
+#include "Def/stldef.h"
+#include "__heap.h"
+#include "__sort_network.h"
+
+STL_BEGIN
+
+// pattern-defeating quicksort (Orson Peters): introsort whose partition
+// notices sorted run and many equal element, so that sorted, reverse and
+// few-unique input are linear or close to it. a partition too unbalanced
+// for too many times falls back to heap sort, O(n log n) in worst case.
+
+// size under which a partition is sorted by insertion sort
+const ::std::ptrdiff_t __sort_insertion_threshold = 24;
+// size over which pivot is the pseudo median of 9 (Tukey's ninther)
+const ::std::ptrdiff_t __sort_ninther_threshold = 128;
+// moves a partial insertion sort may do before it gives up
+const ::std::ptrdiff_t __sort_partial_insertion_limit = 8;
+// element scanned per side at a time by the branch-free partition
+const ::std::size_t __sort_block_size = 64;
+
+// raw buffer of n element, the first constructed ones are destroyed at the
+// end
+template <class T, class Allocator = allocator<T>>
+struct __temporary_buffer {
+  typedef typename allocator_traits<Allocator>::template rebind_alloc<T>
+      allocator_type;
+  typedef allocator_traits<allocator_type> alloc_traits;
+
+  explicit __temporary_buffer(::std::size_t n,
+                              const Allocator &a = Allocator())
+      : alloc(a), data(alloc_traits::allocate(alloc, n)), size(n),
+        constructed(0) {}
+
+  // an empty buffer if the allocation throws
+  __temporary_buffer(::std::size_t n, const Allocator &a,
+                     const ::std::nothrow_t &) noexcept
+      : alloc(a), data(nullptr), size(0), constructed(0) {
+    try {
+      data = alloc_traits::allocate(alloc, n);
+      size = n;
+    } catch (...) {
+    }
+  }
+
+  ~__temporary_buffer() {
+    for (::std::size_t i = 0; i < constructed; ++i)
+      alloc_traits::destroy(alloc, data + i);
+    if (data) alloc_traits::deallocate(alloc, data, size);
+  }
+
+  __temporary_buffer(const __temporary_buffer &) = delete;
+  __temporary_buffer &operator=(const __temporary_buffer &) = delete;
+
+  allocator_type alloc;
+  T *data;
+  ::std::size_t size;
+  ::std::size_t constructed;
+};
+
+template <class RandomAccessIterator, class Compare>
+inline void __sort2(RandomAccessIterator a, RandomAccessIterator b,
+                    Compare &comp) {
+  if (comp(*b, *a)) ::std::iter_swap(a, b);
+}
+
+template <class RandomAccessIterator, class Compare>
+inline void __sort3(RandomAccessIterator a, RandomAccessIterator b,
+                    RandomAccessIterator c, Compare &comp) {
+  STL_NAME::__sort2(a, b, comp);
+  STL_NAME::__sort2(b, c, comp);
+  STL_NAME::__sort2(a, b, comp);
+}
+
+template <class RandomAccessIterator, class Compare>
+void __insertion_sort(RandomAccessIterator first, RandomAccessIterator last,
+                      Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+  if (first == last) return;
+  for (RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+    RandomAccessIterator sift = cur;
+    RandomAccessIterator sift_1 = cur - 1;
+    if (!comp(*sift, *sift_1)) continue;
+    value_type tmp(::std::move(*sift));
+    do {
+      *sift-- = ::std::move(*sift_1);
+    } while (sift != first && comp(tmp, *--sift_1));
+    *sift = ::std::move(tmp);
+  }
+}
+
+// *(first - 1) is not greater than any element of [first, last), it stops
+// the sift, no bound check is needed
+template <class RandomAccessIterator, class Compare>
+void __unguarded_insertion_sort(RandomAccessIterator first,
+                                RandomAccessIterator last, Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+  if (first == last) return;
+  for (RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+    RandomAccessIterator sift = cur;
+    RandomAccessIterator sift_1 = cur - 1;
+    if (!comp(*sift, *sift_1)) continue;
+    value_type tmp(::std::move(*sift));
+    do {
+      *sift-- = ::std::move(*sift_1);
+    } while (comp(tmp, *--sift_1));
+    *sift = ::std::move(tmp);
+  }
+}
+
+// insertion sort that gives up after __sort_partial_insertion_limit moves,
+// return true if [first, last) is sorted
+template <class RandomAccessIterator, class Compare>
+bool __partial_insertion_sort(RandomAccessIterator first,
+                              RandomAccessIterator last, Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+  if (first == last) return true;
+  ::std::ptrdiff_t limit = 0;
+  for (RandomAccessIterator cur = first + 1; cur != last; ++cur) {
+    RandomAccessIterator sift = cur;
+    RandomAccessIterator sift_1 = cur - 1;
+    if (!comp(*sift, *sift_1)) continue;
+    value_type tmp(::std::move(*sift));
+    do {
+      *sift-- = ::std::move(*sift_1);
+    } while (sift != first && comp(tmp, *--sift_1));
+    *sift = ::std::move(tmp);
+    limit += cur - sift;
+    if (limit > __sort_partial_insertion_limit) return false;
+  }
+  return true;
+}
+
+// partition [first, last) around pivot *first, element equal to pivot goes
+// right. return the position of pivot and whether no element was swapped.
+// there is an element not less than pivot in [first + 1, last) (a median
+// of 3 is chosen), the left scan needs no bound check.
+template <class RandomAccessIterator, class Compare>
+pair<RandomAccessIterator, bool> __partition_right(RandomAccessIterator first,
+                                                   RandomAccessIterator last,
+                                                   Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+  RandomAccessIterator begin = first;
+  value_type pivot(::std::move(*begin));
+  while (comp(*++first, pivot)) {
+  }
+  // no element less than pivot was found before first, *(first - 1) can not
+  // stop the right scan
+  if (first - 1 == begin)
+    while (first < last && !comp(*--last, pivot)) {
+    }
+  else
+    while (!comp(*--last, pivot)) {
+    }
+  const bool already_partitioned = first >= last;
+  while (first < last) {
+    ::std::iter_swap(first, last);
+    while (comp(*++first, pivot)) {
+    }
+    while (!comp(*--last, pivot)) {
+    }
+  }
+  RandomAccessIterator pivot_pos = first - 1;
+  *begin = ::std::move(*pivot_pos);
+  *pivot_pos = ::std::move(pivot);
+  return pair<RandomAccessIterator, bool>(pivot_pos, already_partitioned);
+}
+
+// swap num pair of misplaced element found by __partition_right_branchless.
+// a cyclic permutation moves each element once instead of three times, but
+// it rotates rather than swaps if the two side are of the same count, so
+// plain swap is kept there for the descending input to stay linear.
+template <class RandomAccessIterator>
+void __swap_offsets(RandomAccessIterator first, RandomAccessIterator last,
+                    const unsigned char *offsets_l,
+                    const unsigned char *offsets_r, ::std::size_t num,
+                    bool use_swaps) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+  if (use_swaps) {
+    for (::std::size_t i = 0; i < num; ++i)
+      ::std::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+  } else if (num > 0) {
+    RandomAccessIterator l = first + offsets_l[0];
+    RandomAccessIterator r = last - offsets_r[0];
+    value_type tmp(::std::move(*l));
+    *l = ::std::move(*r);
+    for (::std::size_t i = 1; i < num; ++i) {
+      l = first + offsets_l[i];
+      *r = ::std::move(*l);
+      r = last - offsets_r[i];
+      *l = ::std::move(*r);
+    }
+    *r = ::std::move(tmp);
+  }
+}
+
+// the same result as __partition_right, BlockQuicksort (Edelkamp and Weiss):
+// a block of each side is scanned first, the offset of misplaced element is
+// recorded by adding the result of comparison to the count instead of
+// branching on it, then the recorded pairs are swapped. the scan has no
+// branch to mispredict on random input, it pays if comparison is cheap.
+template <class RandomAccessIterator, class Compare>
+pair<RandomAccessIterator, bool> __partition_right_branchless(
+    RandomAccessIterator first, RandomAccessIterator last, Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+  RandomAccessIterator begin = first;
+  value_type pivot(::std::move(*begin));
+  while (comp(*++first, pivot)) {
+  }
+  if (first - 1 == begin)
+    while (first < last && !comp(*--last, pivot)) {
+    }
+  else
+    while (!comp(*--last, pivot)) {
+    }
+  const bool already_partitioned = first >= last;
+  if (!already_partitioned) {
+    ::std::iter_swap(first, last);
+    ++first;
+
+    alignas(64) unsigned char offsets_l[__sort_block_size];
+    alignas(64) unsigned char offsets_r[__sort_block_size];
+    RandomAccessIterator offsets_l_base = first;
+    RandomAccessIterator offsets_r_base = last;
+    ::std::size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+    while (first < last) {
+      // a side whose offsets are used up scans a new block, the rest is
+      // split between the two side if it is less than a block each
+      const ::std::size_t num_unknown = last - first;
+      const ::std::size_t left_split =
+          num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+      const ::std::size_t right_split =
+          num_r == 0 ? num_unknown - left_split : 0;
+
+      if (left_split >= __sort_block_size) {
+        for (::std::size_t i = 0; i < __sort_block_size;) {
+          for (int k = 0; k < 8; ++k) {
+            offsets_l[num_l] = static_cast<unsigned char>(i++);
+            num_l += !comp(*first, pivot);
+            ++first;
+          }
+        }
+      } else {
+        for (::std::size_t i = 0; i < left_split;) {
+          offsets_l[num_l] = static_cast<unsigned char>(i++);
+          num_l += !comp(*first, pivot);
+          ++first;
+        }
+      }
+
+      if (right_split >= __sort_block_size) {
+        for (::std::size_t i = 0; i < __sort_block_size;) {
+          for (int k = 0; k < 8; ++k) {
+            offsets_r[num_r] = static_cast<unsigned char>(++i);
+            num_r += comp(*--last, pivot);
+          }
+        }
+      } else {
+        for (::std::size_t i = 0; i < right_split;) {
+          offsets_r[num_r] = static_cast<unsigned char>(++i);
+          num_r += comp(*--last, pivot);
+        }
+      }
+
+      const ::std::size_t num = num_l < num_r ? num_l : num_r;
+      STL_NAME::__swap_offsets(offsets_l_base, offsets_r_base,
+                               offsets_l + start_l, offsets_r + start_r, num,
+                               num_l == num_r);
+      num_l -= num;
+      num_r -= num;
+      start_l += num;
+      start_r += num;
+      if (num_l == 0) {
+        start_l = 0;
+        offsets_l_base = first;
+      }
+      if (num_r == 0) {
+        start_r = 0;
+        offsets_r_base = last;
+      }
+    }
+
+    // [first, last) is classified, misplaced element left on one side goes
+    // to the boundary
+    if (num_l) {
+      const unsigned char *offsets = offsets_l + start_l;
+      while (num_l--) ::std::iter_swap(offsets_l_base + offsets[num_l], --last);
+      first = last;
+    }
+    if (num_r) {
+      const unsigned char *offsets = offsets_r + start_r;
+      while (num_r--) {
+        ::std::iter_swap(offsets_r_base - offsets[num_r], first);
+        ++first;
+      }
+    }
+  }
+  RandomAccessIterator pivot_pos = first - 1;
+  *begin = ::std::move(*pivot_pos);
+  *pivot_pos = ::std::move(pivot);
+  return pair<RandomAccessIterator, bool>(pivot_pos, already_partitioned);
+}
+
+// partition [first, last) around pivot *first, element equal to pivot goes
+// left. it is used when *(first - 1) equals to pivot, no element of
+// [first, last) is less than it, the whole left part equals to pivot and
+// needs no more sorting. the right scan is stopped by pivot itself.
+template <class RandomAccessIterator, class Compare>
+RandomAccessIterator __partition_left(RandomAccessIterator first,
+                                      RandomAccessIterator last,
+                                      Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+  RandomAccessIterator begin = first;
+  RandomAccessIterator end = last;
+  value_type pivot(::std::move(*begin));
+  while (comp(pivot, *--last)) {
+  }
+  if (last + 1 == end)
+    while (first < last && !comp(pivot, *++first)) {
+    }
+  else
+    while (!comp(pivot, *++first)) {
+    }
+  while (first < last) {
+    ::std::iter_swap(first, last);
+    while (comp(pivot, *--last)) {
+    }
+    while (!comp(pivot, *++first)) {
+    }
+  }
+  RandomAccessIterator pivot_pos = last;
+  *begin = ::std::move(*pivot_pos);
+  *pivot_pos = ::std::move(pivot);
+  return pivot_pos;
+}
+
+// small partition
+template <class RandomAccessIterator, class Compare>
+void __pdqsort_small(RandomAccessIterator first, RandomAccessIterator last,
+                     Compare &comp, bool leftmost, false_type) {
+  if (leftmost)
+    STL_NAME::__insertion_sort(first, last, comp);
+  else
+    STL_NAME::__unguarded_insertion_sort(first, last, comp);
+}
+
+#ifdef __STL_SORT_NETWORK
+template <class RandomAccessIterator, class Compare>
+void __pdqsort_small(RandomAccessIterator first, RandomAccessIterator last,
+                     Compare &, bool, true_type) {
+  STL_NAME::__sort_network(first, last);
+}
+#endif
+
+// move the median of 3, or the ninther over __sort_ninther_threshold, to
+// *first. an element of the sample not less than it stays in
+// [first + 1, last) and stops the scan of __partition_right.
+template <class RandomAccessIterator, class Compare>
+void __choose_pivot(RandomAccessIterator first, RandomAccessIterator last,
+                    Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  const difference_type size = last - first;
+  const difference_type half = size / 2;
+  if (size > __sort_ninther_threshold) {
+    STL_NAME::__sort3(first, first + half, last - 1, comp);
+    STL_NAME::__sort3(first + 1, first + (half - 1), last - 2, comp);
+    STL_NAME::__sort3(first + 2, first + (half + 1), last - 3, comp);
+    STL_NAME::__sort3(first + (half - 1), first + half, first + (half + 1),
+                      comp);
+    ::std::iter_swap(first, first + half);
+  } else {
+    STL_NAME::__sort3(first + half, first, last - 1, comp);
+  }
+}
+
+// sort [first, last), the left partition is sorted by recursion and the
+// right one by the loop. bad_allowed is the number of highly unbalanced
+// partition left before heap sort takes over. leftmost is false if
+// *(first - 1) is a pivot of an earlier partition, it bounds every scan.
+// Network sorts a partition of up to __sort_network_max by the sorting
+// network.
+template <bool Branchless, bool Network, class RandomAccessIterator,
+          class Compare>
+void __pdqsort_loop(RandomAccessIterator first, RandomAccessIterator last,
+                    Compare &comp, int bad_allowed, bool leftmost) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  const difference_type small_size =
+      Network ? static_cast<difference_type>(__sort_network_max) + 1
+              : __sort_insertion_threshold;
+  for (;;) {
+    const difference_type size = last - first;
+    if (size < small_size) {
+      STL_NAME::__pdqsort_small(first, last, comp, leftmost,
+                                integral_constant<bool, Network>());
+      return;
+    }
+
+    STL_NAME::__choose_pivot(first, last, comp);
+
+    // pivot equals to the pivot of the partition on the left, every element
+    // equal to it goes left and is done, few-unique input is O(n k)
+    if (!leftmost && !comp(*(first - 1), *first)) {
+      first = STL_NAME::__partition_left(first, last, comp) + 1;
+      continue;
+    }
+
+    pair<RandomAccessIterator, bool> part =
+        Branchless ? STL_NAME::__partition_right_branchless(first, last, comp)
+                   : STL_NAME::__partition_right(first, last, comp);
+    RandomAccessIterator pivot_pos = part.first;
+    const difference_type l_size = pivot_pos - first;
+    const difference_type r_size = last - (pivot_pos + 1);
+
+    if (l_size < size / 8 || r_size < size / 8) {
+      if (--bad_allowed == 0) {
+        STL_NAME::__make_heap<2>(first, last, comp);
+        STL_NAME::__sort_heap<2>(first, last, comp);
+        return;
+      }
+      // shuffle some element to break the pattern that made the partition
+      // unbalanced
+      if (l_size >= __sort_insertion_threshold) {
+        ::std::iter_swap(first, first + l_size / 4);
+        ::std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+        if (l_size > __sort_ninther_threshold) {
+          ::std::iter_swap(first + 1, first + (l_size / 4 + 1));
+          ::std::iter_swap(first + 2, first + (l_size / 4 + 2));
+          ::std::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+          ::std::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+        }
+      }
+      if (r_size >= __sort_insertion_threshold) {
+        ::std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+        ::std::iter_swap(last - 1, last - r_size / 4);
+        if (r_size > __sort_ninther_threshold) {
+          ::std::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+          ::std::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+          ::std::iter_swap(last - 2, last - (1 + r_size / 4));
+          ::std::iter_swap(last - 3, last - (2 + r_size / 4));
+        }
+      }
+    } else if (part.second &&
+               STL_NAME::__partial_insertion_sort(first, pivot_pos, comp) &&
+               STL_NAME::__partial_insertion_sort(pivot_pos + 1, last, comp)) {
+      // nothing was swapped, the range is likely sorted already
+      return;
+    }
+
+    STL_NAME::__pdqsort_loop<Branchless, Network>(first, pivot_pos, comp,
+                                                  bad_allowed, leftmost);
+    first = pivot_pos + 1;
+    leftmost = false;
+  }
+}
+
+// Branchless selects the block partition, for cheap comparison only.
+// Network selects the sorting network for small partition, for the builtin
+// < of a network key only.
+template <bool Branchless, bool Network, class RandomAccessIterator,
+          class Compare>
+void __pdqsort(RandomAccessIterator first, RandomAccessIterator last,
+               Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  difference_type size = last - first;
+  if (size <= 1) return;
+  int log2 = 0;
+  for (; size > 1; size >>= 1) ++log2;
+  STL_NAME::__pdqsort_loop<Branchless, Network>(first, last, comp, log2,
+                                                true);
+}
+
+// >>> selection
+// introselect: the partition of pdqsort, keeping only the side of nth. a
+// pivot of a large range is chosen by Floyd-Rivest sampling: nth of a
+// sample around nth is selected first, recursively, so the pivot is close
+// to nth and the side kept is small, about 1.5 n comparison in total on
+// random input. a partition keeping over 7/8 of the range is bad, after
+// log2(n) bad ones every pivot is the median of medians of 5, linear in
+// worst case.
+
+// size from which the pivot is chosen by Floyd-Rivest sampling
+const ::std::ptrdiff_t __select_sample_threshold = 600;
+
+template <bool Branchless, class RandomAccessIterator, class Compare>
+void __introselect(RandomAccessIterator first, RandomAccessIterator nth,
+                   RandomAccessIterator last, Compare &comp, int bad_allowed,
+                   bool leftmost);
+
+// move nth of a sample of about n^(2/3) element to *first (Floyd and
+// Rivest, algorithm SELECT). the sample is spread over [first, last) and
+// swapped to the block around nth, whose element are not random if the
+// input has a pattern. first < nth < last - 1.
+template <bool Branchless, class RandomAccessIterator, class Compare>
+void __sample_pivot(RandomAccessIterator first, RandomAccessIterator nth,
+                    RandomAccessIterator last, Compare &comp,
+                    int bad_allowed) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  const double n = static_cast<double>(last - first);
+  const double i = static_cast<double>(nth - first);
+  const double z = ::std::log(n);
+  const double s = 0.5 * ::std::exp(2.0 * z / 3.0);
+  const double sd =
+      0.5 * ::std::sqrt(z * s * (n - s) / n) * (i < n / 2 ? -1.0 : 1.0);
+  difference_type lo = static_cast<difference_type>(i - i * s / n + sd);
+  difference_type hi =
+      static_cast<difference_type>(i + (n - i) * s / n + sd) + 1;
+  const difference_type k = nth - first;
+  // an element after nth in the sample is not less than the pivot, it stops
+  // the scan of __partition_right
+  if (lo < 0) lo = 0;
+  if (lo > k) lo = k;
+  if (hi < k + 2) hi = k + 2;
+  if (hi > last - first) hi = last - first;
+  const difference_type m = hi - lo;
+  const difference_type size = last - first;
+  for (difference_type j = 0; j < m; ++j) {
+    const difference_type from = j * size / m + size / (2 * m);
+    if (from < lo || from >= hi)
+      ::std::iter_swap(first + (lo + j), first + from);
+  }
+  STL_NAME::__introselect<Branchless>(first + lo, nth, first + hi, comp,
+                                      bad_allowed, true);
+  ::std::iter_swap(first, nth);
+}
+
+// move the median of medians of 5 to *first, a third of [first, last) at
+// least is not greater and a third is not less than it. 15 element at
+// least.
+template <bool Branchless, class RandomAccessIterator, class Compare>
+void __median_of_medians_pivot(RandomAccessIterator first,
+                               RandomAccessIterator last, Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  const difference_type groups = (last - first) / 5;
+  for (difference_type g = 0; g < groups; ++g) {
+    RandomAccessIterator group = first + 5 * g;
+    STL_NAME::__insertion_sort(group, group + 5, comp);
+    ::std::iter_swap(first + g, group + 2);
+  }
+  // the medians after the pivot are not less than it
+  RandomAccessIterator pivot = first + groups / 2;
+  STL_NAME::__introselect<Branchless>(first, pivot, first + groups, comp, 0,
+                                      true);
+  ::std::iter_swap(first, pivot);
+}
+
+// partition [first, last) until nth is in place. bad_allowed and leftmost
+// are those of __pdqsort_loop.
+template <bool Branchless, class RandomAccessIterator, class Compare>
+void __introselect(RandomAccessIterator first, RandomAccessIterator nth,
+                   RandomAccessIterator last, Compare &comp, int bad_allowed,
+                   bool leftmost) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  for (;;) {
+    const difference_type size = last - first;
+    if (size < __sort_insertion_threshold) {
+      STL_NAME::__insertion_sort(first, last, comp);
+      return;
+    }
+    // the least or the largest element by a scan
+    if (nth == first) {
+      ::std::iter_swap(first, ::std::min_element(first, last, comp));
+      return;
+    }
+    if (nth == last - 1) {
+      ::std::iter_swap(nth, ::std::max_element(first, last, comp));
+      return;
+    }
+
+    if (bad_allowed == 0)
+      STL_NAME::__median_of_medians_pivot<Branchless>(first, last, comp);
+    else if (size >= __select_sample_threshold)
+      STL_NAME::__sample_pivot<Branchless>(first, nth, last, comp,
+                                           bad_allowed);
+    else
+      STL_NAME::__choose_pivot(first, last, comp);
+
+    // pivot equals to the pivot on the left, every element equal to it goes
+    // left and is in place
+    if (!leftmost && !comp(*(first - 1), *first)) {
+      RandomAccessIterator pivot_pos =
+          STL_NAME::__partition_left(first, last, comp);
+      if (nth <= pivot_pos) return;
+      first = pivot_pos + 1;
+      continue;
+    }
+
+    RandomAccessIterator pivot_pos =
+        (Branchless ? STL_NAME::__partition_right_branchless(first, last, comp)
+                    : STL_NAME::__partition_right(first, last, comp))
+            .first;
+    if (nth == pivot_pos) return;
+    if (nth < pivot_pos) {
+      last = pivot_pos;
+    } else {
+      first = pivot_pos + 1;
+      leftmost = false;
+    }
+    if (last - first > size - size / 8 && bad_allowed > 0) --bad_allowed;
+  }
+}
+
+// bad partition allowed before the median of medians, log2(size)
+inline int __select_budget(::std::ptrdiff_t size) {
+  int log2 = 0;
+  for (; size > 1; size >>= 1) ++log2;
+  return log2;
+}
+
+template <bool Branchless, class RandomAccessIterator, class Compare>
+void __nth_element(RandomAccessIterator first, RandomAccessIterator nth,
+                   RandomAccessIterator last, Compare &comp) {
+  if (nth == last) return;
+  STL_NAME::__introselect<Branchless>(first, nth, last, comp,
+                                      __select_budget(last - first), true);
+}
+
+// every kth of [kth_first, kth_last) in place, nth of the middle kth is
+// selected and the kth on each side of it are selected in the part on that
+// side, O(n log m) for m kth
+template <bool Branchless, class RandomAccessIterator, class ForwardIterator,
+          class Compare>
+void __nth_elements(RandomAccessIterator first, RandomAccessIterator last,
+                    ForwardIterator kth_first, ForwardIterator kth_last,
+                    Compare &comp) {
+  while (kth_first != kth_last) {
+    if (last - first < __sort_insertion_threshold) {
+      STL_NAME::__insertion_sort(first, last, comp);
+      return;
+    }
+    ForwardIterator middle = kth_first;
+    ::std::advance(middle, ::std::distance(kth_first, kth_last) / 2);
+    const RandomAccessIterator nth = *middle;
+    STL_NAME::__nth_element<Branchless>(first, nth, last, comp);
+    STL_NAME::__nth_elements<Branchless>(
+        first, nth, kth_first, ::std::lower_bound(kth_first, middle, nth),
+        comp);
+    first = nth + 1;
+    kth_first = ::std::upper_bound(middle, kth_last, nth);
+  }
+}
+
+// >>> partial sort
+// the k least of [first, last) to [first, first + k), partial_sort sorts
+// them then. a window of 2k element from first holds candidates, once it
+// is full the k least are selected into [first, first + k) and
+// *(first + k - 1) is the threshold, a later element is a candidate only
+// if it is less than the threshold. the selection of 2k costs O(k) and
+// drops k, O(n + k log k) in worst case with the sort, and about n
+// comparison on random input where few is a candidate. a heap of k would
+// be O(n log k) on descending input.
+
+// the least window, the selection of a smaller one is an insertion sort
+// and costs O(k) per dropped element
+const ::std::ptrdiff_t __partial_select_min_window = 64;
+
+template <bool Branchless, class RandomAccessIterator, class Compare>
+void __partial_select(RandomAccessIterator first,
+                      RandomAccessIterator middle, RandomAccessIterator last,
+                      Compare &comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  const difference_type k = middle - first;
+  if (k == 0) return;
+  const difference_type window = 2 * k > __partial_select_min_window
+                                     ? 2 * k
+                                     : __partial_select_min_window;
+  if (last - first > window) {
+    RandomAccessIterator kth = middle - 1;
+    RandomAccessIterator window_end = first + window;
+    STL_NAME::__introselect<Branchless>(first, kth, window_end, comp,
+                                        __select_budget(window), true);
+    window_end = middle;
+    for (RandomAccessIterator iter = first + window; iter != last; ++iter) {
+      if (!comp(*iter, *kth)) continue;
+      ::std::iter_swap(window_end, iter);
+      if (++window_end - first == window) {
+        STL_NAME::__introselect<Branchless>(first, kth, window_end, comp,
+                                            __select_budget(window), true);
+        window_end = middle;
+      }
+    }
+    STL_NAME::__nth_element<Branchless>(first, kth, window_end, comp);
+  } else {
+    STL_NAME::__nth_element<Branchless>(first, middle, last, comp);
+  }
+}
+
+// >>> merge sort
+// move [first1, last1) and [first2, last2) merged to result, stable: the
+// element of the first range goes first among the equal ones
+template <class InputIterator1, class InputIterator2, class OutputIterator,
+          class Compare>
+OutputIterator __merge_move(InputIterator1 first1, InputIterator1 last1,
+                            InputIterator2 first2, InputIterator2 last2,
+                            OutputIterator result, Compare &comp) {
+  for (; first1 != last1; ++result) {
+    if (first2 == last2) return ::std::move(first1, last1, result);
+    if (comp(*first2, *first1)) {
+      *result = ::std::move(*first2);
+      ++first2;
+    } else {
+      *result = ::std::move(*first1);
+      ++first1;
+    }
+  }
+  return ::std::move(first2, last2, result);
+}
+
+// number of element of [first1, first1 + n1) among the first k of the
+// stable merge with [first2, first2 + n2), by binary search on the cross
+// diagonal k (merge path). the merge splits into independent parts there.
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class Compare>
+::std::size_t __merge_path(RandomAccessIterator1 first1, ::std::size_t n1,
+                           RandomAccessIterator2 first2, ::std::size_t n2,
+                           ::std::size_t k, Compare &comp) {
+  ::std::size_t lo = k > n2 ? k - n2 : 0;
+  ::std::size_t hi = k < n1 ? k : n1;
+  while (lo < hi) {
+    const ::std::size_t mid = lo + (hi - lo) / 2;
+    if (!comp(first2[k - mid - 1], first1[mid]))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// >>> powersort
+// stable sort by merging natural runs (Munro and Wild, as in CPython 3.11).
+// a run is the longest non-descending or strictly descending (then
+// reversed) prefix of the rest, a short one is extended to
+// __stable_sort_min_run by insertion sort. the boundary of two adjacent
+// runs has a power, its depth in the balanced merge tree of [0, n), and
+// the runs are merged deepest boundary first. the merge cost is within
+// O(n) of the best for the run lengths, a sorted input is a single run and
+// the time grows with how many runs the input has.
+// a merge moves the shorter run to a buffer and merges back into the
+// range, galloping (TimSort) while one run wins many times in a row. a
+// merge whose runs are both longer than the buffer is split in place by
+// rotation, O(n log^2 n) in total without a buffer.
+
+// run shorter than this is extended by insertion sort
+const ::std::ptrdiff_t __stable_sort_min_run = 32;
+// wins in a row after which a merge gallops, it adapts during a sort
+const ::std::ptrdiff_t __merge_min_gallop = 7;
+
+// comp with swapped arguments, a merge from the back is the merge from the
+// front of the reversed runs by it
+template <class Compare>
+struct __reverse_compare {
+  explicit __reverse_compare(Compare &comp) : comp_(comp) {}
+
+  template <class T, class U>
+  bool operator()(const T &lhs, const U &rhs) {
+    return comp_(rhs, lhs);
+  }
+
+  Compare &comp_;
+};
+
+// destroys the first n element from first at the end of its scope
+template <class T>
+struct __destruct_n {
+  ~__destruct_n() {
+    for (::std::size_t i = 0; i < n; ++i) first[i].~T();
+  }
+
+  T *first;
+  ::std::size_t n;
+};
+
+// length of the prefix of [first, first + len) where pred holds, pred is
+// true and then false. exponential search from first and then binary
+// search, O(log k) for a prefix of k.
+template <class BidirectionalIterator, class Predicate>
+::std::ptrdiff_t __gallop(BidirectionalIterator first, ::std::ptrdiff_t len,
+                          Predicate pred) {
+  ::std::ptrdiff_t lo = 0;
+  ::std::ptrdiff_t hi = 1;
+  while (hi <= len && pred(*::std::next(first, hi - 1))) {
+    lo = hi;
+    hi = 2 * hi + 1;
+  }
+  if (hi > len) hi = len;
+  while (lo < hi) {
+    const ::std::ptrdiff_t mid = lo + (hi - lo) / 2;
+    if (pred(*::std::next(first, mid)))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+// merge [a, a_last) in a buffer and [b, last) to out, which is before b.
+// return once a run runs out.
+template <class T, class BidirectionalIterator, class Compare>
+void __gallop_merge(T *&a, T *a_last, BidirectionalIterator &b,
+                    BidirectionalIterator last, BidirectionalIterator &out,
+                    Compare &comp, ::std::ptrdiff_t &min_gallop) {
+  for (;;) {
+    ::std::ptrdiff_t wins_a = 0;
+    ::std::ptrdiff_t wins_b = 0;
+    // one element at a time
+    do {
+      if (comp(*b, *a)) {
+        *out = ::std::move(*b);
+        ++out;
+        ++wins_b;
+        wins_a = 0;
+        if (++b == last) return;
+      } else {
+        *out = ::std::move(*a);
+        ++out;
+        ++wins_a;
+        wins_b = 0;
+        if (++a == a_last) return;
+      }
+    } while (wins_a < min_gallop && wins_b < min_gallop);
+
+    // a stretch at a time while a run keeps winning
+    do {
+      if (min_gallop > 1) --min_gallop;
+      wins_a = STL_NAME::__gallop(a, a_last - a,
+                                  [&](const T &x) { return !comp(*b, x); });
+      out = ::std::move(a, a + wins_a, out);
+      a += wins_a;
+      if (a == a_last) return;
+      *out = ::std::move(*b);
+      ++out;
+      if (++b == last) return;
+
+      wins_b = STL_NAME::__gallop(b, ::std::distance(b, last),
+                                  [&](const T &x) { return comp(x, *a); });
+      BidirectionalIterator b_end = ::std::next(b, wins_b);
+      out = ::std::move(b, b_end, out);
+      b = b_end;
+      if (b == last) return;
+      *out = ::std::move(*a);
+      ++out;
+      if (++a == a_last) return;
+    } while (wins_a >= __merge_min_gallop || wins_b >= __merge_min_gallop);
+    // galloping did not pay, it is harder to enter again
+    min_gallop += 2;
+  }
+}
+
+// merge [first, middle) and [middle, last) with the first run moved to
+// buf, of at least its length
+template <class BidirectionalIterator, class T, class Compare>
+void __merge_low(BidirectionalIterator first, BidirectionalIterator middle,
+                 BidirectionalIterator last, T *buf, Compare &comp,
+                 ::std::ptrdiff_t &min_gallop) {
+  __destruct_n<T> guard = {buf, 0};
+  for (BidirectionalIterator iter = first; iter != middle; ++iter, ++guard.n)
+    ::new (static_cast<void *>(buf + guard.n)) T(::std::move(*iter));
+  T *a = buf;
+  T *const a_last = buf + guard.n;
+  STL_NAME::__gallop_merge(a, a_last, middle, last, first, comp, min_gallop);
+  // the rest of the second run is in place already
+  ::std::move(a, a_last, first);
+}
+
+// merge [first, middle) of len1 and [middle, last) of len2 with buf of
+// buf_size element
+template <class BidirectionalIterator, class T, class Compare>
+void __merge_adaptive(BidirectionalIterator first,
+                      BidirectionalIterator middle,
+                      BidirectionalIterator last, ::std::ptrdiff_t len1,
+                      ::std::ptrdiff_t len2, T *buf,
+                      ::std::ptrdiff_t buf_size, Compare &comp,
+                      ::std::ptrdiff_t &min_gallop) {
+  for (;;) {
+    if (len1 == 0 || len2 == 0) return;
+    // the head of the first run not greater than the second and the tail of
+    // the second run not less than the first stay where they are
+    const ::std::ptrdiff_t head = STL_NAME::__gallop(
+        first, len1, [&](const T &x) { return !comp(*middle, x); });
+    ::std::advance(first, head);
+    len1 -= head;
+    if (len1 == 0) return;
+    const BidirectionalIterator back = ::std::prev(middle);
+    len2 = STL_NAME::__gallop(middle, len2,
+                              [&](const T &x) { return comp(x, *back); });
+    last = ::std::next(middle, len2);
+
+    if (len1 <= len2 && len1 <= buf_size) {
+      STL_NAME::__merge_low(first, middle, last, buf, comp, min_gallop);
+      return;
+    }
+    if (len2 <= buf_size) {
+      typedef ::std::reverse_iterator<BidirectionalIterator> reverse_iterator;
+      __reverse_compare<Compare> reverse_comp(comp);
+      STL_NAME::__merge_low(reverse_iterator(last), reverse_iterator(middle),
+                            reverse_iterator(first), buf, reverse_comp,
+                            min_gallop);
+      return;
+    }
+
+    // cut the longer run at its half and the other one at the same value,
+    // swap the two inner parts by rotation, then merge either side. the
+    // smaller side recurses, the larger one loops.
+    BidirectionalIterator cut1;
+    BidirectionalIterator cut2;
+    ::std::ptrdiff_t len11;
+    ::std::ptrdiff_t len21;
+    if (len1 < len2) {
+      len21 = len2 / 2;
+      cut2 = ::std::next(middle, len21);
+      cut1 = ::std::upper_bound(first, middle, *cut2, comp);
+      len11 = ::std::distance(first, cut1);
+    } else {
+      len11 = len1 / 2;
+      cut1 = ::std::next(first, len11);
+      cut2 = ::std::lower_bound(middle, last, *cut1, comp);
+      len21 = ::std::distance(middle, cut2);
+    }
+    const ::std::ptrdiff_t len12 = len1 - len11;
+    const ::std::ptrdiff_t len22 = len2 - len21;
+    const BidirectionalIterator new_middle = ::std::rotate(cut1, middle, cut2);
+    if (len11 + len21 < len12 + len22) {
+      STL_NAME::__merge_adaptive(first, cut1, new_middle, len11, len21, buf,
+                                 buf_size, comp, min_gallop);
+      first = new_middle;
+      middle = cut2;
+      len1 = len12;
+      len2 = len22;
+    } else {
+      STL_NAME::__merge_adaptive(new_middle, cut2, last, len12, len22, buf,
+                                 buf_size, comp, min_gallop);
+      last = new_middle;
+      middle = cut1;
+      len1 = len11;
+      len2 = len21;
+    }
+  }
+}
+
+// length of the natural run at first, a strictly descending one is
+// reversed, it keeps equal element in order
+template <class RandomAccessIterator, class Compare>
+::std::ptrdiff_t __natural_run(RandomAccessIterator first,
+                               RandomAccessIterator last, Compare &comp) {
+  RandomAccessIterator iter = first + 1;
+  if (iter == last) return 1;
+  if (comp(*iter, *first)) {
+    while (++iter != last && comp(*iter, *(iter - 1))) {
+    }
+    ::std::reverse(first, iter);
+  } else {
+    while (++iter != last && !comp(*iter, *(iter - 1))) {
+    }
+  }
+  return iter - first;
+}
+
+// power of the boundary between the run [begin1, begin1 + len1) and the
+// next run of len2 in [0, n): the first bit after the binary point where
+// the midpoints of the two runs, as fractions of n, differ
+inline int __powersort_power(::std::ptrdiff_t begin1, ::std::ptrdiff_t len1,
+                             ::std::ptrdiff_t len2, ::std::ptrdiff_t n) {
+  // twice the midpoints, twice n is 1
+  ::std::ptrdiff_t a = 2 * begin1 + len1;
+  ::std::ptrdiff_t b = a + len1 + len2;
+  int power = 0;
+  for (;;) {
+    ++power;
+    if (a >= n) {
+      a -= n;
+      b -= n;
+    } else if (b >= n) {
+      return power;
+    }
+    a <<= 1;
+    b <<= 1;
+  }
+}
+
+// run on the powersort stack, power is that of its boundary with the next
+// run
+struct __powersort_run {
+  ::std::ptrdiff_t begin;
+  ::std::ptrdiff_t len;
+  int power;
+};
+
+// merge the top two runs of the stack
+template <class RandomAccessIterator, class T, class Compare>
+void __powersort_merge(RandomAccessIterator first, __powersort_run *stack,
+                       int &top, T *buf, ::std::ptrdiff_t buf_size,
+                       Compare &comp, ::std::ptrdiff_t &min_gallop) {
+  __powersort_run &lhs = stack[top - 2];
+  const __powersort_run &rhs = stack[top - 1];
+  STL_NAME::__merge_adaptive(first + lhs.begin, first + rhs.begin,
+                             first + (rhs.begin + rhs.len), lhs.len, rhs.len,
+                             buf, buf_size, comp, min_gallop);
+  lhs.len += rhs.len;
+  --top;
+}
+
+// stable sort of [first, last) with buf of buf_size uninitialized element,
+// no rotation is needed from half of the length on
+template <class RandomAccessIterator, class T, class Compare>
+void __powersort(RandomAccessIterator first, RandomAccessIterator last,
+                 Compare &comp, T *buf, ::std::ptrdiff_t buf_size) {
+  const ::std::ptrdiff_t n = last - first;
+  if (n < 2) return;
+  // the power increases along the stack and is at most 64
+  __powersort_run stack[66];
+  int top = 0;
+  ::std::ptrdiff_t min_gallop = __merge_min_gallop;
+  for (::std::ptrdiff_t begin = 0; begin < n;) {
+    ::std::ptrdiff_t len =
+        STL_NAME::__natural_run(first + begin, last, comp);
+    if (len < __stable_sort_min_run) {
+      len = n - begin < __stable_sort_min_run ? n - begin
+                                               : __stable_sort_min_run;
+      STL_NAME::__insertion_sort(first + begin, first + (begin + len), comp);
+    }
+    if (top > 0) {
+      const int power = STL_NAME::__powersort_power(
+          stack[top - 1].begin, stack[top - 1].len, len, n);
+      while (top > 1 && stack[top - 2].power > power)
+        STL_NAME::__powersort_merge(first, stack, top, buf, buf_size, comp,
+                                    min_gallop);
+      stack[top - 1].power = power;
+    }
+    stack[top].begin = begin;
+    stack[top].len = len;
+    ++top;
+    begin += len;
+  }
+  while (top > 1)
+    STL_NAME::__powersort_merge(first, stack, top, buf, buf_size, comp,
+                                min_gallop);
+}
+
+// >>> radix sort
+// radix sort, stable. a key is mapped to an unsigned integer of the same
+// order and sorted by 11-bit digit (8-bit for a key of 16 bits or less).
+// one pass counts every digit of every key, a digit the same for every key
+// is skipped. the digits are sorted by LSD from the lowest, element is
+// moved between the range and a buffer of the same size once per digit.
+// a large input sorts the highest digit first (MSD) until every bucket is
+// small enough for the cache and sorted by LSD of the lower digits, the
+// scatter of a whole-range LSD pass would miss the cache and TLB on almost
+// every element.
+
+// order preserving map of key to unsigned integer, unsupported key has no
+// unsigned_type
+template <class T, class = void>
+struct __radix_traits {};
+
+template <>
+struct __radix_traits<bool, void> {
+  typedef unsigned char unsigned_type;
+  static unsigned_type encode(bool x) { return x; }
+};
+
+// signed integer flips the sign bit
+template <class T>
+struct __radix_traits<
+    T, typename enable_if<::std::is_integral<T>::value &&
+                              !::std::is_same<T, bool>::value,
+                          void>::type> {
+  typedef typename ::std::make_unsigned<T>::type unsigned_type;
+  static unsigned_type encode(T x) {
+    const unsigned_type sign =
+        ::std::is_signed<T>::value
+            ? static_cast<unsigned_type>(static_cast<unsigned_type>(1)
+                                         << (sizeof(T) * 8 - 1))
+            : static_cast<unsigned_type>(0);
+    return static_cast<unsigned_type>(static_cast<unsigned_type>(x) ^ sign);
+  }
+};
+
+// IEEE 754 value flips the sign bit of positive value and every bit of
+// negative value. -0.0 goes before 0.0, NaN goes to either end by its sign.
+template <class T>
+struct __radix_traits<
+    T, typename enable_if<::std::is_floating_point<T>::value &&
+                              ::std::numeric_limits<T>::is_iec559 &&
+                              (sizeof(T) == 4 || sizeof(T) == 8),
+                          void>::type> {
+  typedef typename ::std::conditional<sizeof(T) == 4, ::std::uint32_t,
+                                      ::std::uint64_t>::type unsigned_type;
+  static unsigned_type encode(T x) {
+    const ::std::size_t top = sizeof(T) * 8 - 1;
+    unsigned_type bits;
+    ::std::memcpy(&bits, &x, sizeof(T));
+    const unsigned_type mask = static_cast<unsigned_type>(0 - (bits >> top)) |
+                               (static_cast<unsigned_type>(1) << top);
+    return bits ^ mask;
+  }
+};
+
+template <class T, class = void>
+struct __is_radix_key : false_type {};
+
+template <class T>
+struct __is_radix_key<T, void_t<typename __radix_traits<T>::unsigned_type>>
+    : true_type {};
+
+// key of radix_sort without key function
+struct __radix_identity {
+  template <class T>
+  const T &operator()(const T &x) const {
+    return x;
+  }
+};
+
+// digit of unsigned key U
+template <class U>
+struct __radix_digit {
+  static const ::std::size_t bits = sizeof(U) <= 2 ? 8 : 11;
+  static const ::std::size_t buckets = ::std::size_t(1) << bits;
+  static const ::std::size_t count = (sizeof(U) * 8 + bits - 1) / bits;
+
+  static ::std::size_t get(U u, ::std::size_t d) {
+    return static_cast<::std::size_t>(u >> (d * bits)) & (buckets - 1);
+  }
+};
+
+// size under which insertion sort is used, it is stable too
+const ::std::ptrdiff_t __radix_insertion_threshold = 64;
+// byte of input from which the highest digit is sorted first
+const ::std::size_t __radix_msd_threshold = ::std::size_t(1) << 20;
+
+// count the lowest num_digits digit of n key of in. the count of a digit
+// that needs a pass is made into the offset of every bucket, the digit is
+// written to passes from low to high. return the number of such digit.
+template <class Traits, class InputIterator, class KeyFn>
+::std::size_t __radix_count(InputIterator in, ::std::size_t n,
+                            ::std::size_t num_digits, ::std::size_t *count,
+                            ::std::size_t *passes, KeyFn &key_fn) {
+  typedef __radix_digit<typename Traits::unsigned_type> radix_digit;
+  const ::std::size_t buckets = radix_digit::buckets;
+  ::std::fill(count, count + num_digits * buckets, ::std::size_t(0));
+  InputIterator iter = in;
+  for (::std::size_t i = 0; i < n; ++i, ++iter) {
+    const typename Traits::unsigned_type u = Traits::encode(key_fn(*iter));
+    for (::std::size_t d = 0; d < num_digits; ++d)
+      ++count[d * buckets + radix_digit::get(u, d)];
+  }
+  const typename Traits::unsigned_type u0 = Traits::encode(key_fn(*in));
+  ::std::size_t num_passes = 0;
+  for (::std::size_t d = 0; d < num_digits; ++d) {
+    ::std::size_t *offset = count + d * buckets;
+    if (offset[radix_digit::get(u0, d)] == n) continue;
+    ::std::size_t sum = 0;
+    for (::std::size_t b = 0; b < buckets; ++b) {
+      const ::std::size_t c = offset[b];
+      offset[b] = sum;
+      sum += c;
+    }
+    passes[num_passes++] = d;
+  }
+  return num_passes;
+}
+
+// move n element of in to out by digit d, offset is the next position of
+// every bucket
+template <class Traits, class InputIterator, class OutputIterator,
+          class KeyFn>
+void __radix_scatter(InputIterator in, ::std::size_t n, OutputIterator out,
+                     ::std::size_t *offset, ::std::size_t d, KeyFn &key_fn) {
+  typedef __radix_digit<typename Traits::unsigned_type> radix_digit;
+  for (::std::size_t i = 0; i < n; ++i, ++in)
+    out[offset[radix_digit::get(Traits::encode(key_fn(*in)), d)]++] =
+        ::std::move(*in);
+}
+
+// LSD pass of every digit in passes over n element, which is in buffer if
+// in_buffer or in range else. return whether the result is in buffer.
+template <class Traits, class RandomAccessIterator, class T, class KeyFn>
+bool __radix_lsd(RandomAccessIterator range, T *buffer, ::std::size_t n,
+                 ::std::size_t *count, const ::std::size_t *passes,
+                 ::std::size_t num_passes, bool in_buffer, KeyFn &key_fn) {
+  typedef __radix_digit<typename Traits::unsigned_type> radix_digit;
+  for (::std::size_t i = 0; i < num_passes; ++i) {
+    const ::std::size_t d = passes[i];
+    ::std::size_t *offset = count + d * radix_digit::buckets;
+    if (in_buffer)
+      STL_NAME::__radix_scatter<Traits>(buffer, n, range, offset, d, key_fn);
+    else
+      STL_NAME::__radix_scatter<Traits>(range, n, buffer, offset, d, key_fn);
+    in_buffer = !in_buffer;
+  }
+  return in_buffer;
+}
+
+// sort n element by the digits counted in count and passes, which is in
+// buffer if in_buffer or in range else. the result is in range.
+template <class Traits, class RandomAccessIterator, class T, class KeyFn,
+          class Compare>
+void __radix_sort_counted(RandomAccessIterator range, T *buffer,
+                          ::std::size_t n, ::std::size_t *count,
+                          const ::std::size_t *passes,
+                          ::std::size_t num_passes, bool in_buffer,
+                          KeyFn &key_fn, Compare &comp) {
+  typedef __radix_digit<typename Traits::unsigned_type> radix_digit;
+  const ::std::size_t buckets = radix_digit::buckets;
+  if (num_passes <= 1 || n * sizeof(T) < __radix_msd_threshold) {
+    if (STL_NAME::__radix_lsd<Traits>(range, buffer, n, count, passes,
+                                      num_passes, in_buffer, key_fn))
+      ::std::move(buffer, buffer + n, range);
+    return;
+  }
+
+  // MSD pass of the highest digit, every bucket is sorted alone by the
+  // lower digits, a bucket still too large sorts its highest digit first
+  const ::std::size_t top = passes[num_passes - 1];
+  ::std::size_t bounds[buckets + 1];
+  ::std::copy(count + top * buckets, count + (top + 1) * buckets, bounds);
+  bounds[buckets] = n;
+  in_buffer = STL_NAME::__radix_lsd<Traits>(range, buffer, n, count, &top, 1,
+                                            in_buffer, key_fn);
+  ::std::size_t sub_passes[radix_digit::count];
+  for (::std::size_t b = 0; b < buckets; ++b) {
+    const ::std::size_t m = bounds[b + 1] - bounds[b];
+    if (m == 0) continue;
+    RandomAccessIterator sub_range = range + bounds[b];
+    T *sub_buffer = buffer + bounds[b];
+    if (static_cast<::std::ptrdiff_t>(m) < __radix_insertion_threshold) {
+      if (in_buffer) ::std::move(sub_buffer, sub_buffer + m, sub_range);
+      STL_NAME::__insertion_sort(sub_range, sub_range + m, comp);
+      continue;
+    }
+    const ::std::size_t num_sub_passes =
+        in_buffer ? STL_NAME::__radix_count<Traits>(
+                        sub_buffer, m, top, count, sub_passes, key_fn)
+                  : STL_NAME::__radix_count<Traits>(
+                        sub_range, m, top, count, sub_passes, key_fn);
+    STL_NAME::__radix_sort_counted<Traits>(sub_range, sub_buffer, m, count,
+                                           sub_passes, num_sub_passes,
+                                           in_buffer, key_fn, comp);
+  }
+}
+
+template <class RandomAccessIterator, class KeyFn>
+void __radix_sort(RandomAccessIterator first, RandomAccessIterator last,
+                  KeyFn &key_fn) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+  typedef typename ::std::decay<decltype(key_fn(*first))>::type key_type;
+  typedef __radix_traits<key_type> traits;
+  typedef __radix_digit<typename traits::unsigned_type> radix_digit;
+  const ::std::size_t digits = radix_digit::count;
+  static_assert(is_nothrow_move_constructible<value_type>::value,
+                "radix_sort needs nothrow move constructor");
+
+  auto comp = [&key_fn](const value_type &lhs, const value_type &rhs) {
+    return traits::encode(key_fn(lhs)) < traits::encode(key_fn(rhs));
+  };
+  if (last - first < __radix_insertion_threshold) {
+    STL_NAME::__insertion_sort(first, last, comp);
+    return;
+  }
+  const ::std::size_t n = static_cast<::std::size_t>(last - first);
+
+  ::std::size_t count[digits * radix_digit::buckets];
+  ::std::size_t passes[digits];
+  const ::std::size_t num_passes = STL_NAME::__radix_count<traits>(
+      first, n, digits, count, passes, key_fn);
+  if (num_passes == 0) return;
+
+  // trivially copyable value is assigned to the raw buffer, other value is
+  // moved into the buffer first, every element stays alive if key_fn throws
+  __temporary_buffer<value_type> buffer(n);
+  bool in_buffer = false;
+  if (!::std::is_trivially_copyable<value_type>::value) {
+    for (RandomAccessIterator iter = first; iter != last;
+         ++iter, ++buffer.constructed)
+      __temporary_buffer<value_type>::alloc_traits::construct(
+          buffer.alloc, buffer.data + buffer.constructed, ::std::move(*iter));
+    in_buffer = true;
+  }
+  STL_NAME::__radix_sort_counted<traits>(first, buffer.data, n, count, passes,
+                                         num_passes, in_buffer, key_fn, comp);
+}
+
+STL_END
+
+#endif  // !_SORT_H__
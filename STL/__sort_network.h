@@ -0,0 +1,277 @@
+#ifndef _SORT_NETWORK_H__
+#define _SORT_NETWORK_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include "Def/stldef.h"
+
+// vectorized sorting network of at most 64 key of 32 bits, for sort_small
+// and the small partition of sort.
+// the key is mapped to int32_t of the same order, padded with INT32_MAX
+// to a power of 2 and sorted by a bitonic network in vector register: a
+// stride of a register or more compares whole register, a smaller stride
+// shuffles lane in a register. the network is written once with vector
+// extension of gcc and clang and compiled for AVX-512 (16 lane), AVX2 (8
+// lane) and SSE2 (4 lane), the best one supported by CPUID is chosen on
+// the first call.
+#if defined(__x86_64__) && (defined(__clang__) || __GNUC__ >= 12)
+#define __STL_SORT_NETWORK
+#endif
+
+#define __STL_NETWORK_INLINE inline __attribute__((always_inline))
+
+STL_BEGIN
+
+// the most key sorted by the network
+const ::std::size_t __sort_network_max = 64;
+
+// map of key to int32_t, encode is its own inverse. a float is ordered by
+// its bits with every bit but the sign flipped if negative, -0.0 goes
+// before 0.0 and NaN goes to either end by its sign.
+template <class T, class = void>
+struct __network_traits {};
+
+template <class T>
+struct __network_traits<
+    T, typename enable_if<::std::is_integral<T>::value &&
+                              ::std::is_signed<T>::value && sizeof(T) == 4,
+                          void>::type> {
+  template <class V>
+  static __STL_NETWORK_INLINE void encode(V &) {}
+};
+
+template <class T>
+struct __network_traits<
+    T, typename enable_if<::std::is_integral<T>::value &&
+                              ::std::is_unsigned<T>::value && sizeof(T) == 4,
+                          void>::type> {
+  template <class V>
+  static __STL_NETWORK_INLINE void encode(V &v) {
+    v ^= ::std::numeric_limits<::std::int32_t>::min();
+  }
+};
+
+template <class T>
+struct __network_traits<
+    T, typename enable_if<::std::is_same<T, float>::value &&
+                              ::std::numeric_limits<T>::is_iec559,
+                          void>::type> {
+  template <class V>
+  static __STL_NETWORK_INLINE void encode(V &v) {
+    v ^= (v >> 31) & ::std::numeric_limits<::std::int32_t>::max();
+  }
+};
+
+// T is sorted by the network
+template <class T, class = void>
+struct __is_network_key : false_type {};
+
+#ifdef __STL_SORT_NETWORK
+template <class T>
+struct __is_network_key<
+    T, void_t<decltype(&__network_traits<T>::template encode<::std::int32_t>)>>
+    : true_type {};
+
+// bitonic network of N key in N / W register of W lane. merge of block K
+// compares every key with its mirror in the block, then every key with
+// the one K / 4, K / 8 ... 1 after it in half of the block.
+template <::std::size_t W, ::std::size_t N>
+struct __bitonic_network {
+  typedef ::std::int32_t vector_type
+      __attribute__((vector_size(W * sizeof(::std::int32_t))));
+  typedef ::std::make_index_sequence<W> lanes;
+  static const ::std::size_t registers = N / W;
+
+  static __STL_NETWORK_INLINE void sort(vector_type *r) {
+    merge<2>(r, true_type());
+  }
+
+ private:
+  static __STL_NETWORK_INLINE void compare_exchange(vector_type &a,
+                                                    vector_type &b) {
+    const vector_type lo = b < a ? b : a;
+    b = b < a ? a : b;
+    a = lo;
+  }
+
+  template <::std::size_t... I>
+  static __STL_NETWORK_INLINE void reverse(vector_type &v,
+                                           ::std::index_sequence<I...>) {
+    v = __builtin_shufflevector(v, v, (I ^ (W - 1))...);
+  }
+
+  // lane i and i ^ M of v, the larger one goes to the lane with bit J set
+  template <::std::size_t M, ::std::size_t J, ::std::size_t... I>
+  static __STL_NETWORK_INLINE void compare_lanes(vector_type &v,
+                                                 ::std::index_sequence<I...>) {
+    const vector_type t = __builtin_shufflevector(v, v, (I ^ M)...);
+    const vector_type lo = t < v ? t : v;
+    const vector_type hi = t < v ? v : t;
+    v = __builtin_shufflevector(lo, hi, ((I & J) ? I + W : I)...);
+  }
+
+  // block of K in a register
+  template <::std::size_t K>
+  static __STL_NETWORK_INLINE void mirror(vector_type *r, true_type) {
+    for (::std::size_t p = 0; p < registers; ++p)
+      compare_lanes<K - 1, K / 2>(r[p], lanes());
+  }
+
+  template <::std::size_t K>
+  static __STL_NETWORK_INLINE void mirror(vector_type *r, false_type) {
+    const ::std::size_t block = K / W;
+    for (::std::size_t b = 0; b < registers; b += block) {
+      for (::std::size_t p = 0; p < block / 2; ++p) {
+        vector_type &hi = r[b + block - 1 - p];
+        reverse(hi, lanes());
+        compare_exchange(r[b + p], hi);
+        reverse(hi, lanes());
+      }
+    }
+  }
+
+  // stride J in a register
+  template <::std::size_t J>
+  static __STL_NETWORK_INLINE void half_clean(vector_type *r, true_type) {
+    for (::std::size_t p = 0; p < registers; ++p)
+      compare_lanes<J, J>(r[p], lanes());
+  }
+
+  template <::std::size_t J>
+  static __STL_NETWORK_INLINE void half_clean(vector_type *r, false_type) {
+    const ::std::size_t stride = J / W;
+    for (::std::size_t p = 0; p < registers; ++p)
+      if (!(p & stride)) compare_exchange(r[p], r[p + stride]);
+  }
+
+  template <::std::size_t J>
+  static __STL_NETWORK_INLINE void clean(vector_type *r, true_type) {
+    half_clean<J>(r, integral_constant<bool, (J < W)>());
+    clean<J / 2>(r, integral_constant<bool, (J / 2 >= 1)>());
+  }
+
+  template <::std::size_t J>
+  static __STL_NETWORK_INLINE void clean(vector_type *, false_type) {}
+
+  template <::std::size_t K>
+  static __STL_NETWORK_INLINE void merge(vector_type *r, true_type) {
+    mirror<K>(r, integral_constant<bool, (K <= W)>());
+    clean<K / 4>(r, integral_constant<bool, (K / 4 >= 1)>());
+    merge<K * 2>(r, integral_constant<bool, (K * 2 <= N)>());
+  }
+
+  template <::std::size_t K>
+  static __STL_NETWORK_INLINE void merge(vector_type *, false_type) {}
+};
+
+// sort n <= N key at data by the network of N key
+template <class T, ::std::size_t W, ::std::size_t N>
+__STL_NETWORK_INLINE void __sort_network_run(T *data, ::std::size_t n) {
+  // an empty range may have no storage to copy
+  if (n < 2) return;
+  typedef __bitonic_network<W, N> network;
+  typedef __network_traits<T> traits;
+  typename network::vector_type r[network::registers];
+  ::std::int32_t pad = ::std::numeric_limits<::std::int32_t>::max();
+  traits::encode(pad);
+  ::std::int32_t keys[N];
+  ::std::memcpy(keys, data, n * sizeof(T));
+  for (::std::size_t i = n; i < N; ++i) keys[i] = pad;
+  ::std::memcpy(r, keys, sizeof(keys));
+  for (::std::size_t p = 0; p < network::registers; ++p) traits::encode(r[p]);
+  network::sort(r);
+  for (::std::size_t p = 0; p < network::registers; ++p) traits::encode(r[p]);
+  ::std::memcpy(keys, r, sizeof(keys));
+  ::std::memcpy(data, keys, n * sizeof(T));
+}
+
+template <class T, ::std::size_t W, ::std::size_t N>
+__STL_NETWORK_INLINE void __sort_network_size(T *, ::std::size_t, false_type) {
+}
+
+// the smallest network of N key from N on for n key
+template <class T, ::std::size_t W, ::std::size_t N>
+__STL_NETWORK_INLINE void __sort_network_size(T *data, ::std::size_t n,
+                                              true_type) {
+  if (n <= N)
+    STL_NAME::__sort_network_run<T, W, N>(data, n);
+  else
+    STL_NAME::__sort_network_size<T, W, N * 2>(
+        data, n, integral_constant<bool, (N * 2 <= __sort_network_max)>());
+}
+
+template <class T>
+__attribute__((target("avx512f"))) void __sort_network_avx512(
+    T *data, ::std::size_t n) {
+  STL_NAME::__sort_network_size<T, 16, 16>(data, n, true_type());
+}
+
+template <class T>
+__attribute__((target("avx2"))) void __sort_network_avx2(T *data,
+                                                         ::std::size_t n) {
+  STL_NAME::__sort_network_size<T, 8, 8>(data, n, true_type());
+}
+
+template <class T>
+void __sort_network_sse2(T *data, ::std::size_t n) {
+  STL_NAME::__sort_network_size<T, 4, 4>(data, n, true_type());
+}
+
+template <class T>
+struct __sort_network_kernel {
+  typedef void (*type)(T *, ::std::size_t);
+
+  static type select() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return &__sort_network_avx512<T>;
+    if (__builtin_cpu_supports("avx2")) return &__sort_network_avx2<T>;
+    return &__sort_network_sse2<T>;
+  }
+};
+
+// sort n <= __sort_network_max key at data ascending
+template <class T>
+void __sort_network_pointer(T *data, ::std::size_t n) {
+  static const typename __sort_network_kernel<T>::type kernel =
+      __sort_network_kernel<T>::select();
+  kernel(data, n);
+}
+
+template <class RandomAccessIterator>
+void __sort_network(RandomAccessIterator first, RandomAccessIterator last,
+                    true_type) {
+  STL_NAME::__sort_network_pointer(
+      first, static_cast<::std::size_t>(last - first));
+}
+
+// other iterator sorts a copy
+template <class RandomAccessIterator>
+void __sort_network(RandomAccessIterator first, RandomAccessIterator last,
+                    false_type) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+  value_type keys[__sort_network_max];
+  const ::std::size_t n = static_cast<::std::size_t>(last - first);
+  ::std::copy(first, last, keys);
+  STL_NAME::__sort_network_pointer(keys, n);
+  ::std::copy(keys, keys + n, first);
+}
+
+// sort [first, last) of at most __sort_network_max network key ascending
+template <class RandomAccessIterator>
+void __sort_network(RandomAccessIterator first, RandomAccessIterator last) {
+  STL_NAME::__sort_network(
+      first, last,
+      ::std::is_pointer<RandomAccessIterator>());
+}
+#endif  // __STL_SORT_NETWORK
+
+STL_END
+
+#undef __STL_NETWORK_INLINE
+
+#endif  // !_SORT_NETWORK_H__
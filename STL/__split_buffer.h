@@ -37,6 +37,8 @@ struct __split_buffer {
 
   explicit __split_buffer(allocator_remove_reference_type_ &alloc);
 
+  explicit __split_buffer(const allocator_remove_reference_type_ &alloc);
+
   explicit __split_buffer(size_type cap, size_type start,
                           allocator_remove_reference_type_ &alloc);
 
@@ -115,6 +117,15 @@ struct __split_buffer {
 
   void swap(__split_buffer &x) noexcept;
 
+  // swap storage only, x may share the allocator of *this by reference
+  template <class Alloc>
+  void swap_storage_(__split_buffer<value_type, Alloc> &x) noexcept {
+    std::swap(this->storage_, x.storage_);
+    std::swap(this->begin_, x.begin_);
+    std::swap(this->end_, x.end_);
+    std::swap(this->cap_, x.cap_);
+  }
+
   // >>> auxiliary function
 
   // construct element at end without capacity check
@@ -272,6 +283,15 @@ __split_buffer<T, Allocator>::__split_buffer(
       cap_(nullptr),
       alloc_(alloc) {}
 
+template <class T, class Allocator>
+__split_buffer<T, Allocator>::__split_buffer(
+    const allocator_remove_reference_type_ &alloc)
+    : storage_(nullptr),
+      begin_(nullptr),
+      end_(nullptr),
+      cap_(nullptr),
+      alloc_(alloc) {}
+
 template <class T, class Allocator>
 __split_buffer<T, Allocator>::__split_buffer(__split_buffer &&x) noexcept(
     std::is_nothrow_move_constructible<allocator_type>::value)
@@ -291,8 +311,8 @@ __split_buffer<T, Allocator>::__split_buffer(
       end_(nullptr),
       cap_(nullptr),
       alloc_(alloc) {
-  if (x.alloc == alloc_) {
-    // handover content block pointer if x.alloc == alloc_
+  if (x.alloc_ == alloc_) {
+    // handover content block pointer if x.alloc_ == alloc_
     this->storage_ = x.storage_;
     this->begin_ = x.begin_;
     this->end_ = x.end_;
@@ -337,10 +357,7 @@ __split_buffer<T, Allocator> &__split_buffer<T, Allocator>::operator=(
 template <class T, class Allocator>
 void __split_buffer<T, Allocator>::swap(__split_buffer &x) noexcept
 {
-  std::swap(this->storage_, x.storage_);
-  std::swap(this->begin_, x.begin_);
-  std::swap(this->end_, x.end_);
-  std::swap(this->cap_, x.cap_);
+  swap_storage_(x);
   __swap_allocator(this->alloc_, x.alloc_);
 }
 
@@ -353,7 +370,7 @@ void __split_buffer<T, Allocator>::reserve(size_type n) {
     for (pointer p = this->begin_; p != this->end_; ++p, ++swap_buffer.end_)
       alloc_traits_::construct(this->alloc_, __to_raw_pointer(swap_buffer.end_),
                                std::move_if_noexcept(*p));
-    swap(swap_buffer);
+    swap_storage_(swap_buffer);
   }
 }
 
@@ -368,7 +385,7 @@ void __split_buffer<T, Allocator>::shrink_to_fit() noexcept {
         alloc_traits_::construct(this->alloc_,
                                  __to_raw_pointer(swap_buffer.end_),
                                  std::move_if_noexcept(*p));
-      swap(swap_buffer);
+      swap_storage_(swap_buffer);
     } catch (...) {
     }
   }
@@ -393,7 +410,7 @@ void __split_buffer<T, Allocator>::push_front(const value_type &x) {
           temp_buffer(new_cap, (new_cap + 3) / 4, this->alloc_);
       temp_buffer.construct_at_end_(std::move_iterator<iterator>(this->begin_),
                                     std::move_iterator<iterator>(this->end_));
-      swap(temp_buffer);
+      swap_storage_(temp_buffer);
     }
   }
   // push new element
@@ -420,7 +437,7 @@ void __split_buffer<T, Allocator>::push_front(value_type &&x) {
           temp_buffer(new_cap, (new_cap + 3) / 4, this->alloc_);
       temp_buffer.construct_at_end_(std::move_iterator<iterator>(this->begin_),
                                     std::move_iterator<iterator>(this->end_));
-      swap(temp_buffer);
+      swap_storage_(temp_buffer);
     }
   }
   // push new element
@@ -445,7 +462,7 @@ void __split_buffer<T, Allocator>::push_back(const value_type &x) {
           temp_buffer(new_cap, new_cap / 4, this->alloc_);
       temp_buffer.construct_at_end_(std::move_iterator<iterator>(this->begin_),
                                     std::move_iterator<iterator>(this->end_));
-      swap(temp_buffer);
+      swap_storage_(temp_buffer);
     }
   }
   alloc_traits_::construct(this->alloc_, __to_raw_pointer(this->end_), x);
@@ -468,7 +485,7 @@ void __split_buffer<T, Allocator>::push_back(value_type &&x) {
           temp_buffer(new_cap, new_cap / 4, this->alloc_);
       temp_buffer.construct_at_end_(std::move_iterator<iterator>(this->begin_),
                                     std::move_iterator<iterator>(this->end_));
-      swap(temp_buffer);
+      swap_storage_(temp_buffer);
     }
   }
   alloc_traits_::construct(this->alloc_, __to_raw_pointer(this->end_),
@@ -493,7 +510,7 @@ void __split_buffer<T, Allocator>::emplace_back(Args... args) {
           temp_buffer(new_cap, new_cap / 4, this->alloc_);
       temp_buffer.construct_at_end_(std::move_iterator<iterator>(this->begin_),
                                     std::move_iterator<iterator>(this->end_));
-      swap(temp_buffer);
+      swap_storage_(temp_buffer);
     }
   }
   alloc_traits_::construct(this->alloc_, __to_raw_pointer(this->end_),
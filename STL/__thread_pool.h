@@ -0,0 +1,286 @@
+#ifndef _THREAD_POOL_H__
+#define _THREAD_POOL_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include "Def/stldef.h"
+#include "__concurrency.h"
+#include "work_stealing_deque.h"
+
+STL_BEGIN
+
+// fork-join thread pool of parallel algorithm, do not use it directly.
+// every worker owns a work_stealing_deque of task, it pushes and pops its
+// own task at the bottom (LIFO, the smallest and hottest one), an idle
+// worker steals at the top of others (FIFO, the largest one). a thread out
+// of the pool pushes to a locked injection queue.
+// a task is on the stack of the thread forking it, which waits for it by
+// running other task until the join counter drops to 0. idle worker sleeps
+// on a futex once nothing is queued.
+// the pool has STL_NUM_THREADS (environment variable, read once) or
+// hardware_concurrency() threads counting the caller, so one fewer worker.
+
+// task of the pool, execute decrements the join counter of its fork, the
+// task may be destroyed by the forking thread right after it
+class __pool_task {
+ public:
+  explicit __pool_task(::std::atomic<::std::size_t> *join) noexcept
+      : join_(join) {}
+
+  void execute() noexcept {
+    run();
+    join_->fetch_sub(1, ::std::memory_order_release);
+  }
+
+ protected:
+  // an exception leaving a task calls terminate, as parallel algorithm of
+  // std does
+  virtual void run() noexcept = 0;
+
+  ~__pool_task() = default;
+
+ private:
+  ::std::atomic<::std::size_t> *join_;
+};
+
+class __thread_pool {
+ public:
+  static __thread_pool &instance() {
+    static __thread_pool pool(default_concurrency_());
+    return pool;
+  }
+
+  __thread_pool(const __thread_pool &) = delete;
+
+  __thread_pool &operator=(const __thread_pool &) = delete;
+
+  ~__thread_pool() {
+    stop_.store(true, ::std::memory_order_release);
+    event_.notify();
+    for (::std::size_t i = 0; i < num_workers_; ++i)
+      workers_[i].thread_.join();
+  }
+
+  // number of thread running task, the caller included
+  ::std::size_t concurrency() const noexcept { return num_workers_ + 1; }
+
+  // queue t, it runs in any thread of the pool or the one waiting for it
+  void spawn(__pool_task *t) {
+    const int self = self_();
+    if (self >= 0) {
+      workers_[self].deque_.push(t);
+    } else {
+      ::std::lock_guard<::std::mutex> lock(injector_mutex_);
+      injector_.push_back(t);
+      injector_size_.fetch_add(1, ::std::memory_order_relaxed);
+    }
+    queued_.fetch_add(1, ::std::memory_order_release);
+    event_.notify(1);
+  }
+
+  // run queued task until join is 0
+  void wait(::std::atomic<::std::size_t> &join) noexcept {
+    __backoff<> backoff;
+    while (join.load(::std::memory_order_acquire) != 0) {
+      if (run_one_(self_()))
+        backoff.reset();
+      else
+        backoff();
+    }
+  }
+
+ private:
+  struct alignas(__cache_line_size) worker_ {
+    work_stealing_deque<__pool_task *> deque_;
+    ::std::thread thread_;
+  };
+
+  explicit __thread_pool(::std::size_t concurrency)
+      : num_workers_(concurrency - 1),
+        workers_(num_workers_ ? new worker_[num_workers_] : nullptr),
+        queued_(0),
+        injector_size_(0),
+        stop_(false) {
+    for (::std::size_t i = 0; i < num_workers_; ++i)
+      workers_[i].thread_ =
+          ::std::thread(&__thread_pool::worker_loop_, this, static_cast<int>(i));
+  }
+
+  static ::std::size_t default_concurrency_() {
+    const char *env = ::std::getenv("STL_NUM_THREADS");
+    long n = env ? ::std::strtol(env, nullptr, 10) : 0;
+    if (n <= 0) n = static_cast<long>(::std::thread::hardware_concurrency());
+    return n > 0 ? static_cast<::std::size_t>(n) : 1;
+  }
+
+  // index of worker of the calling thread, -1 out of the pool
+  static int &self_() noexcept {
+    static thread_local int self = -1;
+    return self;
+  }
+
+  // take a task from the own deque, the injection queue or another worker
+  // and run it
+  bool run_one_(int self) noexcept {
+    __pool_task *t = nullptr;
+    if (!(self >= 0 && workers_[self].deque_.pop(t)) &&
+        !take_injected_(self, t) && !steal_(self, t))
+      return false;
+    queued_.fetch_sub(1, ::std::memory_order_relaxed);
+    t->execute();
+    return true;
+  }
+
+  // a worker takes the oldest task, a thread out of the pool takes the
+  // newest one like a worker does from its own deque, its own fork. taking
+  // the oldest one would run a task per stack frame in wait.
+  bool take_injected_(int self, __pool_task *&t) noexcept {
+    if (injector_size_.load(::std::memory_order_relaxed) == 0) return false;
+    ::std::lock_guard<::std::mutex> lock(injector_mutex_);
+    if (injector_.empty()) return false;
+    if (self >= 0) {
+      t = injector_.front();
+      injector_.pop_front();
+    } else {
+      t = injector_.back();
+      injector_.pop_back();
+    }
+    injector_size_.fetch_sub(1, ::std::memory_order_relaxed);
+    return true;
+  }
+
+  // try every other worker once, from a different one each time
+  bool steal_(int self, __pool_task *&t) noexcept {
+    if (num_workers_ == 0) return false;
+    static thread_local ::std::size_t next = 0;
+    const ::std::size_t start = next++;
+    for (::std::size_t k = 0; k < num_workers_; ++k) {
+      const ::std::size_t victim = (start + k) % num_workers_;
+      if (static_cast<int>(victim) == self) continue;
+      if (workers_[victim].deque_.steal(t)) return true;
+    }
+    return false;
+  }
+
+  void worker_loop_(int index) {
+    self_() = index;
+    for (;;) {
+      if (run_one_(index)) continue;
+      // spin a while before sleep, a fork is usually followed by more
+      for (int i = 0; i < 256 && !has_work_(); ++i) __cpu_relax();
+      if (!has_work_())
+        event_.wait([this]() noexcept { return has_work_(); });
+      if (stop_.load(::std::memory_order_acquire)) return;
+    }
+  }
+
+  bool has_work_() const noexcept {
+    return queued_.load(::std::memory_order_acquire) > 0 ||
+           stop_.load(::std::memory_order_acquire);
+  }
+
+  const ::std::size_t num_workers_;
+  ::std::unique_ptr<worker_[]> workers_;
+  // task pushed but not taken yet, only a hint for idle worker, it is
+  // negative for a while if a task is taken before its push is counted
+  alignas(__cache_line_size)::std::atomic<::std::ptrdiff_t> queued_;
+  alignas(__cache_line_size)::std::atomic<::std::size_t> injector_size_;
+  ::std::mutex injector_mutex_;
+  ::std::deque<__pool_task *> injector_;
+  ::std::atomic<bool> stop_;
+  __futex_event event_;
+};
+
+// task running f(begin, end) on a part of an index range
+template <class Function>
+class __parallel_for_task;
+
+// call f(begin, end) on disjoint parts of [begin, end) of at most grain
+// index each, in parallel. the right half is forked until the rest is one
+// grain, a stolen half is split again by the thief.
+template <class Function>
+void __parallel_for_range(__thread_pool &pool, ::std::size_t begin,
+                          ::std::size_t end, ::std::size_t grain,
+                          Function &f) noexcept {
+  typedef __parallel_for_task<Function> task_type;
+  // a split halves the range, 64 are enough for any size
+  typename ::std::aligned_storage<sizeof(task_type),
+                                  alignof(task_type)>::type tasks[64];
+  ::std::atomic<::std::size_t> join(0);
+  ::std::size_t forked = 0;
+  while (end - begin > grain) {
+    const ::std::size_t mid = begin + (end - begin) / 2;
+    task_type *t = ::new (static_cast<void *>(&tasks[forked]))
+        task_type(&join, pool, mid, end, grain, f);
+    ++forked;
+    join.fetch_add(1, ::std::memory_order_relaxed);
+    pool.spawn(t);
+    end = mid;
+  }
+  f(begin, end);
+  pool.wait(join);
+  for (::std::size_t i = 0; i < forked; ++i)
+    reinterpret_cast<task_type *>(&tasks[i])->~task_type();
+}
+
+template <class Function>
+class __parallel_for_task : public __pool_task {
+ public:
+  __parallel_for_task(::std::atomic<::std::size_t> *join, __thread_pool &pool,
+                      ::std::size_t begin, ::std::size_t end,
+                      ::std::size_t grain, Function &f) noexcept
+      : __pool_task(join),
+        pool_(pool),
+        begin_(begin),
+        end_(end),
+        grain_(grain),
+        f_(f) {}
+
+  ~__parallel_for_task() = default;
+
+ protected:
+  void run() noexcept override {
+    __parallel_for_range(pool_, begin_, end_, grain_, f_);
+  }
+
+ private:
+  __thread_pool &pool_;
+  ::std::size_t begin_;
+  ::std::size_t end_;
+  ::std::size_t grain_;
+  Function &f_;
+};
+
+// default grain, about 8 part a thread for load balance, but not less than
+// a few thousand index for the cost of fork and steal
+inline ::std::size_t __parallel_grain(::std::size_t n,
+                                      ::std::size_t concurrency) noexcept {
+  const ::std::size_t min_grain = 4096;
+  const ::std::size_t grain = n / (concurrency * 8);
+  return grain > min_grain ? grain : min_grain;
+}
+
+// f(begin, end) on [0, n) in parts of at most grain index, grain 0 is
+// chosen by n and the size of pool. return at once if n is 0.
+template <class Function>
+void __parallel_for(::std::size_t n, ::std::size_t grain, Function f) {
+  if (n == 0) return;
+  __thread_pool &pool = __thread_pool::instance();
+  if (grain == 0) grain = __parallel_grain(n, pool.concurrency());
+  if (pool.concurrency() == 1 || n <= grain) {
+    f(::std::size_t(0), n);
+    return;
+  }
+  __parallel_for_range(pool, 0, n, grain, f);
+}
+
+STL_END
+
+#endif  // !_THREAD_POOL_H__
@@ -1,7 +1,14 @@
 #ifndef _ALGORITHM_H__
 #define _ALGORITHM_H__
 
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include "Def/stldef.h"
+#include "__binary_search.h"
+#include "__heap.h"
+#include "__segmented_iterator.h"
+#include "__sort.h"
 
 STL_BEGIN
 
@@ -34,6 +41,78 @@ class __equal_to<const T, const T> {
   constexpr bool operator()(const T &lhs, const T &rhs) { return lhs == rhs; }
 };
 
+// less, default order of sorting and heap
+template <class T1, class T2 = T1>
+struct __less {
+  constexpr bool operator()(const T1 &lhs, const T2 &rhs) const {
+    return lhs < rhs;
+  }
+};
+
+// comp is the builtin < of T
+template <class T, class Compare>
+struct __is_builtin_less
+    : integral_constant<bool,
+                        ::std::is_same<Compare, __less<T>>::value ||
+                            ::std::is_same<Compare, ::std::less<T>>::value ||
+                            ::std::is_same<Compare, ::std::less<>>::value> {};
+
+// comp is the builtin < or > of an arithmetic type, the comparison is cheap
+// and branch-free partition pays for sort
+template <class T, class Compare>
+struct __is_arithmetic_order
+    : integral_constant<
+          bool, ::std::is_arithmetic<T>::value &&
+                    (__is_builtin_less<T, Compare>::value ||
+                     ::std::is_same<Compare, ::std::greater<T>>::value ||
+                     ::std::is_same<Compare, ::std::greater<>>::value)> {};
+
+// small range sorted by comp may go to the sorting network
+template <class T, class Compare>
+struct __is_network_order
+    : integral_constant<bool, __is_network_key<T>::value &&
+                                  __is_builtin_less<T, Compare>::value> {};
+
+// sort by comp may go to radix sort, it is opt-in by STL_SORT_RADIX since
+// radix sort allocates a buffer of the input size. a key of 64 bits needs
+// 6 digits, it is no faster than pdqsort.
+template <class T, class Compare>
+struct __is_radix_order
+    : integral_constant<bool,
+#ifdef STL_SORT_RADIX
+                        ::std::is_arithmetic<T>::value &&
+                            __is_radix_key<T>::value && sizeof(T) <= 4 &&
+                            __is_builtin_less<T, Compare>::value
+#else
+                        false
+#endif
+                        > {
+};
+
+// binary search of value in the range of Iterator by comp may go by
+// conditional move: random access to arithmetic element in memory, and the
+// builtin < or > of arithmetic type
+template <class Iterator, class T, class Compare>
+struct __is_branchless_search
+    : integral_constant<
+          bool,
+          ::std::is_base_of<
+              random_access_iterator_tag,
+              typename iterator_traits<Iterator>::iterator_category>::value &&
+              ::std::is_lvalue_reference<
+                  typename iterator_traits<Iterator>::reference>::value &&
+              ::std::is_arithmetic<T>::value &&
+              (::std::is_same<Compare,
+                              __less<typename iterator_traits<Iterator>::
+                                         value_type,
+                                     T>>::value ||
+               ::std::is_same<Compare,
+                              __less<T, typename iterator_traits<
+                                            Iterator>::value_type>>::value ||
+               __is_arithmetic_order<
+                   typename iterator_traits<Iterator>::value_type,
+                   Compare>::value)> {};
+
 };  // namespace algorithm_utility
 
 // >>> non-modifying sequence operations
@@ -64,19 +143,84 @@ bool none_of(InputIterator first, InputIterator last, Predicate pred) {
 
 // for_each
 template <class InputIterator, class Function>
-Function for_each(InputIterator first, InputIterator last, Function f) {
+Function __for_each(InputIterator first, InputIterator last, Function f,
+                    false_type) {
   for (; first != last; ++first) f(*first);
   return f;
 }
 
+// for segmented iterator, the same f is applied to every segment
+template <class Function>
+struct __for_each_segment_function {
+  template <class SegmentIterator, class LocalIterator>
+  bool operator()(SegmentIterator, LocalIterator first, LocalIterator last) {
+    __for_each<LocalIterator, Function &>(
+        first, last, f_,
+        typename __is_segmented_iterator<LocalIterator>::type());
+    return true;
+  }
+
+  Function &f_;
+};
+
+template <class SegmentedIterator, class Function>
+Function __for_each(SegmentedIterator first, SegmentedIterator last,
+                    Function f, true_type) {
+  __for_each_segment_function<Function> func{f};
+  if (first != last) __for_each_segment(first, last, func);
+  return f;
+}
+
+template <class InputIterator, class Function>
+Function for_each(InputIterator first, InputIterator last, Function f) {
+  return __for_each(first, last, ::std::move(f),
+                    typename __is_segmented_iterator<InputIterator>::type());
+}
+
 // find
 template <class InputIterator, class T>
-InputIterator find(InputIterator first, InputIterator last, const T &value) {
+InputIterator __find(InputIterator first, InputIterator last, const T &value,
+                     false_type) {
   for (; first != last; ++first)
     if (*first == value) return first;
   return last;
 }
 
+// for segmented iterator, stop at the first segment holding value
+template <class SegmentedIterator, class T>
+struct __find_segment_function {
+  typedef __segmented_iterator_traits<SegmentedIterator> traits_;
+  typedef typename traits_::segment_iterator segment_iterator_;
+  typedef typename traits_::local_iterator local_iterator_;
+
+  bool operator()(segment_iterator_ seg, local_iterator_ first,
+                  local_iterator_ last) {
+    local_iterator_ iter =
+        __find(first, last, value_,
+               typename __is_segmented_iterator<local_iterator_>::type());
+    if (iter == last) return true;
+    result_ = traits_::compose(seg, iter);
+    return false;
+  }
+
+  const T &value_;
+  SegmentedIterator result_;
+};
+
+template <class SegmentedIterator, class T>
+SegmentedIterator __find(SegmentedIterator first, SegmentedIterator last,
+                         const T &value, true_type) {
+  __find_segment_function<SegmentedIterator, T> func{value, last};
+  if (first != last) __for_each_segment(first, last, func);
+  return func.result_;
+}
+
+template <class InputIterator, class T>
+InputIterator find(InputIterator first, InputIterator last, const T &value) {
+  return __find(first, last, value,
+                typename __is_segmented_iterator<InputIterator>::type());
+}
+
 // find_if
 template <class InputIterator, class Predicate>
 InputIterator find_if(InputIterator first, InputIterator last, Predicate pred) {
@@ -251,19 +395,51 @@ ForwardIterator adjacent_find(ForwardIterator first, ForwardIterator last) {
 
 // count
 template <class InputIterator, class T>
-typename iterator_traits<InputIterator>::difference_type count(
-    InputIterator first, InputIterator last, const T &value) {
-  typename iterator_traits<InputIterator>::difference number = 0;
+typename iterator_traits<InputIterator>::difference_type __count(
+    InputIterator first, InputIterator last, const T &value, false_type) {
+  typename iterator_traits<InputIterator>::difference_type number = 0;
   for (; first != last; ++first)
     if (*first == value) ++number;
   return number;
 }
 
+// for segmented iterator, sum up count of every segment
+template <class DifferenceType, class T>
+struct __count_segment_function {
+  template <class SegmentIterator, class LocalIterator>
+  bool operator()(SegmentIterator, LocalIterator first, LocalIterator last) {
+    number_ += __count(first, last, value_,
+                       typename __is_segmented_iterator<LocalIterator>::type());
+    return true;
+  }
+
+  const T &value_;
+  DifferenceType number_;
+};
+
+template <class SegmentedIterator, class T>
+typename iterator_traits<SegmentedIterator>::difference_type __count(
+    SegmentedIterator first, SegmentedIterator last, const T &value,
+    true_type) {
+  __count_segment_function<
+      typename iterator_traits<SegmentedIterator>::difference_type, T>
+      func{value, 0};
+  if (first != last) __for_each_segment(first, last, func);
+  return func.number_;
+}
+
+template <class InputIterator, class T>
+typename iterator_traits<InputIterator>::difference_type count(
+    InputIterator first, InputIterator last, const T &value) {
+  return __count(first, last, value,
+                 typename __is_segmented_iterator<InputIterator>::type());
+}
+
 // count_if
 template <class InputIterator, class Predicate>
 typename iterator_traits<InputIterator>::difference_type count_if(
     InputIterator first, InputIterator last, Predicate pred) {
-  typename iterator_traits<InputIterator>::difference number = 0;
+  typename iterator_traits<InputIterator>::difference_type number = 0;
   for (; first != last; ++first)
     if (pred(*first)) ++number;
   return number;
@@ -411,9 +587,106 @@ ForwardIterator search_n(ForwardIterator first, ForwardIterator last,
 // modifying sequence operations:
 
 // copy:
+// neither range is segmented
+template <class InputIterator, class OutputIterator>
+OutputIterator __copy_plain(InputIterator first, InputIterator last,
+                            OutputIterator result) {
+  for (; first != last; ++first, ++result) *result = *first;
+  return result;
+}
+
+// trivially copyable element between pointers is copied by memmove
+template <class T, class U>
+typename enable_if<
+    ::std::is_same<typename ::std::remove_const<T>::type, U>::value &&
+        ::std::is_trivially_copy_assignable<U>::value,
+    U *>::type
+__copy_plain(T *first, T *last, U *result) {
+  const ::std::size_t n = static_cast<::std::size_t>(last - first);
+  if (n > 0) ::std::memmove(result, first, n * sizeof(U));
+  return result + n;
+}
+
+// source is segmented, copy segment by segment
+template <class OutputIterator>
+struct __copy_segment_function;
+
+template <class SegmentedIterator, class OutputIterator, class OutSegmented>
+OutputIterator __copy(SegmentedIterator first, SegmentedIterator last,
+                      OutputIterator result, true_type, OutSegmented) {
+  __copy_segment_function<OutputIterator> func{result};
+  if (first != last) __for_each_segment(first, last, func);
+  return func.result_;
+}
+
+// only destination is segmented
+// a random access source is cut to fit every destination segment
+template <class InputIterator, class SegmentedIterator>
+SegmentedIterator __copy_to_segment(InputIterator first, InputIterator last,
+                                    SegmentedIterator result,
+                                    input_iterator_tag) {
+  return __copy_plain(first, last, result);
+}
+
+template <class RandomAccessIterator, class SegmentedIterator>
+SegmentedIterator __copy_to_segment(RandomAccessIterator first,
+                                    RandomAccessIterator last,
+                                    SegmentedIterator result,
+                                    random_access_iterator_tag) {
+  typedef __segmented_iterator_traits<SegmentedIterator> traits;
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  if (first == last) return result;
+  typename traits::segment_iterator seg = traits::segment(result);
+  typename traits::local_iterator local = traits::local(result);
+  for (;;) {
+    difference_type n = last - first;
+    difference_type room = traits::end(seg) - local;
+    if (room < n) n = room;
+    local = __copy_plain(first, first + n, local);
+    first += n;
+    if (first == last) return traits::compose(seg, local);
+    ++seg;
+    local = traits::begin(seg);
+  }
+}
+
+template <class InputIterator, class SegmentedIterator>
+SegmentedIterator __copy(InputIterator first, InputIterator last,
+                         SegmentedIterator result, false_type, true_type) {
+  return __copy_to_segment(
+      first, last, result,
+      typename iterator_traits<InputIterator>::iterator_category());
+}
+
+template <class InputIterator, class OutputIterator>
+OutputIterator __copy(InputIterator first, InputIterator last,
+                      OutputIterator result, false_type, false_type) {
+  return __copy_plain(first, last, result);
+}
+
+// copy a segment of source, destination may be segmented too
+template <class OutputIterator>
+struct __copy_segment_function {
+  template <class SegmentIterator, class LocalIterator>
+  bool operator()(SegmentIterator, LocalIterator first, LocalIterator last) {
+    result_ = __copy(first, last, result_,
+                     typename __is_segmented_iterator<LocalIterator>::type(),
+                     typename __is_segmented_iterator<OutputIterator>::type());
+    return true;
+  }
+
+  OutputIterator result_;
+};
+
 template <class InputIterator, class OutputIterator>
 OutputIterator copy(InputIterator first, InputIterator last,
-                    OutputIterator result);
+                    OutputIterator result) {
+  return __copy(first, last, result,
+                typename __is_segmented_iterator<InputIterator>::type(),
+                typename __is_segmented_iterator<OutputIterator>::type());
+}
+
 template <class InputIterator, class Size, class OutputIterator>
 OutputIterator copy_n(InputIterator first, Size n, OutputIterator result);
 template <class InputIterator, class OutputIterator, class Predicate>
@@ -439,15 +712,23 @@ ForwardIterator2 swap_ranges(ForwardIterator1 first1, ForwardIterator1 last1,
                              ForwardIterator2 first2);
 template <class ForwardIterator1, class ForwardIterator2>
 void iter_swap(ForwardIterator1 a, ForwardIterator2 b);
+// transform:
 template <class InputIterator, class OutputIterator, class UnaryOperation>
 OutputIterator transform(InputIterator first, InputIterator last,
-                         OutputIterator result, UnaryOperation op);
+                         OutputIterator result, UnaryOperation op) {
+  for (; first != last; ++first, ++result) *result = op(*first);
+  return result;
+}
 
 template <class InputIterator1, class InputIterator2, class OutputIterator,
           class BinaryOperation>
 OutputIterator transform(InputIterator1 first1, InputIterator1 last1,
                          InputIterator2 first2, OutputIterator result,
-                         BinaryOperation binary_op);
+                         BinaryOperation binary_op) {
+  for (; first1 != last1; ++first1, ++first2, ++result)
+    *result = binary_op(*first1, *first2);
+  return result;
+}
 
 template <class ForwardIterator, class T>
 void replace(ForwardIterator first, ForwardIterator last, const T &old_value,
@@ -464,8 +745,39 @@ OutputIterator replace_copy_if(InputIterator first, InputIterator last,
                                OutputIterator result, Predicate pred,
                                const T &new_value);
 
+// fill:
+template <class ForwardIterator, class T>
+void __fill(ForwardIterator first, ForwardIterator last, const T &value,
+            false_type) {
+  for (; first != last; ++first) *first = value;
+}
+
+// for segmented iterator, fill segment by segment
+template <class T>
+struct __fill_segment_function {
+  template <class SegmentIterator, class LocalIterator>
+  bool operator()(SegmentIterator, LocalIterator first, LocalIterator last) {
+    __fill(first, last, value_,
+           typename __is_segmented_iterator<LocalIterator>::type());
+    return true;
+  }
+
+  const T &value_;
+};
+
+template <class SegmentedIterator, class T>
+void __fill(SegmentedIterator first, SegmentedIterator last, const T &value,
+            true_type) {
+  __fill_segment_function<T> func{value};
+  if (first != last) __for_each_segment(first, last, func);
+}
+
 template <class ForwardIterator, class T>
-void fill(ForwardIterator first, ForwardIterator last, const T &value);
+void fill(ForwardIterator first, ForwardIterator last, const T &value) {
+  __fill(first, last, value,
+         typename __is_segmented_iterator<ForwardIterator>::type());
+}
+
 template <class OutputIterator, class Size, class T>
 OutputIterator fill_n(OutputIterator first, Size n, const T &value);
 template <class ForwardIterator, class Generator>
@@ -548,32 +860,197 @@ ForwardIterator partition_point(ForwardIterator first, ForwardIterator last,
 // sorting and related operations:
 
 // sorting:
+// sort is pattern-defeating quicksort (__sort.h), O(n log n) in worst case,
+// linear on sorted and reverse input. builtin order of arithmetic type uses
+// the branch-free block partition, a small partition of builtin < of a key
+// of the sorting network is sorted by the network. with STL_SORT_RADIX
+// defined, builtin < of integer and float of 32 bits or less goes to
+// radix_sort on large input.
+template <class RandomAccessIterator, class Compare>
+void __sort(RandomAccessIterator first, RandomAccessIterator last,
+            Compare &comp, false_type) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::__pdqsort<
+      algorithm_utility::__is_arithmetic_order<type, Compare>::value,
+      algorithm_utility::__is_network_order<type, Compare>::value>(
+      first, last, comp);
+}
+
+// radix sort is faster from about 2048 element on
+template <class RandomAccessIterator, class Compare>
+void __sort(RandomAccessIterator first, RandomAccessIterator last,
+            Compare &comp, true_type) {
+  if (last - first < 2048) {
+    STL_NAME::__sort(first, last, comp, false_type());
+    return;
+  }
+  __radix_identity key;
+  STL_NAME::__radix_sort(first, last, key);
+}
+
+template <class RandomAccessIterator, class Compare>
+void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::__sort(first, last, comp,
+                   algorithm_utility::__is_radix_order<type, Compare>());
+}
+
 template <class RandomAccessIterator>
-void sort(RandomAccessIterator first, RandomAccessIterator last);
+void sort(RandomAccessIterator first, RandomAccessIterator last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::sort(first, last, algorithm_utility::__less<type>{});
+}
+
+// sort_small is for a range of a few dozen element. builtin < of int,
+// unsigned and float of 32 bits is sorted by the vectorized sorting network
+// (__sort_network.h) up to 64 element, for AVX-512, AVX2 or SSE2 by CPUID.
+// other range is sorted by sort.
+template <class RandomAccessIterator, class Compare>
+void __sort_small(RandomAccessIterator first, RandomAccessIterator last,
+                  Compare &comp, false_type) {
+  STL_NAME::sort(first, last, comp);
+}
+
+#ifdef __STL_SORT_NETWORK
 template <class RandomAccessIterator, class Compare>
-void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp);
+void __sort_small(RandomAccessIterator first, RandomAccessIterator last,
+                  Compare &comp, true_type) {
+  if (last - first <= static_cast<::std::ptrdiff_t>(__sort_network_max))
+    STL_NAME::__sort_network(first, last);
+  else
+    STL_NAME::sort(first, last, comp);
+}
+#endif
+
+template <class RandomAccessIterator, class Compare>
+void sort_small(RandomAccessIterator first, RandomAccessIterator last,
+                Compare comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::__sort_small(
+      first, last, comp,
+      algorithm_utility::__is_network_order<type, Compare>());
+}
 
 template <class RandomAccessIterator>
-void stable_sort(RandomAccessIterator first, RandomAccessIterator last);
+void sort_small(RandomAccessIterator first, RandomAccessIterator last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::sort_small(first, last, algorithm_utility::__less<type>{});
+}
+
+// radix_sort sorts ascending by key_fn(element), which is an integer or a
+// float/double, stable. radix sort of 11-bit digit (__sort.h), O(n) for a
+// fixed key width, allocates a buffer of the input size. without key_fn,
+// the element is the key. element needs a nothrow move constructor.
+template <class RandomAccessIterator, class KeyFn>
+void radix_sort(RandomAccessIterator first, RandomAccessIterator last,
+                KeyFn key_fn) {
+  typedef typename ::std::decay<decltype(key_fn(*first))>::type key_type;
+  static_assert(__is_radix_key<key_type>::value,
+                "key of radix_sort is an integer, float or double");
+  STL_NAME::__radix_sort(first, last, key_fn);
+}
+
+template <class RandomAccessIterator>
+void radix_sort(RandomAccessIterator first, RandomAccessIterator last) {
+  STL_NAME::radix_sort(first, last, __radix_identity());
+}
+
+// stable_sort is powersort of natural runs (__sort.h) with galloping merge,
+// O(n) on sorted input and faster the fewer runs the input has. it merges
+// with a buffer of half the input size, the default one is allocated and
+// the merge goes in place, O(n log^2 n) in total, if it fails. a scratch
+// buffer of buffer_size uninitialized element or an allocator of the
+// buffer may be given instead, a buffer smaller than half is used as far
+// as it goes.
 template <class RandomAccessIterator, class Compare>
 void stable_sort(RandomAccessIterator first, RandomAccessIterator last,
-                 Compare comp);
+                 Compare comp,
+                 typename iterator_traits<RandomAccessIterator>::value_type
+                     *buffer,
+                 ::std::size_t buffer_size) {
+  STL_NAME::__powersort(first, last, comp, buffer,
+                        static_cast<::std::ptrdiff_t>(buffer_size));
+}
+
+template <class RandomAccessIterator, class Compare, class Allocator>
+void stable_sort(RandomAccessIterator first, RandomAccessIterator last,
+                 Compare comp, const Allocator &alloc) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  const ::std::ptrdiff_t len = last - first;
+  if (len <= __stable_sort_min_run) {
+    STL_NAME::__insertion_sort(first, last, comp);
+    return;
+  }
+  __temporary_buffer<type, Allocator> buffer(
+      static_cast<::std::size_t>(len - len / 2), alloc, ::std::nothrow);
+  STL_NAME::__powersort(first, last, comp, buffer.data,
+                        static_cast<::std::ptrdiff_t>(buffer.size));
+}
+
+template <class RandomAccessIterator, class Compare>
+void stable_sort(RandomAccessIterator first, RandomAccessIterator last,
+                 Compare comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::stable_sort(first, last, comp, allocator<type>());
+}
 
 template <class RandomAccessIterator>
-void partial_sort(RandomAccessIterator first, RandomAccessIterator middle,
-                  RandomAccessIterator last);
+void stable_sort(RandomAccessIterator first, RandomAccessIterator last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::stable_sort(first, last, algorithm_utility::__less<type>{});
+}
+
+// partial_sort selects the k least into a window of 2k pruned by
+// nth_element whenever it is full (__sort.h) and sorts them, O(n + k log k)
+// in worst case, about n comparison on random input.
 template <class RandomAccessIterator, class Compare>
 void partial_sort(RandomAccessIterator first, RandomAccessIterator middle,
-                  RandomAccessIterator last, Compare comp);
-template <class InputIterator, class RandomAccessIterator>
-RandomAccessIterator partial_sort_copy(InputIterator first, InputIterator last,
-                                       RandomAccessIterator result_first,
-                                       RandomAccessIterator result_last);
+                  RandomAccessIterator last, Compare comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::__partial_select<
+      algorithm_utility::__is_arithmetic_order<type, Compare>::value>(
+      first, middle, last, comp);
+  STL_NAME::sort(first, middle, comp);
+}
+
+template <class RandomAccessIterator>
+void partial_sort(RandomAccessIterator first, RandomAccessIterator middle,
+                  RandomAccessIterator last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::partial_sort(first, middle, last,
+                         algorithm_utility::__less<type>{});
+}
+
+// partial_sort_copy reads the input once, the result range is a max heap of
+// the least so far and an element less than its top replaces it
 template <class InputIterator, class RandomAccessIterator, class Compare>
 RandomAccessIterator partial_sort_copy(InputIterator first, InputIterator last,
                                        RandomAccessIterator result_first,
                                        RandomAccessIterator result_last,
-                                       Compare comp);
+                                       Compare comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  RandomAccessIterator result = result_first;
+  for (; first != last && result != result_last; ++first, ++result)
+    *result = *first;
+  const difference_type len = result - result_first;
+  if (len == 0) return result;
+  __make_heap<2>(result_first, result, comp);
+  for (; first != last; ++first)
+    if (comp(*first, *result_first))
+      __sift_down<2>(result_first, comp, len, 0, *first);
+  __sort_heap<2>(result_first, result, comp);
+  return result;
+}
+
+template <class InputIterator, class RandomAccessIterator>
+RandomAccessIterator partial_sort_copy(InputIterator first, InputIterator last,
+                                       RandomAccessIterator result_first,
+                                       RandomAccessIterator result_last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  return STL_NAME::partial_sort_copy(first, last, result_first, result_last,
+                                     algorithm_utility::__less<type>{});
+}
 
 template <class ForwardIterator>
 bool is_sorted(ForwardIterator first, ForwardIterator last);
@@ -585,60 +1062,360 @@ template <class ForwardIterator, class Compare>
 ForwardIterator is_sorted_until(ForwardIterator first, ForwardIterator last,
                                 Compare comp);
 
-template <class RandomAccessIterator>
-void nth_element(RandomAccessIterator first, RandomAccessIterator nth,
-                 RandomAccessIterator last);
+// nth_element is introselect (__sort.h) with the pivot of a large range
+// chosen by Floyd-Rivest sampling, about 1.5 n comparison on random input
+// and linear in worst case by the median of medians.
 template <class RandomAccessIterator, class Compare>
 void nth_element(RandomAccessIterator first, RandomAccessIterator nth,
-                 RandomAccessIterator last, Compare comp);
+                 RandomAccessIterator last, Compare comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::__nth_element<
+      algorithm_utility::__is_arithmetic_order<type, Compare>::value>(
+      first, nth, last, comp);
+}
+
+template <class RandomAccessIterator>
+void nth_element(RandomAccessIterator first, RandomAccessIterator nth,
+                 RandomAccessIterator last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::nth_element(first, nth, last, algorithm_utility::__less<type>{});
+}
+
+// nth_elements puts every kth of [kth_first, kth_last), non-descending
+// iterators into [first, last), in place as nth_element does, and
+// partitions the range between them. O(n log m) for m kth, for many
+// quantiles in one pass.
+template <class RandomAccessIterator, class ForwardIterator, class Compare>
+void nth_elements(RandomAccessIterator first, RandomAccessIterator last,
+                  ForwardIterator kth_first, ForwardIterator kth_last,
+                  Compare comp) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::__nth_elements<
+      algorithm_utility::__is_arithmetic_order<type, Compare>::value>(
+      first, last, kth_first, kth_last, comp);
+}
+
+template <class RandomAccessIterator, class ForwardIterator>
+void nth_elements(RandomAccessIterator first, RandomAccessIterator last,
+                  ForwardIterator kth_first, ForwardIterator kth_last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::nth_elements(first, last, kth_first, kth_last,
+                         algorithm_utility::__less<type>{});
+}
 // binary search:
-template <class ForwardIterator, class T>
-ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
-                            const T &value);
+// a random access range of arithmetic element with the builtin < or > is
+// searched by conditional move with the next middle prefetched
+// (__binary_search.h), no branch mispredicts and a cache miss of a large
+// array overlaps the one of the level before. other range halves by
+// advance and branch.
 template <class ForwardIterator, class T, class Compare>
 ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
-                            const T &value, Compare comp);
+                            const T &value, Compare comp) {
+  return STL_NAME::__lower_bound<algorithm_utility::__is_branchless_search<
+      ForwardIterator, T, Compare>::value>(first, last, value, comp);
+}
 
 template <class ForwardIterator, class T>
-ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
-                            const T &value);
+ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
+                            const T &value) {
+  typedef typename iterator_traits<ForwardIterator>::value_type type;
+  return STL_NAME::lower_bound(first, last, value,
+                               algorithm_utility::__less<type, T>{});
+}
+
 template <class ForwardIterator, class T, class Compare>
 ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
-                            const T &value, Compare comp);
+                            const T &value, Compare comp) {
+  return STL_NAME::__upper_bound<algorithm_utility::__is_branchless_search<
+      ForwardIterator, T, Compare>::value>(first, last, value, comp);
+}
 
 template <class ForwardIterator, class T>
-pair<ForwardIterator, ForwardIterator> equal_range(ForwardIterator first,
-                                                   ForwardIterator last,
-                                                   const T &value);
+ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
+                            const T &value) {
+  typedef typename iterator_traits<ForwardIterator>::value_type type;
+  return STL_NAME::upper_bound(first, last, value,
+                               algorithm_utility::__less<T, type>{});
+}
+
+// both bounds are searched, the upper one from the lower one on
 template <class ForwardIterator, class T, class Compare>
 pair<ForwardIterator, ForwardIterator> equal_range(ForwardIterator first,
                                                    ForwardIterator last,
                                                    const T &value,
-                                                   Compare comp);
+                                                   Compare comp) {
+  first = STL_NAME::lower_bound(first, last, value, comp);
+  return pair<ForwardIterator, ForwardIterator>(
+      first, STL_NAME::upper_bound(first, last, value, comp));
+}
 
 template <class ForwardIterator, class T>
-bool binary_search(ForwardIterator first, ForwardIterator last, const T &value);
+pair<ForwardIterator, ForwardIterator> equal_range(ForwardIterator first,
+                                                   ForwardIterator last,
+                                                   const T &value) {
+  typedef typename iterator_traits<ForwardIterator>::value_type type;
+  first = STL_NAME::lower_bound(first, last, value);
+  return pair<ForwardIterator, ForwardIterator>(
+      first, STL_NAME::upper_bound(first, last, value,
+                                   algorithm_utility::__less<T, type>{}));
+}
+
 template <class ForwardIterator, class T, class Compare>
 bool binary_search(ForwardIterator first, ForwardIterator last, const T &value,
-                   Compare comp);
+                   Compare comp) {
+  first = STL_NAME::lower_bound(first, last, value, comp);
+  return first != last && !comp(value, *first);
+}
+
+template <class ForwardIterator, class T>
+bool binary_search(ForwardIterator first, ForwardIterator last,
+                   const T &value) {
+  first = STL_NAME::lower_bound(first, last, value);
+  return first != last && !(value < *first);
+}
+
+// batch search:
+// lower_bound of every key of [keys_first, keys_last) in [first, last), the
+// bounds to out in the order of the key. a random access range of
+// arithmetic element searches a group of __batch_search_width key at a time
+// in lockstep, a cache miss of every search of the group in flight at once
+// (__binary_search.h). a forward range of key of the element type is
+// sorted first with the position of every key when the range is larger
+// than the cache and there is a key per __batch_sort_ratio element at
+// least, the bounds are galloped in ascending order, each from the one
+// before, and written back in the order of the key. a range in cache is
+// faster in lockstep whatever the number of key. other range searches key
+// by key.
+
+// element of the range per key from which the key are sorted
+const ::std::ptrdiff_t __batch_sort_ratio = 64;
+// byte of the range from which the key may be sorted
+const ::std::size_t __batch_sort_min_bytes = ::std::size_t(1) << 25;
+
+template <class ForwardIterator, class InputIterator, class OutputIterator,
+          class Compare>
+OutputIterator __lower_bound_batch(ForwardIterator first, ForwardIterator last,
+                                   InputIterator keys_first,
+                                   InputIterator keys_last,
+                                   OutputIterator out, Compare &comp,
+                                   false_type) {
+  for (; keys_first != keys_last; ++keys_first, ++out)
+    *out = STL_NAME::lower_bound(first, last, *keys_first, comp);
+  return out;
+}
+
+template <class RandomAccessIterator, class InputIterator,
+          class OutputIterator, class Compare>
+OutputIterator __lower_bound_lockstep(RandomAccessIterator first,
+                                      RandomAccessIterator last,
+                                      InputIterator keys_first,
+                                      InputIterator keys_last,
+                                      OutputIterator out, Compare &comp) {
+  typedef typename iterator_traits<InputIterator>::value_type key_type;
+  key_type keys[__batch_search_width];
+  RandomAccessIterator result[__batch_search_width];
+  while (keys_first != keys_last) {
+    ::std::size_t count = 0;
+    for (; count < __batch_search_width && keys_first != keys_last;
+         ++count, ++keys_first)
+      keys[count] = *keys_first;
+    STL_NAME::__lower_bound_group(first, last - first, keys, count, result,
+                                  comp);
+    for (::std::size_t j = 0; j < count; ++j, ++out) *out = result[j];
+  }
+  return out;
+}
+
+// key and its position in the batch, ordered by key
+template <class T, class Compare>
+struct __batch_key_less {
+  Compare &comp;
+
+  bool operator()(const pair<T, ::std::size_t> &lhs,
+                  const pair<T, ::std::size_t> &rhs) const {
+    return comp(lhs.first, rhs.first);
+  }
+};
+
+// an integer key of 32 bits at most in the builtin order is sorted with its
+// position as a word of 64 bits, the key in the upper half
+template <class T, class Compare>
+struct __is_batch_word_key
+    : integral_constant<bool, ::std::is_integral<T>::value &&
+                                  !::std::is_same<T, bool>::value &&
+                                  sizeof(T) <= 4 &&
+                                  algorithm_utility::__is_builtin_less<
+                                      T, Compare>::value> {};
+
+template <class RandomAccessIterator, class ForwardIterator,
+          class OutputIterator, class Compare>
+OutputIterator __lower_bound_sorted(RandomAccessIterator first,
+                                    RandomAccessIterator last,
+                                    ForwardIterator keys_first,
+                                    ::std::size_t count, OutputIterator out,
+                                    Compare &comp, false_type) {
+  typedef typename iterator_traits<ForwardIterator>::value_type key_type;
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  typedef pair<key_type, ::std::size_t> entry;
+  __temporary_buffer<entry> keys(count);
+  for (; keys.constructed < count; ++keys.constructed, ++keys_first)
+    __temporary_buffer<entry>::alloc_traits::construct(
+        keys.alloc, keys.data + keys.constructed, *keys_first,
+        keys.constructed);
+  STL_NAME::sort(keys.data, keys.data + count,
+                 __batch_key_less<key_type, Compare>{comp});
+  __temporary_buffer<difference_type> bound(count);
+  const difference_type len = last - first;
+  RandomAccessIterator from = first;
+  for (::std::size_t i = 0; i < count; ++i) {
+    from = STL_NAME::__lower_bound_gallop(first, from, len,
+                                          keys.data[i].first, comp);
+    bound.data[keys.data[i].second] = from - first;
+  }
+  for (::std::size_t i = 0; i < count; ++i, ++out) *out = first + bound.data[i];
+  return out;
+}
+
+// the encoding of __radix_traits flips the sign bit of a signed key, it is
+// undone by flipping it again
+template <class RandomAccessIterator, class ForwardIterator,
+          class OutputIterator, class Compare>
+OutputIterator __lower_bound_sorted(RandomAccessIterator first,
+                                    RandomAccessIterator last,
+                                    ForwardIterator keys_first,
+                                    ::std::size_t count, OutputIterator out,
+                                    Compare &comp, true_type) {
+  typedef typename iterator_traits<ForwardIterator>::value_type key_type;
+  typedef typename iterator_traits<RandomAccessIterator>::difference_type
+      difference_type;
+  typedef __radix_traits<key_type> traits;
+  if (count > 0xffffffffu)
+    return STL_NAME::__lower_bound_sorted(first, last, keys_first, count, out,
+                                          comp, false_type());
+  __temporary_buffer<::std::uint64_t> keys(count);
+  for (::std::size_t i = 0; i < count; ++i, ++keys_first)
+    keys.data[i] = static_cast<::std::uint64_t>(traits::encode(*keys_first))
+                       << 32 |
+                   i;
+  STL_NAME::sort(keys.data, keys.data + count);
+  __temporary_buffer<difference_type> bound(count);
+  const difference_type len = last - first;
+  RandomAccessIterator from = first;
+  for (::std::size_t i = 0; i < count; ++i) {
+    const key_type key = static_cast<key_type>(traits::encode(
+        static_cast<key_type>(keys.data[i] >> 32)));
+    from = STL_NAME::__lower_bound_gallop(first, from, len, key, comp);
+    bound.data[keys.data[i] & 0xffffffffu] = from - first;
+  }
+  for (::std::size_t i = 0; i < count; ++i, ++out) *out = first + bound.data[i];
+  return out;
+}
+
+// the key are read once by an input iterator, they are not sorted
+template <class RandomAccessIterator, class InputIterator,
+          class OutputIterator, class Compare>
+OutputIterator __lower_bound_batch(RandomAccessIterator first,
+                                   RandomAccessIterator last,
+                                   InputIterator keys_first,
+                                   InputIterator keys_last,
+                                   OutputIterator out, Compare &comp,
+                                   true_type) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  typedef typename iterator_traits<InputIterator>::value_type key_type;
+  // key of the element type, comp orders the key too
+  if (__is_forward_iterator<InputIterator>::value &&
+      ::std::is_same<type, key_type>::value) {
+    const ::std::ptrdiff_t count = ::std::distance(keys_first, keys_last);
+    if (static_cast<::std::size_t>(last - first) * sizeof(type) >=
+            __batch_sort_min_bytes &&
+        count * __batch_sort_ratio >= last - first)
+      return STL_NAME::__lower_bound_sorted(
+          first, last, keys_first, static_cast<::std::size_t>(count), out,
+          comp, __is_batch_word_key<key_type, Compare>());
+  }
+  return STL_NAME::__lower_bound_lockstep(first, last, keys_first, keys_last,
+                                          out, comp);
+}
+
+template <class ForwardIterator, class InputIterator, class OutputIterator,
+          class Compare>
+OutputIterator lower_bound_batch(ForwardIterator first, ForwardIterator last,
+                                 InputIterator keys_first,
+                                 InputIterator keys_last, OutputIterator out,
+                                 Compare comp) {
+  typedef typename iterator_traits<InputIterator>::value_type key_type;
+  return STL_NAME::__lower_bound_batch(
+      first, last, keys_first, keys_last, out, comp,
+      integral_constant<bool, algorithm_utility::__is_branchless_search<
+                                  ForwardIterator, key_type, Compare>::value>());
+}
+
+template <class ForwardIterator, class InputIterator, class OutputIterator>
+OutputIterator lower_bound_batch(ForwardIterator first, ForwardIterator last,
+                                 InputIterator keys_first,
+                                 InputIterator keys_last, OutputIterator out) {
+  typedef typename iterator_traits<ForwardIterator>::value_type type;
+  typedef typename iterator_traits<InputIterator>::value_type key_type;
+  return STL_NAME::lower_bound_batch(
+      first, last, keys_first, keys_last, out,
+      algorithm_utility::__less<type, key_type>{});
+}
 
 // merge:
-template <class InputIterator1, class InputIterator2, class OutputIterator>
-OutputIterator merge(InputIterator1 first1, InputIterator1 last1,
-                     InputIterator2 first2, InputIterator2 last2,
-                     OutputIterator result);
+// stable, the element of the first range goes first among the equal ones
 template <class InputIterator1, class InputIterator2, class OutputIterator,
           class Compare>
 OutputIterator merge(InputIterator1 first1, InputIterator1 last1,
                      InputIterator2 first2, InputIterator2 last2,
-                     OutputIterator result, Compare comp);
+                     OutputIterator result, Compare comp) {
+  for (; first1 != last1; ++result) {
+    if (first2 == last2) return STL_NAME::copy(first1, last1, result);
+    if (comp(*first2, *first1)) {
+      *result = *first2;
+      ++first2;
+    } else {
+      *result = *first1;
+      ++first1;
+    }
+  }
+  return STL_NAME::copy(first2, last2, result);
+}
 
-template <class BidirectionalIterator>
-void inplace_merge(BidirectionalIterator first, BidirectionalIterator middle,
-                   BidirectionalIterator last);
+template <class InputIterator1, class InputIterator2, class OutputIterator>
+OutputIterator merge(InputIterator1 first1, InputIterator1 last1,
+                     InputIterator2 first2, InputIterator2 last2,
+                     OutputIterator result) {
+  typedef typename iterator_traits<InputIterator1>::value_type type1;
+  typedef typename iterator_traits<InputIterator2>::value_type type2;
+  return STL_NAME::merge(first1, last1, first2, last2, result,
+                         algorithm_utility::__less<type2, type1>{});
+}
+
+// inplace_merge is the galloping merge of stable_sort with a buffer of the
+// shorter run, in place by rotation if the allocation fails
 template <class BidirectionalIterator, class Compare>
 void inplace_merge(BidirectionalIterator first, BidirectionalIterator middle,
-                   BidirectionalIterator last, Compare comp);
+                   BidirectionalIterator last, Compare comp) {
+  typedef typename iterator_traits<BidirectionalIterator>::value_type type;
+  const ::std::ptrdiff_t len1 = ::std::distance(first, middle);
+  const ::std::ptrdiff_t len2 = ::std::distance(middle, last);
+  __temporary_buffer<type> buffer(
+      static_cast<::std::size_t>(len1 < len2 ? len1 : len2), allocator<type>(),
+      ::std::nothrow);
+  ::std::ptrdiff_t min_gallop = __merge_min_gallop;
+  STL_NAME::__merge_adaptive(first, middle, last, len1, len2, buffer.data,
+                             static_cast<::std::ptrdiff_t>(buffer.size), comp,
+                             min_gallop);
+}
+
+template <class BidirectionalIterator>
+void inplace_merge(BidirectionalIterator first, BidirectionalIterator middle,
+                   BidirectionalIterator last) {
+  typedef typename iterator_traits<BidirectionalIterator>::value_type type;
+  STL_NAME::inplace_merge(first, middle, last,
+                          algorithm_utility::__less<type>{});
+}
 
 // set operations:
 template <class InputIterator1, class InputIterator2>
@@ -693,40 +1470,156 @@ OutputIterator set_symmetric_difference(InputIterator1 first1,
                                         OutputIterator result, Compare comp);
 
 // heap operations:
-template <class RandomAccessIterator>
-void push_heap(RandomAccessIterator first, RandomAccessIterator last);
+// binary max heap by default, the variant with a leading Arity argument
+// (e.g. make_heap<4>(first, last)) works on a d-ary heap of the same layout
+// as __heap.h. a range is a heap only for the arity it was made with.
+// make_heap is Floyd's construction, pop_heap is Wegener's bottom-up
+// sift-down.
+template <::std::size_t Arity, class RandomAccessIterator, class Compare>
+void push_heap(RandomAccessIterator first, RandomAccessIterator last,
+               Compare comp) {
+  static_assert(Arity >= 2, "heap node has 2 children at least");
+  __push_heap<Arity>(first, last, comp);
+}
+
+template <::std::size_t Arity, class RandomAccessIterator>
+void push_heap(RandomAccessIterator first, RandomAccessIterator last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::push_heap<Arity>(first, last, algorithm_utility::__less<type>{});
+}
+
 template <class RandomAccessIterator, class Compare>
 void push_heap(RandomAccessIterator first, RandomAccessIterator last,
-               Compare comp);
+               Compare comp) {
+  STL_NAME::push_heap<2>(first, last, comp);
+}
+
 template <class RandomAccessIterator>
-void pop_heap(RandomAccessIterator first, RandomAccessIterator last);
+void push_heap(RandomAccessIterator first, RandomAccessIterator last) {
+  STL_NAME::push_heap<2>(first, last);
+}
+
+template <::std::size_t Arity, class RandomAccessIterator, class Compare>
+void pop_heap(RandomAccessIterator first, RandomAccessIterator last,
+              Compare comp) {
+  static_assert(Arity >= 2, "heap node has 2 children at least");
+  __pop_heap<Arity>(first, last, comp);
+}
+
+template <::std::size_t Arity, class RandomAccessIterator>
+void pop_heap(RandomAccessIterator first, RandomAccessIterator last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::pop_heap<Arity>(first, last, algorithm_utility::__less<type>{});
+}
+
 template <class RandomAccessIterator, class Compare>
 void pop_heap(RandomAccessIterator first, RandomAccessIterator last,
-              Compare comp);
+              Compare comp) {
+  STL_NAME::pop_heap<2>(first, last, comp);
+}
 
 template <class RandomAccessIterator>
-void make_heap(RandomAccessIterator first, RandomAccessIterator last);
+void pop_heap(RandomAccessIterator first, RandomAccessIterator last) {
+  STL_NAME::pop_heap<2>(first, last);
+}
+
+template <::std::size_t Arity, class RandomAccessIterator, class Compare>
+void make_heap(RandomAccessIterator first, RandomAccessIterator last,
+               Compare comp) {
+  static_assert(Arity >= 2, "heap node has 2 children at least");
+  __make_heap<Arity>(first, last, comp);
+}
+
+template <::std::size_t Arity, class RandomAccessIterator>
+void make_heap(RandomAccessIterator first, RandomAccessIterator last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::make_heap<Arity>(first, last, algorithm_utility::__less<type>{});
+}
+
 template <class RandomAccessIterator, class Compare>
 void make_heap(RandomAccessIterator first, RandomAccessIterator last,
-               Compare comp);
+               Compare comp) {
+  STL_NAME::make_heap<2>(first, last, comp);
+}
 
 template <class RandomAccessIterator>
-void sort_heap(RandomAccessIterator first, RandomAccessIterator last);
+void make_heap(RandomAccessIterator first, RandomAccessIterator last) {
+  STL_NAME::make_heap<2>(first, last);
+}
+
+template <::std::size_t Arity, class RandomAccessIterator, class Compare>
+void sort_heap(RandomAccessIterator first, RandomAccessIterator last,
+               Compare comp) {
+  static_assert(Arity >= 2, "heap node has 2 children at least");
+  __sort_heap<Arity>(first, last, comp);
+}
+
+template <::std::size_t Arity, class RandomAccessIterator>
+void sort_heap(RandomAccessIterator first, RandomAccessIterator last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::sort_heap<Arity>(first, last, algorithm_utility::__less<type>{});
+}
+
 template <class RandomAccessIterator, class Compare>
 void sort_heap(RandomAccessIterator first, RandomAccessIterator last,
-               Compare comp);
+               Compare comp) {
+  STL_NAME::sort_heap<2>(first, last, comp);
+}
 
 template <class RandomAccessIterator>
-bool is_heap(RandomAccessIterator first, RandomAccessIterator last);
+void sort_heap(RandomAccessIterator first, RandomAccessIterator last) {
+  STL_NAME::sort_heap<2>(first, last);
+}
+
+template <::std::size_t Arity, class RandomAccessIterator, class Compare>
+RandomAccessIterator is_heap_until(RandomAccessIterator first,
+                                   RandomAccessIterator last, Compare comp) {
+  static_assert(Arity >= 2, "heap node has 2 children at least");
+  return __is_heap_until<Arity>(first, last, comp);
+}
+
+template <::std::size_t Arity, class RandomAccessIterator>
+RandomAccessIterator is_heap_until(RandomAccessIterator first,
+                                   RandomAccessIterator last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  return STL_NAME::is_heap_until<Arity>(first, last,
+                                        algorithm_utility::__less<type>{});
+}
+
 template <class RandomAccessIterator, class Compare>
-bool is_heap(RandomAccessIterator first, RandomAccessIterator last,
-             Compare comp);
+RandomAccessIterator is_heap_until(RandomAccessIterator first,
+                                   RandomAccessIterator last, Compare comp) {
+  return STL_NAME::is_heap_until<2>(first, last, comp);
+}
+
 template <class RandomAccessIterator>
 RandomAccessIterator is_heap_until(RandomAccessIterator first,
-                                   RandomAccessIterator last);
+                                   RandomAccessIterator last) {
+  return STL_NAME::is_heap_until<2>(first, last);
+}
+
+template <::std::size_t Arity, class RandomAccessIterator, class Compare>
+bool is_heap(RandomAccessIterator first, RandomAccessIterator last,
+             Compare comp) {
+  return STL_NAME::is_heap_until<Arity>(first, last, comp) == last;
+}
+
+template <::std::size_t Arity, class RandomAccessIterator>
+bool is_heap(RandomAccessIterator first, RandomAccessIterator last) {
+  return STL_NAME::is_heap_until<Arity>(first, last) == last;
+}
+
 template <class RandomAccessIterator, class Compare>
-RandomAccessIterator is_heap_until(RandomAccessIterator first,
-                                   RandomAccessIterator last, Compare comp);
+bool is_heap(RandomAccessIterator first, RandomAccessIterator last,
+             Compare comp) {
+  return STL_NAME::is_heap_until<2>(first, last, comp) == last;
+}
+
+template <class RandomAccessIterator>
+bool is_heap(RandomAccessIterator first, RandomAccessIterator last) {
+  return STL_NAME::is_heap_until<2>(first, last) == last;
+}
+
 // minimum and maximum:
 template <class T>
 const T &min(const T &a, const T &b);
@@ -0,0 +1,285 @@
+#ifndef _STL_CONCURRENT_STACK__
+#define _STL_CONCURRENT_STACK__
+
+#include "Def/stldef.h"
+#include "__concurrency.h"
+#include "forward_list.h"
+
+STL_BEGIN
+
+// lock-free LIFO stack (Treiber stack)
+// node is the same single-link node of forward_list, so a whole
+// forward_list can be pushed with one CAS by push_range.
+// head keeps a ABA tag beside the pointer (see __tagged_pointer).
+// a thread in pop may still read next_ of a node just popped by another
+// thread, so popped node is never given back to the allocator while the stack
+// lives, it goes to a internal free list (also tagged) and is reused by the
+// next push. memory of the stack is the peak of its size.
+template <class T, class Allocator = allocator<T>>
+class concurrent_stack {
+  // >>> member types
+
+  typedef allocator_traits<Allocator> alloc_traits_;
+  typedef typename alloc_traits_::void_pointer void_pointer_;
+
+  static_assert(::std::is_same<void_pointer_, void *>::value,
+                "concurrent_stack needs allocator with raw pointer");
+
+  typedef __forward_list_node<T, void_pointer_> node_;
+  typedef __forward_list_node_base<T, void_pointer_> node_base_;
+  typedef typename node_::link_pointer_ link_pointer_;
+  typedef typename node_::node_pointer_ node_pointer_;
+  typedef typename alloc_traits_::template rebind_alloc<node_>
+      node_allocator_type_;
+  typedef allocator_traits<node_allocator_type_> node_alloc_traits_;
+  typedef __tagged_pointer<link_pointer_> tagged_;
+  typedef typename tagged_::value_type tagged_value_;
+
+  // type for RAII to keep exception safe when constructor of value throw
+  typedef __allocator_destructor<node_allocator_type_> node_destructor_;
+  typedef unique_ptr<node_, node_destructor_> hold_pointer_;
+
+ public:
+  typedef T value_type;
+  typedef Allocator allocator_type;
+  typedef value_type &reference;
+  typedef const value_type &const_reference;
+  typedef typename alloc_traits_::size_type size_type;
+
+  // >>> constructor
+  concurrent_stack() noexcept(
+      is_nothrow_default_constructible<allocator_type>::value)
+      : head_(0), free_(0), node_alloc_(node_allocator_type_()) {}
+
+  explicit concurrent_stack(const allocator_type &alloc)
+      : head_(0), free_(0), node_alloc_(alloc) {}
+
+  // no copy or move, address of head is shared by threads
+  concurrent_stack(const concurrent_stack &) = delete;
+
+  concurrent_stack &operator=(const concurrent_stack &) = delete;
+
+  // >>> destructor
+  // no other thread may access the stack now
+  ~concurrent_stack();
+
+  // >>> allocator
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(node_alloc_);
+  }
+
+  // >>> capacity
+  // only a snapshot if other thread is running
+  bool empty() const noexcept {
+    return tagged_::pointer(head_.load(::std::memory_order_acquire)) ==
+           nullptr;
+  }
+
+  // >>> modifier
+  void push(const value_type &val) { emplace(val); }
+
+  void push(value_type &&val) { emplace(::std::move(val)); }
+
+  template <class... Args>
+  void emplace(Args &&... args);
+
+  // push [first, last), the whole range is published by one CAS
+  // element is popped in reverse order of the range
+  template <class InputIterator>
+  typename enable_if<__is_input_iterator<InputIterator>::value, void>::type
+  push_range(InputIterator first, InputIterator last);
+
+  // splice all node of x in by one CAS, front of x is popped first
+  // precondition: x.get_allocator() == get_allocator()
+  void push_range(forward_list<value_type, allocator_type> &x);
+
+  void push_range(forward_list<value_type, allocator_type> &&x) {
+    push_range(x);
+  }
+
+  // pop top element into val, return false if stack is empty
+  bool try_pop(value_type &val);
+
+ private:
+  // >>> private auxiliary function
+  // create a unlinked node, value is constructed with args
+  template <class... Args>
+  link_pointer_ create_node_(Args &&... args);
+
+  // destroy value and keep node in free list
+  void destroy_node_(link_pointer_ p) noexcept {
+    node_alloc_traits_::destroy(node_alloc_, p->get_adressof_value_());
+    push_chain_(free_, p, p);
+  }
+
+  // next_ is read by other thread while a pusher writes it
+  static link_pointer_ load_next_(link_pointer_ p) noexcept {
+    return __atomic_load_n(&p->next_, __ATOMIC_RELAXED);
+  }
+
+  static void store_next_(link_pointer_ p, link_pointer_ next) noexcept {
+    __atomic_store_n(&p->next_, next, __ATOMIC_RELAXED);
+  }
+
+  // link chain [first, last] at top of head
+  static void push_chain_(::std::atomic<tagged_value_> &head,
+                          link_pointer_ first, link_pointer_ last) noexcept;
+
+  // unlink top node of head, return nullptr if empty
+  static link_pointer_ pop_link_(
+      ::std::atomic<tagged_value_> &head) noexcept;
+
+  // deallocate all node of chain, value is not destroyed
+  void deallocate_chain_(link_pointer_ first) noexcept;
+
+  // >>> data member
+  // head_ and free_ are hot for all thread, keep them apart
+  alignas(__cache_line_size)::std::atomic<tagged_value_> head_;
+  alignas(__cache_line_size)::std::atomic<tagged_value_> free_;
+  alignas(__cache_line_size) node_allocator_type_ node_alloc_;
+};
+
+template <class T, class Allocator>
+concurrent_stack<T, Allocator>::~concurrent_stack() {
+  link_pointer_ p = tagged_::pointer(head_.load(::std::memory_order_acquire));
+  for (link_pointer_ q = p; q != nullptr; q = q->next_)
+    node_alloc_traits_::destroy(node_alloc_, q->get_adressof_value_());
+  deallocate_chain_(p);
+  deallocate_chain_(
+      tagged_::pointer(free_.load(::std::memory_order_acquire)));
+}
+
+template <class T, class Allocator>
+void concurrent_stack<T, Allocator>::deallocate_chain_(
+    link_pointer_ first) noexcept {
+  while (first != nullptr) {
+    link_pointer_ next = first->next_;
+    node_alloc_traits_::deallocate(node_alloc_, first->as_node_(), 1);
+    first = next;
+  }
+}
+
+template <class T, class Allocator>
+void concurrent_stack<T, Allocator>::push_chain_(
+    ::std::atomic<tagged_value_> &head, link_pointer_ first,
+    link_pointer_ last) noexcept {
+  tagged_value_ old = head.load(::std::memory_order_relaxed);
+  __backoff<> backoff;
+  for (;;) {
+    store_next_(last, tagged_::pointer(old));
+    // release: node content is visible to the thread popping it
+    if (head.compare_exchange_weak(old, tagged_::next(old, first),
+                                   ::std::memory_order_release,
+                                   ::std::memory_order_relaxed))
+      return;
+    backoff();
+  }
+}
+
+template <class T, class Allocator>
+typename concurrent_stack<T, Allocator>::link_pointer_
+concurrent_stack<T, Allocator>::pop_link_(
+    ::std::atomic<tagged_value_> &head) noexcept {
+  tagged_value_ old = head.load(::std::memory_order_acquire);
+  __backoff<> backoff;
+  for (;;) {
+    link_pointer_ p = tagged_::pointer(old);
+    if (p == nullptr) return nullptr;
+    // p may be popped and reused by other thread now, but its memory is
+    // still owned by the stack, and the tag fails the CAS in that case
+    link_pointer_ next = load_next_(p);
+    if (head.compare_exchange_weak(old, tagged_::next(old, next),
+                                   ::std::memory_order_acq_rel,
+                                   ::std::memory_order_acquire))
+      return p;
+    backoff();
+  }
+}
+
+template <class T, class Allocator>
+template <class... Args>
+typename concurrent_stack<T, Allocator>::link_pointer_
+concurrent_stack<T, Allocator>::create_node_(Args &&... args) {
+  link_pointer_ p = pop_link_(free_);
+  if (p == nullptr) {
+    hold_pointer_ hold_ptr(node_alloc_traits_::allocate(node_alloc_, 1),
+                           node_destructor_(node_alloc_, 1));
+    node_alloc_traits_::construct(node_alloc_, hold_ptr->get_adressof_value_(),
+                                  ::std::forward<Args>(args)...);
+    store_next_(hold_ptr->as_link_(), nullptr);
+    return hold_ptr.release()->as_link_();
+  }
+  try {
+    node_alloc_traits_::construct(node_alloc_, p->get_adressof_value_(),
+                                  ::std::forward<Args>(args)...);
+  } catch (...) {
+    push_chain_(free_, p, p);
+    throw;
+  }
+  return p;
+}
+
+template <class T, class Allocator>
+template <class... Args>
+void concurrent_stack<T, Allocator>::emplace(Args &&... args) {
+  link_pointer_ p = create_node_(::std::forward<Args>(args)...);
+  push_chain_(head_, p, p);
+}
+
+template <class T, class Allocator>
+template <class InputIterator>
+typename enable_if<__is_input_iterator<InputIterator>::value, void>::type
+concurrent_stack<T, Allocator>::push_range(InputIterator first,
+                                           InputIterator last) {
+  if (first == last) return;
+  // build the chain privately, newest node at front
+  link_pointer_ chain_last = create_node_(*first);
+  link_pointer_ chain_first = chain_last;
+  try {
+    for (++first; first != last; ++first) {
+      link_pointer_ p = create_node_(*first);
+      store_next_(p, chain_first);
+      chain_first = p;
+    }
+  } catch (...) {
+    while (chain_first != nullptr) {
+      link_pointer_ next = chain_first->next_;
+      destroy_node_(chain_first);
+      chain_first = next;
+    }
+    throw;
+  }
+  push_chain_(head_, chain_first, chain_last);
+}
+
+template <class T, class Allocator>
+void concurrent_stack<T, Allocator>::push_range(
+    forward_list<value_type, allocator_type> &x) {
+  assert(node_allocator_type_(x.get_allocator()) == node_alloc_);
+  link_pointer_ first = x.head_.next_;
+  if (first == nullptr) return;
+  link_pointer_ last = first;
+  for (; last->next_ != nullptr; last = last->next_)
+    ;
+  x.head_.next_ = nullptr;
+  push_chain_(head_, first, last);
+}
+
+template <class T, class Allocator>
+bool concurrent_stack<T, Allocator>::try_pop(value_type &val) {
+  link_pointer_ p = pop_link_(head_);
+  if (p == nullptr) return false;
+  try {
+    val = ::std::move(p->as_node_()->value_);
+  } catch (...) {
+    // put it back, the stack is unchanged except for order
+    push_chain_(head_, p, p);
+    throw;
+  }
+  destroy_node_(p);
+  return true;
+}
+
+STL_END
+
+#endif  // !_STL_CONCURRENT_STACK__
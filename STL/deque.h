@@ -1,26 +1,196 @@
 #ifndef _DEQUE_H__
 #define _DEQUE_H__
 
+#include <cstdint>
+#include <cstring>
 #include "Def/stldef.h"
+#include "__block_pool.h"
+#include "__segmented_iterator.h"
 #include "__split_buffer.h"
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 STL_BEGIN
 
-template <class T, class VoidPtr>
+template <class T, class VoidPtr, class BlockPolicy>
 class __deque_const_iterator;
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 class __deque_base;
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 class deque;
+template <class Iterator>
+struct __deque_segmented_iterator_traits;
+
+// size of memory page, 4KiB if it is unknown
+inline ::std::size_t __page_size() noexcept {
+#ifdef __linux__
+  static const ::std::size_t page =
+      static_cast<::std::size_t>(::sysconf(_SC_PAGESIZE));
+  return page;
+#else
+  return 4096;
+#endif
+}
+
+// >>> block size policy
+// a policy gives the element count of a block for element type T by
+// Policy::block_size<T>::value, set it by the third parameter of deque.
+// iterator arithmetic of a power of two block is shift and mask instead of
+// division, so the policies below round to power of two.
+
+// round down and up to power of two
+constexpr ::std::size_t __deque_floor_pow2(::std::size_t n) {
+  return n <= 1 ? n : __deque_floor_pow2(n >> 1) << 1;
+}
+
+constexpr ::std::size_t __deque_ceil_pow2(::std::size_t n) {
+  return n <= 1 ? 1 : __deque_floor_pow2(n - 1) << 1;
+}
+
+constexpr int __deque_log2(::std::size_t n) {
+  return n <= 1 ? 0 : 1 + __deque_log2(n >> 1);
+}
+
+// block of at most Bytes bytes rounded down to power of two element,
+// but not less than MinElements (rounded up to power of two)
+template <::std::size_t Bytes, ::std::size_t MinElements = 16>
+struct deque_block_bytes {
+  template <class T>
+  struct block_size {
+   private:
+    static constexpr ::std::size_t fit_ = __deque_floor_pow2(Bytes / sizeof(T));
+    static constexpr ::std::size_t min_ = __deque_ceil_pow2(MinElements);
+
+   public:
+    static constexpr ::std::size_t value = fit_ < min_ ? min_ : fit_;
+  };
+};
 
-template <class T, class DifferenceType>
+// block of exactly N element, N is not rounded
+template <::std::size_t N>
+struct deque_block_elements {
+  template <class T>
+  struct block_size {
+    static constexpr ::std::size_t value = N;
+  };
+};
+
+// block of a 2MiB huge page, for very long deque.
+// whether the block is really backed by a huge page depends on the
+// allocator and transparent huge page setting of system.
+typedef deque_block_bytes<2 * 1024 * 1024> deque_huge_page_block;
+
+// default policy
+// element not larger than 64 bytes: 4KiB block like libcxx, a short deque
+// stays small.
+// larger element: 64 element per block if it fits in 64KiB, never less than
+// 16. a deque of 300 bytes message needs about a quarter of the block
+// allocation and map slot of a 16 element block.
+// both are rounded down to power of two.
+struct deque_default_block {
+  template <class T>
+  struct block_size {
+   private:
+    static constexpr ::std::size_t large_ = 65536 / sizeof(T);
+
+   public:
+    static constexpr ::std::size_t value = __deque_floor_pow2(
+        sizeof(T) <= 64 ? 4096 / sizeof(T)
+                        : (large_ < 16 ? 16 : (large_ > 64 ? 64 : large_)));
+  };
+};
+
+template <class T, class BlockPolicy, class DifferenceType>
 struct __deque_block_size {
-  // from libcxx
-  static const DifferenceType value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+  static const DifferenceType value = static_cast<DifferenceType>(
+      BlockPolicy::template block_size<T>::value);
+  static_assert(value > 0, "block of deque holds one element at least");
+
+  // slot n is in block n >> shift at offset n & mask, if is_power_of_two
+  static const bool is_power_of_two = (value & (value - 1)) == 0;
+  static const int shift = __deque_log2(static_cast<::std::size_t>(value));
+  static const DifferenceType mask = value - 1;
+};
+
+// >>> block pool allocator
+// allocator that takes the block of deque<T, deque_pool_allocator<T,
+// BlockPolicy>, BlockPolicy> from a __block_pool of the block bytes, shared
+// by every deque (and thread) with the same block size. other small request
+// like the map goes to a power of two __size_class_pool, the rest to
+// operator new.
+// a deque keeps spare block itself and the pool caches the rest per thread,
+// so a warm deque, even a newly created one, seldom calls malloc at all.
+// stateless, any two instance are equal.
+template <class T, class BlockPolicy = deque_default_block>
+class deque_pool_allocator {
+ public:
+  typedef T value_type;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+  typedef ::std::size_t size_type;
+  typedef ::std::ptrdiff_t difference_type;
+  typedef true_type propagate_on_container_move_assignment;
+  typedef true_type is_always_equal;
+
+  template <class U>
+  struct rebind {
+    typedef deque_pool_allocator<U, BlockPolicy> other;
+  };
+
+ private:
+  typedef __size_class_pool<alignof(T)> small_pool_;
+
+  static const size_type block_elements_ =
+      BlockPolicy::template block_size<T>::value;
+  static const size_type block_bytes_ = block_elements_ * sizeof(T);
+  // block too small for a free link is taken from size class pool
+  static const bool pooled_ = block_bytes_ >= small_pool_::min_bytes;
+
+  typedef __block_pool<pooled_ ? block_bytes_ : small_pool_::min_bytes,
+                       alignof(T)>
+      block_pool_;
+
+ public:
+  deque_pool_allocator() noexcept {}
+
+  template <class U>
+  deque_pool_allocator(const deque_pool_allocator<U, BlockPolicy> &) noexcept {}
+
+  pointer allocate(size_type n) {
+    if (pooled_ && n == block_elements_)
+      return static_cast<pointer>(block_pool_::allocate());
+    if (n <= small_pool_::max_bytes / sizeof(T))
+      return static_cast<pointer>(small_pool_::allocate(n * sizeof(T)));
+    return allocator<T>().allocate(n);
+  }
+
+  void deallocate(pointer p, size_type n) noexcept {
+    if (pooled_ && n == block_elements_)
+      block_pool_::deallocate(p);
+    else if (n <= small_pool_::max_bytes / sizeof(T))
+      small_pool_::deallocate(p, n * sizeof(T));
+    else
+      allocator<T>().deallocate(p, n);
+  }
 };
 
+template <class T, class U, class BlockPolicy>
+inline bool operator==(const deque_pool_allocator<T, BlockPolicy> &,
+                       const deque_pool_allocator<U, BlockPolicy> &) noexcept {
+  return true;
+}
+
+template <class T, class U, class BlockPolicy>
+inline bool operator!=(const deque_pool_allocator<T, BlockPolicy> &,
+                       const deque_pool_allocator<U, BlockPolicy> &) noexcept {
+  return false;
+}
+
 // deque iterator type
-template <class T, class VoidPtr>
+template <class T, class VoidPtr, class BlockPolicy>
 class __deque_iterator {
   // >>> member types
  public:
@@ -34,16 +204,18 @@ class __deque_iterator {
  private:
   typedef typename pointer_traits<VoidPtr>::template rebind<pointer>
       map_iterator_;
-  typedef __deque_block_size<T, difference_type> deque_block_size_;
+  typedef __deque_block_size<T, BlockPolicy, difference_type> deque_block_size_;
 
  private:
   // friend class
-  template <class, class>
+  template <class, class, class>
   friend class __deque_const_iterator;
-  template <class, class>
+  template <class, class, class>
   friend class __deque_base;
-  template <class, class>
+  template <class, class, class>
   friend class deque;
+  template <class>
+  friend struct __deque_segmented_iterator_traits;
 
  public:
   // constructor
@@ -52,6 +224,8 @@ class __deque_iterator {
   __deque_iterator(const __deque_iterator &iter)
       : map_iter_(iter.map_iter_), ptr_(iter.ptr_) {}
 
+  __deque_iterator &operator=(const __deque_iterator &iter) = default;
+
  private:
   // used for container
   __deque_iterator(const map_iterator_ &m, const pointer &p)
@@ -98,7 +272,11 @@ class __deque_iterator {
     if (step != 0) {
       // calculate total offset
       step += ptr_ - *map_iter_;
-      if (step > 0) {
+      if (deque_block_size_::is_power_of_two) {
+        // arithmetic shift and mask floor the negative offset too
+        map_iter_ += step >> deque_block_size_::shift;
+        ptr_ = *map_iter_ + (step & deque_block_size_::mask);
+      } else if (step > 0) {
         // if offset > 0, increse map_iter
         map_iter_ += step / block_size_();
         ptr_ = *map_iter_ + step % block_size_();
@@ -113,10 +291,10 @@ class __deque_iterator {
   }
 
   __deque_iterator &operator-=(difference_type step) {
-    return *(this += -step);
+    return *this += -step;
   }
 
-  __deque_iterator operator+(difference_type step) {
+  __deque_iterator operator+(difference_type step) const {
     __deque_iterator iter(*this);
     iter += step;
     return iter;
@@ -127,7 +305,7 @@ class __deque_iterator {
     return iter + step;
   }
 
-  __deque_iterator operator-(difference_type step) {
+  __deque_iterator operator-(difference_type step) const {
     __deque_iterator iter(*this);
     iter -= step;
     return iter;
@@ -135,6 +313,8 @@ class __deque_iterator {
 
   friend difference_type operator-(const __deque_iterator &lhs,
                                    const __deque_iterator &rhs) {
+    // map_iter_ of iterator from empty deque can not be dereferenced
+    if (lhs == rhs) return 0;
     return block_size_() * (lhs.map_iter_ - rhs.map_iter_) +
            (lhs.ptr_ - *lhs.map_iter_) - (rhs.ptr_ - *rhs.map_iter_);
   }
@@ -144,7 +324,7 @@ class __deque_iterator {
   // iterator comparation
   friend bool operator==(const __deque_iterator &lhs,
                          const __deque_iterator &rhs) {
-    return lhs.map_iter_ == rhs.map_iter_ && lhs.ptr_ == rhs.ptr_;
+    return lhs.ptr_ == rhs.ptr_;
   }
 
   friend bool operator!=(const __deque_iterator &lhs,
@@ -184,7 +364,7 @@ class __deque_iterator {
 };
 
 // deque const iterator type
-template <class T, class VoidPtr>
+template <class T, class VoidPtr, class BlockPolicy>
 class __deque_const_iterator {
   // >>> member types
  public:
@@ -197,16 +377,22 @@ class __deque_const_iterator {
   typedef typename pointer_traits<pointer>::difference_type difference_type;
 
  private:
-  typedef typename pointer_traits<VoidPtr>::template rebind<pointer>
+  // map holds non-const block pointer, same as map of __deque_iterator
+  typedef typename pointer_traits<VoidPtr>::template rebind<value_type>
+      block_pointer_;
+  typedef typename pointer_traits<VoidPtr>::template rebind<
+      const block_pointer_>
       map_iterator_;
-  typedef __deque_block_size<T, difference_type> deque_block_size_;
+  typedef __deque_block_size<T, BlockPolicy, difference_type> deque_block_size_;
 
  private:
   // friend class
-  template <class, class>
+  template <class, class, class>
   friend class __deque_base;
-  template <class, class>
+  template <class, class, class>
   friend class deque;
+  template <class>
+  friend struct __deque_segmented_iterator_traits;
 
  public:
   // constructor
@@ -215,8 +401,11 @@ class __deque_const_iterator {
   __deque_const_iterator(const __deque_const_iterator &iter)
       : map_iter_(iter.map_iter_), ptr_(iter.ptr_) {}
 
+  __deque_const_iterator &operator=(const __deque_const_iterator &iter) =
+      default;
+
   // convert from __deque_iterator
-  __deque_const_iterator(const __deque_iterator<T, VoidPtr> &iter)
+  __deque_const_iterator(const __deque_iterator<T, VoidPtr, BlockPolicy> &iter)
       : map_iter_(iter.map_iter_), ptr_(iter.ptr_) {}
 
  private:
@@ -265,7 +454,11 @@ class __deque_const_iterator {
     if (step != 0) {
       // calculate total offset
       step += ptr_ - *map_iter_;
-      if (step > 0) {
+      if (deque_block_size_::is_power_of_two) {
+        // arithmetic shift and mask floor the negative offset too
+        map_iter_ += step >> deque_block_size_::shift;
+        ptr_ = *map_iter_ + (step & deque_block_size_::mask);
+      } else if (step > 0) {
         // if offset > 0, increse map_iter
         map_iter_ += step / block_size_();
         ptr_ = *map_iter_ + step % block_size_();
@@ -280,10 +473,10 @@ class __deque_const_iterator {
   }
 
   __deque_const_iterator &operator-=(difference_type step) {
-    return *(this += -step);
+    return *this += -step;
   }
 
-  __deque_const_iterator operator+(difference_type step) {
+  __deque_const_iterator operator+(difference_type step) const {
     __deque_const_iterator iter(*this);
     iter += step;
     return iter;
@@ -294,7 +487,7 @@ class __deque_const_iterator {
     return iter + step;
   }
 
-  __deque_const_iterator operator-(difference_type step) {
+  __deque_const_iterator operator-(difference_type step) const {
     __deque_const_iterator iter(*this);
     iter -= step;
     return iter;
@@ -302,6 +495,8 @@ class __deque_const_iterator {
 
   friend difference_type operator-(const __deque_const_iterator &lhs,
                                    const __deque_const_iterator &rhs) {
+    // map_iter_ of iterator from empty deque can not be dereferenced
+    if (lhs == rhs) return 0;
     return block_size_() * (lhs.map_iter_ - rhs.map_iter_) +
            (lhs.ptr_ - *lhs.map_iter_) - (rhs.ptr_ - *rhs.map_iter_);
   }
@@ -311,7 +506,7 @@ class __deque_const_iterator {
   // iterator comparation
   friend bool operator==(const __deque_const_iterator &lhs,
                          const __deque_const_iterator &rhs) {
-    return lhs.map_iter_ == rhs.map_iter_ && lhs.ptr_ == rhs.ptr_;
+    return lhs.ptr_ == rhs.ptr_;
   }
 
   friend bool operator!=(const __deque_const_iterator &lhs,
@@ -350,7 +545,87 @@ class __deque_const_iterator {
   pointer ptr_;
 };
 
-template <class T, class Allocator>
+// deque iterator is segmented by block, see __segmented_iterator.h
+template <class Iterator>
+struct __deque_segmented_iterator_traits {
+  typedef true_type is_segmented_iterator;
+  typedef typename Iterator::map_iterator_ segment_iterator;
+  typedef typename Iterator::pointer local_iterator;
+
+  static segment_iterator segment(const Iterator &iter) {
+    return iter.map_iter_;
+  }
+
+  static local_iterator local(const Iterator &iter) { return iter.ptr_; }
+
+  static local_iterator begin(segment_iterator seg) { return *seg; }
+
+  static local_iterator end(segment_iterator seg) {
+    return *seg + Iterator::block_size_();
+  }
+
+  // iterator never points to the end of a block, move to the next one
+  static Iterator compose(segment_iterator seg, local_iterator local) {
+    if (local == end(seg)) {
+      ++seg;
+      local = *seg;
+    }
+    return Iterator(seg, local);
+  }
+};
+
+template <class T, class VoidPtr, class BlockPolicy>
+struct __segmented_iterator_traits<__deque_iterator<T, VoidPtr, BlockPolicy>>
+    : __deque_segmented_iterator_traits<
+          __deque_iterator<T, VoidPtr, BlockPolicy>> {};
+
+template <class T, class VoidPtr, class BlockPolicy>
+struct __segmented_iterator_traits<
+    __deque_const_iterator<T, VoidPtr, BlockPolicy>>
+    : __deque_segmented_iterator_traits<
+          __deque_const_iterator<T, VoidPtr, BlockPolicy>> {};
+
+// forward iterator yields the same value on every step
+// used by insert(pos, n, val) to share the path of range insert
+template <class T>
+class __deque_repeat_iterator {
+ public:
+  typedef forward_iterator_tag iterator_category;
+  typedef T value_type;
+  typedef const value_type &reference;
+  typedef const value_type *pointer;
+  typedef ::std::ptrdiff_t difference_type;
+
+  explicit __deque_repeat_iterator(const value_type &val) : val_(&val) {}
+
+  reference operator*() const { return *val_; }
+
+  pointer operator->() const { return val_; }
+
+  __deque_repeat_iterator &operator++() { return *this; }
+
+  __deque_repeat_iterator operator++(int) { return *this; }
+
+  friend bool operator==(const __deque_repeat_iterator &lhs,
+                         const __deque_repeat_iterator &rhs) {
+    return lhs.val_ == rhs.val_;
+  }
+
+  friend bool operator!=(const __deque_repeat_iterator &lhs,
+                         const __deque_repeat_iterator &rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  const value_type *val_;
+};
+
+// layout of deque:
+// map_ is a __split_buffer of block pointer, elements are in slot
+// [start_, start_ + size_) of all blocks laid end to end.
+// the last slot of the last block is never used, so map_iter_ of end() is
+// always in map_.
+template <class T, class Allocator, class BlockPolicy>
 class __deque_base {
  protected:
   // >>> member type
@@ -361,21 +636,28 @@ class __deque_base {
   typedef const value_type &const_reference;
 
   typedef typename alloc_traits_::void_pointer void_pointer_;
-  typedef __deque_iterator<value_type, void_pointer_> iterator;
-  typedef __deque_const_iterator<value_type, void_pointer_> const_iterator;
+  typedef __deque_iterator<value_type, void_pointer_, BlockPolicy> iterator;
+  typedef __deque_const_iterator<value_type, void_pointer_, BlockPolicy>
+      const_iterator;
 
   typedef typename alloc_traits_::size_type size_type;
   typedef typename alloc_traits_::difference_type difference_type;
   typedef typename alloc_traits_::pointer pointer;
   typedef typename alloc_traits_::const_pointer const_pointer;
 
-  typedef typename alloc_traits_::template rebind<pointer>
+  typedef typename alloc_traits_::template rebind_alloc<pointer>
       pointer_allocator_type;
   typedef allocator_traits<pointer_allocator_type> pointer_alloc_traits_;
 
   typedef __split_buffer<pointer, pointer_allocator_type> map_type_;
   typedef typename map_type_::iterator map_iter_;
-  typedef __deque_block_size<T, difference_type> deque_block_size_;
+  typedef typename map_type_::const_iterator map_const_iter_;
+  typedef __deque_block_size<T, BlockPolicy, difference_type> deque_block_size_;
+
+  // empty block at each end of map_ kept by pop and erase, at most.
+  // a queue oscillating around a block boundary reuses them instead of
+  // asking allocator again.
+  static const size_type spare_block_limit_ = 2;
 
  protected:
   // >>> constructor
@@ -394,6 +676,7 @@ class __deque_base {
   __deque_base(__deque_base &&) noexcept(
       is_nothrow_move_constructible<allocator_type>::value);
 
+  // take blocks of x if alloc == x.alloc_, or x is unchanged
   __deque_base(__deque_base &&, const allocator_type &);
 
   // >>> destructor
@@ -405,11 +688,11 @@ class __deque_base {
   // >>> access
   iterator begin() noexcept;
 
-  const_iterator begin() const noexcept { return begin(); }
+  const_iterator begin() const noexcept;
 
   iterator end() noexcept;
 
-  const_iterator end() const noexcept { return end(); }
+  const_iterator end() const noexcept;
 
   // >>> capacity
   size_type size() const noexcept { return size_; }
@@ -417,6 +700,25 @@ class __deque_base {
   // >>> modifier
   void clear() noexcept;
 
+  // destroy all element and give all block back
+  void release_() noexcept;
+
+  // take all element of x, *this must be released
+  void steal_(__deque_base &x) noexcept {
+    map_.swap(x.map_);
+    ::std::swap(start_, x.start_);
+    ::std::swap(size_, x.size_);
+  }
+
+  // copy assignment of allocator
+  void copy_assign_alloc_(const __deque_base &x) {
+    copy_assign_alloc_(
+        x, integral_constant<
+               bool,
+               alloc_traits_::propagate_on_container_copy_assignment::value>());
+  }
+
+  // move assignment of allocator
   void move_assign_alloc_(__deque_base &x) noexcept(
       !alloc_traits_::propagate_on_container_move_assignment::value ||
       ::std::is_nothrow_move_assignable<allocator_type>::value) {
@@ -427,12 +729,22 @@ class __deque_base {
   }
 
  private:
+  // propagate_on_container_copy_assignment
+  // blocks belong to the old allocator, release them if allocator changes
+  void copy_assign_alloc_(const __deque_base &x, true_type) {
+    if (alloc_ != x.alloc_) release_();
+    alloc_ = x.alloc_;
+    map_.alloc_ = pointer_allocator_type(alloc_);
+  }
+
+  // noop for allocator
+  void copy_assign_alloc_(const __deque_base &, false_type) {}
+
   // propagate_on_container_move_assignment
   // allocator need to be moved when container is move-assigned
   // noexcept if allocator is nothrow move assignable
   void move_assign_alloc_(__deque_base &x, true_type) noexcept(
       ::std::is_nothrow_move_assignable<allocator_type>::value) {
-    clear();
     alloc_ = ::std::move(x.alloc_);
   }
 
@@ -441,7 +753,18 @@ class __deque_base {
 
  protected:
   // get block_size of this type
-  difference_type block_size_() { return deque_block_size_::size; }
+  static difference_type block_size_() noexcept {
+    return deque_block_size_::value;
+  }
+
+  // allocate a block of block_size_() slots
+  pointer allocate_block_() {
+    return alloc_traits_::allocate(alloc_, block_size_());
+  }
+
+  void deallocate_block_(pointer p) noexcept {
+    alloc_traits_::deallocate(alloc_, p, block_size_());
+  }
 
   // data member
   map_type_ map_;
@@ -451,98 +774,112 @@ class __deque_base {
 };
 
 // constructor
-template <class T, class Allocator>
-__deque_base<T, Allocator>::__deque_base() noexcept(
+template <class T, class Allocator, class BlockPolicy>
+__deque_base<T, Allocator, BlockPolicy>::__deque_base() noexcept(
     is_nothrow_default_constructible<allocator_type>::value)
     : start_(0), size_(0) {}
 
-template <class T, class Allocator>
-__deque_base<T, Allocator>::__deque_base(const allocator_type &alloc)
+template <class T, class Allocator, class BlockPolicy>
+__deque_base<T, Allocator, BlockPolicy>::__deque_base(const allocator_type &alloc)
     : map_(pointer_allocator_type(alloc)), start_(0), size_(0), alloc_(alloc) {}
 
-template <class T, class Allocator>
-__deque_base<T, Allocator>::__deque_base(__deque_base &&x) noexcept(
+template <class T, class Allocator, class BlockPolicy>
+__deque_base<T, Allocator, BlockPolicy>::__deque_base(__deque_base &&x) noexcept(
     is_nothrow_move_constructible<allocator_type>::value)
     : map_(::std::move(x.map_)),
-      start_(::std::move(x.start_)),
-      size_(::std::move(x.size_)),
+      start_(x.start_),
+      size_(x.size_),
       alloc_(::std::move(x.alloc_)) {
   x.start_ = 0;
   x.size_ = 0;
 }
 
-template <class T, class Allocator>
-__deque_base<T, Allocator>::__deque_base(__deque_base &&x,
+template <class T, class Allocator, class BlockPolicy>
+__deque_base<T, Allocator, BlockPolicy>::__deque_base(__deque_base &&x,
                                          const allocator_type &alloc)
-    : map_(::std::move(x.map_), pointer_allocator_type(alloc)),
-      start_(::std::move(x.start_)),
-      size_(::std::move(x.size_)),
-      alloc_(::std::move(x.alloc_)) {
-  if (alloc == x.alloc_) {
-    x.start_ = 0;
-    x.size_ = 0;
-  } else {
-    map_.clear();
-    start_ = 0;
-    size_ = 0;
-  }
+    : map_(pointer_allocator_type(alloc)), start_(0), size_(0), alloc_(alloc) {
+  if (alloc_ == x.alloc_) steal_(x);
 }
 
 // destructor
-template <class T, class Allocator>
-__deque_base<T, Allocator>::~__deque_base() {
-  clear();
-  typename map_type_::iterator first = map_.begin();
-  typename map_type_::iterator last = map_.end();
-  for (; first != last; ++first)
-    alloc_traits_::deallocate(alloc_, *first, block_size_());
+template <class T, class Allocator, class BlockPolicy>
+__deque_base<T, Allocator, BlockPolicy>::~__deque_base() {
+  release_();
 }
 
 // swap
-template <class T, class Allocator>
-void __deque_base<T, Allocator>::swap(__deque_base &x) noexcept {
+template <class T, class Allocator, class BlockPolicy>
+void __deque_base<T, Allocator, BlockPolicy>::swap(__deque_base &x) noexcept {
   map_.swap(x.map_);
   ::std::swap(start_, x.start_);
   ::std::swap(size_, x.size_);
   __swap_allocator(alloc_, x.alloc_);
 }
 
-template <class T, class Allocator>
-typename __deque_base<T, Allocator>::iterator
-__deque_base<T, Allocator>::begin() noexcept {
-  typename map_type_::iterator mp = map_.begin() + start_ / block_size_();
+template <class T, class Allocator, class BlockPolicy>
+typename __deque_base<T, Allocator, BlockPolicy>::iterator
+__deque_base<T, Allocator, BlockPolicy>::begin() noexcept {
+  map_iter_ mp = map_.begin() + start_ / block_size_();
   return iterator(mp, map_.empty() ? nullptr : *mp + start_ % block_size_());
 }
 
-template <class T, class Allocator>
-typename __deque_base<T, Allocator>::iterator
-__deque_base<T, Allocator>::end() noexcept {
+template <class T, class Allocator, class BlockPolicy>
+typename __deque_base<T, Allocator, BlockPolicy>::const_iterator
+__deque_base<T, Allocator, BlockPolicy>::begin() const noexcept {
+  map_const_iter_ mp = map_.begin() + start_ / block_size_();
+  return const_iterator(mp,
+                        map_.empty() ? nullptr : *mp + start_ % block_size_());
+}
+
+template <class T, class Allocator, class BlockPolicy>
+typename __deque_base<T, Allocator, BlockPolicy>::iterator
+__deque_base<T, Allocator, BlockPolicy>::end() noexcept {
   size_type end_offset = start_ + size_;
-  typename map_type_::iterator mp = map_.begin() + end_offset / block_size_();
+  map_iter_ mp = map_.begin() + end_offset / block_size_();
   return iterator(mp,
                   map_.empty() ? nullptr : *mp + end_offset % block_size_());
 }
 
-template <class T, class Allocator>
-void __deque_base<T, Allocator>::clear() noexcept {
+template <class T, class Allocator, class BlockPolicy>
+typename __deque_base<T, Allocator, BlockPolicy>::const_iterator
+__deque_base<T, Allocator, BlockPolicy>::end() const noexcept {
+  size_type end_offset = start_ + size_;
+  map_const_iter_ mp = map_.begin() + end_offset / block_size_();
+  return const_iterator(
+      mp, map_.empty() ? nullptr : *mp + end_offset % block_size_());
+}
+
+template <class T, class Allocator, class BlockPolicy>
+void __deque_base<T, Allocator, BlockPolicy>::clear() noexcept {
   // destroy all element
   for (iterator first = begin(), last = end(); first != last; ++first)
     alloc_traits_::destroy(alloc_, first.ptr_);
   size_ = 0;
-  // release additional block
-  for (; map_.size() > 1;) {
-    alloc_traits_::deallocate(alloc_, map_.front(), block_size_());
-    map_.pop_front();
+  // keep spare_block_limit_ block for reuse, release the others
+  for (; map_.size() > spare_block_limit_;) {
+    deallocate_block_(map_.back());
+    map_.pop_back();
   }
-  // set start_ at half of block if map_ is not empty.
-  start_ = map_.empty() ? 0 : block_size_() / 2;
+  // set start_ at middle of map_, both end can grow without allocation
+  start_ = map_.size() * block_size_() / 2;
+}
+
+template <class T, class Allocator, class BlockPolicy>
+void __deque_base<T, Allocator, BlockPolicy>::release_() noexcept {
+  clear();
+  for (map_iter_ iter = map_.begin(); iter != map_.end(); ++iter)
+    deallocate_block_(*iter);
+  map_.clear();
+  map_.shrink_to_fit();
+  start_ = 0;
 }
 
 // deque class
-template <class T, class Allocator = allocator<T>>
-class deque : private __deque_base<T, Allocator> {
+template <class T, class Allocator = allocator<T>,
+          class BlockPolicy = deque_default_block>
+class deque : private __deque_base<T, Allocator, BlockPolicy> {
  private:
-  typedef __deque_base<T, Allocator> base_;
+  typedef __deque_base<T, Allocator, BlockPolicy> base_;
   typedef typename base_::alloc_traits_ alloc_traits_;
   typedef typename base_::pointer_allocator_type pointer_allocator_type;
   typedef typename base_::pointer_alloc_traits_ pointer_alloc_traits_;
@@ -565,11 +902,6 @@ class deque : private __deque_base<T, Allocator> {
   typedef ::std::reverse_iterator<iterator> reverse_iterator;
   typedef ::std::reverse_iterator<const_iterator> const_reverse_iterator;
 
- private:
-  // type for RAII to keep exception safe after new block is allocated
-  typedef __allocator_destructor<allocator_type> block_destructor_;
-  typedef unique_ptr<pointer, block_destructor_> block_hold_pointer_;
-
  public:
   // >>> constructor
   deque() noexcept(is_nothrow_default_constructible<allocator_type>::value) {}
@@ -650,11 +982,12 @@ class deque : private __deque_base<T, Allocator> {
   deque &operator=(const deque &x);
 
   deque &operator=(deque &&x) noexcept(
-      allocator_type::propagate_on_container_move_assignment::value
+      alloc_traits_::propagate_on_container_move_assignment::value
           &&is_nothrow_move_assignable<allocator_type>::value);
 
   deque &operator=(initializer_list<value_type> init) {
     assign(init.begin(), init.end());
+    return *this;
   }
 
   void assign(size_type n, const value_type &val);
@@ -703,13 +1036,13 @@ class deque : private __deque_base<T, Allocator> {
   reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
 
   const_reverse_iterator rbegin() const noexcept {
-    return reverse_iterator(end());
+    return const_reverse_iterator(end());
   }
 
   reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
 
   const_reverse_iterator rend() const noexcept {
-    return reverse_iterator(begin());
+    return const_reverse_iterator(begin());
   }
 
   // const iterator
@@ -734,8 +1067,16 @@ class deque : private __deque_base<T, Allocator> {
 
   void resize(size_type n, const value_type &val);
 
+  // give all empty block back to allocator and shrink map_
   void shrink_to_fit();
 
+  // keep at most max_spare_bytes of empty block (back end first), give back
+  // the outer ones and shrink map_. a block of advise_min_pages_ pages or
+  // more stays in map_ but its pages are dropped by madvise(MADV_DONTNEED),
+  // so RSS goes down while the block is reused without allocation. smaller
+  // block is given back to allocator.
+  void trim(size_type max_spare_bytes = 0) noexcept;
+
   // >>> element access
   reference operator[](size_type n);
 
@@ -767,13 +1108,13 @@ class deque : private __deque_base<T, Allocator> {
 
   // >>> modifier
   // insert
-  void push_front(const value_type &val);
+  void push_front(const value_type &val) { emplace_front(val); }
 
-  void push_front(value_type &&val);
+  void push_front(value_type &&val) { emplace_front(::std::move(val)); }
 
-  void push_back(const value_type &val);
+  void push_back(const value_type &val) { emplace_back(val); }
 
-  void push_back(value_type &&val);
+  void push_back(value_type &&val) { emplace_back(::std::move(val)); }
 
   template <class... Args>
   reference emplace_front(Args &&... args);
@@ -784,9 +1125,13 @@ class deque : private __deque_base<T, Allocator> {
   template <class... Args>
   iterator emplace(const_iterator pos, Args &&... args);
 
-  iterator insert(const_iterator pos, const value_type &val);
+  iterator insert(const_iterator pos, const value_type &val) {
+    return emplace(pos, val);
+  }
 
-  iterator insert(const_iterator pos, value_type &&val);
+  iterator insert(const_iterator pos, value_type &&val) {
+    return emplace(pos, ::std::move(val));
+  }
 
   iterator insert(const_iterator pos, size_type n, const value_type &val);
 
@@ -794,20 +1139,35 @@ class deque : private __deque_base<T, Allocator> {
   typename enable_if<
       __is_input_iterator<InputIterator>::value &&
           !__is_forward_iterator<InputIterator>::value &&
-          is_constructible<value_type, typename iterator_traits<
-                                           InputIterator>::reference>::value,
+          is_constructible<T, typename iterator_traits<
+                                  InputIterator>::reference>::value,
       iterator>::type
   insert(const_iterator pos, InputIterator first, InputIterator last);
 
   template <class ForwardIterator>
   typename enable_if<
       __is_forward_iterator<ForwardIterator>::value &&
-          is_constructible<value_type, typename iterator_traits<
-                                           ForwardIterator>::reference>::value,
+          is_constructible<T, typename iterator_traits<
+                                  ForwardIterator>::reference>::value,
       iterator>::type
   insert(const_iterator pos, ForwardIterator first, ForwardIterator last);
 
-  iterator insert(const_iterator pos, initializer_list<value_type> init);
+  iterator insert(const_iterator pos, initializer_list<value_type> init) {
+    return insert(pos, init.begin(), init.end());
+  }
+
+  // insert element of rg at back or front in order, capacity is added once
+  // and element is constructed block by block. deque is unchanged if a
+  // constructor throws
+  template <class Range>
+  void append_range(Range &&rg) {
+    append_range_(rg, is_contiguous_range_<Range>());
+  }
+
+  template <class Range>
+  void prepend_range(Range &&rg) {
+    prepend_range_(rg, is_contiguous_range_<Range>());
+  }
 
   // remove
   void pop_front();
@@ -818,46 +1178,195 @@ class deque : private __deque_base<T, Allocator> {
 
   iterator erase(const_iterator first, const_iterator last);
 
-  void clear() noexcept;
+  void clear() noexcept { base_::clear(); }
 
-  void swap(deque &x) noexcept(alloc_traits_::is_always_equal::value);
+  void swap(deque &x) noexcept(alloc_traits_::is_always_equal::value) {
+    base_::swap(x);
+  }
 
  private:
   // >>> private auxiliary function
   // throw length error
-  void throw_length_error_() const { throw ::std::length_error("vector"); }
+  void throw_length_error_() const { throw ::std::length_error("deque"); }
 
   // throw out of range error
-  void throw_out_of_range_() const { throw ::std::out_of_range("vector"); }
-
-  // calculate how many blocks can contain n element
-  size_type block_alloc_strategy_(size_type n) const {
-    // if map_ is empty(), n += 1
-    // for keeping map_iter_ of end() vaild, keep a position in the last slot.
-    n += static_cast<size_type>(this->map_.empty());
-    return n / this->block_size_() +
-           static_cast<size_type>(n % this->block_size_() != 0);
-  }
+  void throw_out_of_range_() const { throw ::std::out_of_range("deque"); }
 
   // query rest space
   // return the rest front space of deque
-  size_type front_spare_() const { return this->start_; }
+  size_type front_spare_() const noexcept { return this->start_; }
 
   // return the rest back space of deque
-  size_type back_spare_() const {
+  size_type back_spare_() const noexcept {
     // for keeping map_iter_ of end() vaild, keep a position in the last slot.
-    return this->block_size_() * this->map_.size() - 1 - front_spare_() -
-           size();
+    return this->map_.empty() ? 0
+                              : this->block_size_() * this->map_.size() - 1 -
+                                    front_spare_() - size();
   }
 
   // alloc additional space, strong guarentee exception safe
-  void alloc_front_();
+  // precondition: front_spare_() < n
+  // postcondition: front_spare_() >= n
+  void add_front_capacity_(size_type n);
+
+  // precondition: back_spare_() < n
+  // postcondition: back_spare_() >= n
+  void add_back_capacity_(size_type n);
+
+  // drop the whole pages in block p from RSS by madvise, content of block is
+  // lost
+  static void advise_block_(pointer p) noexcept;
+
+#ifdef __linux__
+  static const bool advise_supported_ = true;
+#else
+  static const bool advise_supported_ = false;
+#endif
+
+  // block at least this large is advised by trim instead of deallocated
+  static const size_type advise_min_pages_ = 16;
+
+  // give empty block beyond spare_block_limit_ back to allocator
+  void trim_front_spare_() noexcept;
+
+  void trim_back_spare_() noexcept;
+
+  // destroy element of [first, last) without changing start_ and size_
+  void destroy_range_(iterator first, iterator last) noexcept {
+    for (; first != last; ++first)
+      alloc_traits_::destroy(this->alloc_, first.ptr_);
+  }
+
+  // erase [new_end, end())
+  void erase_at_end_(iterator new_end) noexcept;
+
+  // construct n element at raw slot from result with first, first advances.
+  // block by block by construct_span_.
+  // return end of constructed range, nothing is left if a constructor throws
+  template <class InputIterator>
+  iterator construct_n_(iterator result, InputIterator &first, size_type n);
+
+  // construct n element at raw slot of one block from first, first advances.
+  // nothing is left if a constructor throws
+  template <class InputIterator>
+  void construct_span_(pointer result, InputIterator &first, size_type n);
+
+  // trivially copyable element from pointer is copied by memcpy
+  template <class U>
+  typename enable_if<
+      ::std::is_same<typename ::std::remove_const<U>::type, value_type>::value &&
+          ::std::is_trivially_copyable<value_type>::value,
+      void>::type
+  construct_span_(pointer result, U *&first, size_type n) noexcept {
+    ::std::memcpy(static_cast<void *>(__to_raw_pointer(result)),
+                  static_cast<const void *>(first), n * sizeof(value_type));
+    first += n;
+  }
 
-  void alloc_front_(size_type n);
+  // insert n element of [first, ...) at index pos by moving the shorter side
+  template <class ForwardIterator>
+  iterator insert_n_(size_type pos, ForwardIterator first, size_type n);
 
-  void alloc_back_();
+  // shift by memmove, then construct in the gap
+  template <class ForwardIterator>
+  void insert_n_(size_type pos, ForwardIterator first, size_type n,
+                 true_type);
 
-  void alloc_back_(size_type n);
+  // shift by move construct and move assign
+  template <class ForwardIterator>
+  void insert_n_(size_type pos, ForwardIterator first, size_type n,
+                 false_type);
+
+  // T is moved block by block, by memmove if it is trivially relocatable,
+  // slot of destination is raw memory in that case
+  typedef integral_constant<bool, is_trivially_relocatable<T>::value>
+      is_relocatable_;
+
+  // move element of [first, last) to result in one block
+  static void move_span_(pointer first, pointer last, pointer result,
+                         true_type) noexcept {
+    ::std::memmove(static_cast<void *>(__to_raw_pointer(result)),
+                   static_cast<const void *>(__to_raw_pointer(first)),
+                   static_cast<size_type>(last - first) * sizeof(value_type));
+  }
+
+  static void move_span_(pointer first, pointer last, pointer result,
+                         false_type) {
+    ::std::move(first, last, result);
+  }
+
+  static void move_span_backward_(pointer first, pointer last,
+                                  pointer result, true_type) noexcept {
+    move_span_(first, last, result - (last - first), true_type());
+  }
+
+  static void move_span_backward_(pointer first, pointer last,
+                                  pointer result, false_type) {
+    ::std::move_backward(first, last, result);
+  }
+
+  // move [first, last) to [result, ...) block by block, return end of result
+  // result must not be in (first, last)
+  static iterator move_blocks_(iterator first, iterator last, iterator result);
+
+  // move [first, last) to [..., result) block by block, return begin of
+  // result. result must not be in (first, last)
+  static iterator move_blocks_backward_(iterator first, iterator last,
+                                        iterator result);
+
+  // move assignment
+  void move_assign_(deque &x, true_type) noexcept(
+      is_nothrow_move_assignable<allocator_type>::value);
+
+  void move_assign_(deque &x, false_type);
+
+  // range insert at both end
+  // range with data() and size() is read by pointer, so trivially copyable
+  // element is copied by memcpy
+  template <class Range, class = void>
+  struct is_contiguous_range_ : false_type {};
+
+  template <class Range>
+  struct is_contiguous_range_<
+      Range, void_t<decltype(::std::declval<Range &>().data()),
+                  decltype(::std::declval<Range &>().size())>>
+      : ::std::is_pointer<decltype(::std::declval<Range &>().data())> {};
+
+  template <class Range>
+  void append_range_(Range &rg, true_type) {
+    append_range_n_(rg.data(), static_cast<size_type>(rg.size()));
+  }
+
+  template <class Range>
+  void append_range_(Range &rg, false_type) {
+    using ::std::begin;
+    using ::std::end;
+    append_range_(begin(rg), end(rg));
+  }
+
+  template <class Range>
+  void prepend_range_(Range &rg, true_type) {
+    prepend_range_n_(rg.data(), static_cast<size_type>(rg.size()));
+  }
+
+  template <class Range>
+  void prepend_range_(Range &rg, false_type) {
+    using ::std::begin;
+    using ::std::end;
+    prepend_range_(begin(rg), end(rg));
+  }
+
+  template <class InputIterator>
+  void append_range_(InputIterator first, InputIterator last);
+
+  template <class InputIterator>
+  void prepend_range_(InputIterator first, InputIterator last);
+
+  template <class ForwardIterator>
+  void append_range_n_(ForwardIterator first, size_type n);
+
+  template <class ForwardIterator>
+  void prepend_range_n_(ForwardIterator first, size_type n);
 
   // append operation
   void append_(size_type n);
@@ -890,235 +1399,334 @@ class deque : private __deque_base<T, Allocator> {
 
 // >>> alloc additional space, strong guarentee exception safe
 // add empty block at front of map
-template <class T, class Allocator>
-void deque<T, Allocator>::alloc_front_() {
-  // if back_spare_() > block_size, move the back free block to front
-  if (back_spare_() >= this->block_size_()) {
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::add_front_capacity_(size_type n) {
+  const size_type block_size = this->block_size_();
+  const bool was_empty = this->map_.empty();
+  // for empty map the unused last slot is needed too
+  size_type need = n - front_spare_() + static_cast<size_type>(was_empty);
+  size_type new_block =
+      need / block_size + static_cast<size_type>(need % block_size != 0);
+  // take empty block from back first
+  size_type move_block =
+      ::std::min<size_type>(new_block, back_spare_() / block_size);
+  new_block -= move_block;
+  for (; move_block > 0; --move_block) {
     pointer p = this->map_.back();
+    // pop first to guarantee map_ do shift not realloc
     this->map_.pop_back();
     this->map_.push_front(p);
+    this->start_ += block_size;
+  }
+  // elements of empty map start at 0, nothing to shift
+  const size_type step = was_empty ? 0 : block_size;
+  if (new_block == 0) {
     // if map_ do not reserve
-  } else if (this->map_.size() < this->map_.capacity()) {
-    // do allocate to the front
-    if (this->map_.front_spare_() > 0)
-      this->map_.push_front(
-          alloc_traits_::allocate(this->alloc_, this->block_size_()));
-    else {
-      this->map_.push_back(
-          alloc_traits_::allocate(this->alloc_, this->block_size_()));
-      pointer p = this->map_.back();
-      this->map_.pop_back();
-      this->map_.push_front(p);
+  } else if (new_block <= this->map_.capacity() - this->map_.size()) {
+    // a block pushed is a valid empty block even if the next one throws
+    for (; new_block > 0; --new_block) {
+      this->map_.push_front(this->allocate_block_());
+      this->start_ += step;
     }
     // alloc new map
   } else {
-    // alloc a new buffer at front
-    __split_buffer<pointer, pointer_allocator_type &> swap_buffer(
-        ::std::max<size_type>(2 * this->map_.capacity(), 1), 0,
-        this->map_.alloc_);
-    block_hold_pointer_ hold_ptr(
-        alloc_traits_::allocate(this->alloc_, this->block_size_()));
-    swap_buffer.push_back(hold_ptr.get());
-    hold_ptr.release();
+    size_type new_size = this->map_.size() + new_block;
+    size_type new_cap =
+        ::std::max<size_type>(2 * this->map_.capacity(), new_size);
+    map_type_ new_map(new_cap, (new_cap - new_size) / 2, this->map_.alloc_);
+    try {
+      for (size_type i = 0; i < new_block; ++i)
+        new_map.push_back(this->allocate_block_());
+    } catch (...) {
+      // deallocate all block if throw
+      for (map_iter_ iter = new_map.begin(); iter != new_map.end(); ++iter)
+        this->deallocate_block_(*iter);
+      throw;
+    }
     for (map_iter_ iter = this->map_.begin(); iter != this->map_.end(); ++iter)
-      swap_buffer.push_back(*iter);
-    this->map_.swap(swap_buffer);
+      new_map.push_back(*iter);
+    this->map_.swap(new_map);
+    this->start_ += new_block * step;
   }
-  // if original map_ is empty(), set start_ at mid of block
-  if (this->map_.size() == 1)
-    this->start_ = this->block_size_() / 2;
-  else
-    this->start_ += this->block_size_();
+  // if original map_ is empty(), set start_ at middle of free space
+  if (was_empty)
+    this->start_ = (this->block_size_() * this->map_.size() - 1 + n) / 2;
 }
 
-// add empty block at front of map
-template <class T, class Allocator>
-void deque<T, Allocator>::alloc_front_(size_type n) {
-  size_type new_block = block_alloc_strategy_(n);
-  size_type move_block = back_spare_() / this->block_size_();
-  move_block = ::std::min<size_type>(new_block, move_block);
+// add empty block at back of map
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::add_back_capacity_(size_type n) {
+  const size_type block_size = this->block_size_();
+  // for empty map the unused last slot is needed too
+  size_type need =
+      n - back_spare_() + static_cast<size_type>(this->map_.empty());
+  size_type new_block =
+      need / block_size + static_cast<size_type>(need % block_size != 0);
+  // take empty block from front first
+  size_type move_block =
+      ::std::min<size_type>(new_block, front_spare_() / block_size);
   new_block -= move_block;
-  // if new block is 0, no allocate happen
+  for (; move_block > 0; --move_block) {
+    pointer p = this->map_.front();
+    // pop first to guarantee map_ do shift not realloc
+    this->map_.pop_front();
+    this->map_.push_back(p);
+    this->start_ -= block_size;
+  }
   if (new_block == 0) {
-    this->start_ += move_block * this->block_size_();
-    for (; move_block > 0; --move_block) {
-      pointer p = this->map_.back();
-      this->map_.pop_back();
-      this->map_.push_front(p);
-    }
     // if map_ do not reserve
   } else if (new_block <= this->map_.capacity() - this->map_.size()) {
-    // fill front first
-    for (; new_block > 0 && this->map_.front_spare_() != 0; --new_block) {
-      this->map_.push_front(
-          alloc_traits_::allocate(this->alloc_, this->block_size_()));
-      this->start_ +=
-          this->block_size_() - static_cast<size_type>(this->map_.size() == 1);
-    }
-    // fill rest at back
-    for (; new_block > 0; --new_block, ++move_block)
-      this->map_.push_back(
-          alloc_traits_::allocate(this->alloc_, this->block_size_()));
-    // move back to front
-    this->start_ += move_block * this->block_size_();
-    for (; move_block > 0; --move_block) {
-      pointer p = this->map_.back();
-      this->map_.pop_back();
-      this->map_.push_front(p);
-    }
+    // a block pushed is a valid empty block even if the next one throws
+    for (; new_block > 0; --new_block)
+      this->map_.push_back(this->allocate_block_());
     // alloc new map
   } else {
-    size_type diff_start = (new_block + move_block) * this->block_size_() -
-                           static_cast<size_type>(this->map_.empty());
-    // alloc a new buffer at front
-    __split_buffer<pointer, pointer_allocator_type &> swap_buffer(
-        ::std::max<size_type>(2 * this->map_.capacity(),
-                              new_block + this->map_.capacity()),
-        0, this->map_.alloc_);
-    // alloc new block in buffer
+    size_type old_size = this->map_.size();
+    size_type new_size = old_size + new_block;
+    size_type new_cap =
+        ::std::max<size_type>(2 * this->map_.capacity(), new_size);
+    map_type_ new_map(new_cap, (new_cap - new_size) / 2, this->map_.alloc_);
+    for (map_iter_ iter = this->map_.begin(); iter != this->map_.end(); ++iter)
+      new_map.push_back(*iter);
     try {
       for (; new_block > 0; --new_block)
-        swap_buffer.push_back(
-            alloc_traits_::allocate(this->alloc_, this->block_size_()));
+        new_map.push_back(this->allocate_block_());
     } catch (...) {
-      // deallocate all block if throw
-      for (map_iter_ iter = swap_buffer.begin(); iter != swap_buffer.end();
+      // deallocate all new block if throw
+      for (map_iter_ iter = new_map.begin() + old_size; iter != new_map.end();
            ++iter)
-        alloc_traits_::deallocate(this->alloc_, *iter, this->block_size_());
+        this->deallocate_block_(*iter);
       throw;
     }
-    for (; move_block > 0; --move_block) {
-      pointer p = this->map_.back();
-      this->map_.pop_back();
-      swap_buffer.push_back(p);
-    }
-    for (map_iter_ iter = this->map_.begin(); iter != this->map_.end(); ++iter)
-      swap_buffer.push_back(*iter);
-    this->map_.swap(swap_buffer);
-    this->start_ += diff_start;
+    this->map_.swap(new_map);
   }
 }
 
-template <class T, class Allocator>
-void deque<T, Allocator>::alloc_back_() {
-  // if back_spare_() > block_size, move the back free block to front
-  if (front_spare_() >= this->block_size_()) {
-    pointer p = this->map_.front();
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::trim_front_spare_() noexcept {
+  const size_type block_size = this->block_size_();
+  for (; front_spare_() >= (base_::spare_block_limit_ + 1) * block_size;) {
+    this->deallocate_block_(this->map_.front());
     this->map_.pop_front();
-    this->map_.push_back(p);
-    // if map_ do not reserve
-  } else if (this->map_.size() < this->map_.capacity()) {
-    // do allocate to the front
-    if (this->map_.back_spare_() > 0)
-      this->map_.push_back(
-          alloc_traits_::allocate(this->alloc_, this->block_size_()));
-    else {
-      this->map_.push_front(
-          alloc_traits_::allocate(this->alloc_, this->block_size_()));
-      pointer p = this->map_.front();
-      this->map_.pop_front();
-      this->map_.push_back(p);
-    }
-  } else {
-    __split_buffer<pointer, pointer_allocator_type &> swap_buffer(
-        ::std::max<size_type>(2 * this->map_.capacity(), 1), this->map_.size(),
-        this->map_.alloc_);
-    block_hold_pointer_ hold_ptr(
-        alloc_traits_::allocate(this->alloc_, this->block_size_()));
-    swap_buffer.push_back(hold_ptr.get());
-    hold_ptr.release();
-    for (map_iter_ iter = this->map_.end(); iter != this->map_.begin();)
-      swap_buffer.push_front(*--iter);
-    this->map_.swap(swap_buffer);
-  }
-}
-
-template <class T, class Allocator>
-void deque<T, Allocator>::alloc_back_(size_type n) {
-  size_type new_block = block_alloc_strategy_(n);
-  size_type move_block = front_spare_() / this->block_size_();
-  move_block = ::std::min<size_type>(new_block, move_block);
-  new_block -= move_block;
-  // if new block is 0, no allocate happen
-  if (new_block == 0) {
-    this->start_ -= move_block * this->block_size_();
-    for (; move_block > 0; --move_block) {
-      pointer p = this->map_.front();
-      this->map_.pop_front();
-      this->map_.push_back(p);
-    }
-    // if map_ do not reserve
-  } else if (new_block <= this->map_.capacity() - this->map_.size()) {
-    // fill back first
-    for (; new_block > 0 && this->map_.back_spare_() != 0; --new_block)
-      this->map_.push_back(
-          alloc_traits_::allocate(this->alloc_, this->block_size_()));
-    // fill rest at front
-    for (; new_block > 0; --new_block, ++move_block) {
-      this->map_.push_front(
-          alloc_traits_::allocate(this->alloc_, this->block_size_()));
-      // change start_ to keep exception safe
-      this->start_ +=
-          this->block_size_() - static_cast<size_type>(this->map_.size() == 1);
+    this->start_ -= block_size;
+  }
+}
+
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::trim_back_spare_() noexcept {
+  const size_type block_size = this->block_size_();
+  for (; back_spare_() >= (base_::spare_block_limit_ + 1) * block_size;) {
+    this->deallocate_block_(this->map_.back());
+    this->map_.pop_back();
+  }
+}
+
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::erase_at_end_(iterator new_end) noexcept {
+  iterator old_end = end();
+  this->size_ -= old_end - new_end;
+  destroy_range_(new_end, old_end);
+  trim_back_spare_();
+}
+
+template <class T, class Allocator, class BlockPolicy>
+template <class InputIterator>
+typename deque<T, Allocator, BlockPolicy>::iterator deque<T, Allocator, BlockPolicy>::construct_n_(
+    iterator result, InputIterator &first, size_type n) {
+  iterator iter = result;
+  try {
+    while (n > 0) {
+      size_type k = static_cast<size_type>(*iter.map_iter_ +
+                                           this->block_size_() - iter.ptr_);
+      if (k > n) k = n;
+      construct_span_(iter.ptr_, first, k);
+      iter += static_cast<difference_type>(k);
+      n -= k;
     }
-    // move front to start
-    this->start_ -= move_block * this->block_size_();
-    for (; move_block > 0; --move_block) {
-      pointer p = this->map_.front();
-      // pop first to guarantee map_ do shift not realloc
-      this->map_.pop_front();
-      this->map_.push_back(p);
+  } catch (...) {
+    destroy_range_(result, iter);
+    throw;
+  }
+  return iter;
+}
+
+template <class T, class Allocator, class BlockPolicy>
+template <class InputIterator>
+void deque<T, Allocator, BlockPolicy>::construct_span_(pointer result,
+                                                       InputIterator &first,
+                                                       size_type n) {
+  pointer iter = result;
+  try {
+    for (pointer last = result + n; iter != last; ++iter, ++first)
+      alloc_traits_::construct(this->alloc_, iter, *first);
+  } catch (...) {
+    for (; result != iter; ++result) alloc_traits_::destroy(this->alloc_, result);
+    throw;
+  }
+}
+
+template <class T, class Allocator, class BlockPolicy>
+template <class ForwardIterator>
+typename deque<T, Allocator, BlockPolicy>::iterator deque<T, Allocator, BlockPolicy>::insert_n_(
+    size_type pos, ForwardIterator first, size_type n) {
+  if (n > 0) insert_n_(pos, first, n, is_relocatable_());
+  return begin() + pos;
+}
+
+template <class T, class Allocator, class BlockPolicy>
+template <class ForwardIterator>
+void deque<T, Allocator, BlockPolicy>::insert_n_(size_type pos,
+                                                 ForwardIterator first,
+                                                 size_type n, true_type) {
+  if (pos < size() - pos) {
+    // relocate front part n slots to front, gap is raw
+    if (front_spare_() < n) add_front_capacity_(n);
+    iterator old_begin = begin();
+    iterator gap = move_blocks_(old_begin, old_begin + pos, old_begin - n);
+    try {
+      construct_n_(gap, first, n);
+    } catch (...) {
+      move_blocks_backward_(old_begin - n, gap, old_begin + pos);
+      throw;
     }
-    // alloc new map
+    this->start_ -= n;
   } else {
-    size_type diff_start = move_block * this->block_size_();
-    // alloc a new buffer at front
-    __split_buffer<pointer, pointer_allocator_type &> swap_buffer(
-        ::std::max<size_type>(2 * this->map_.capacity(),
-                              new_block + this->map_.capacity()),
-        this->map_size() - move_block, this->map_.alloc_);
-    // alloc new block in buffer
+    // relocate back part n slots to back, gap is raw
+    if (back_spare_() < n) add_back_capacity_(n);
+    iterator old_end = end();
+    iterator gap = old_end - (size() - pos);
+    move_blocks_backward_(gap, old_end, old_end + n);
     try {
-      for (; new_block > 0; --new_block)
-        swap_buffer.push_back(
-            alloc_traits_::allocate(this->alloc_, this->block_size_()));
+      construct_n_(gap, first, n);
     } catch (...) {
-      // deallocate all block if throw
-      for (map_iter_ iter = swap_buffer.begin(); iter != swap_buffer.end();
-           ++iter)
-        alloc_traits_::deallocate(this->alloc_, *iter, this->block_size_());
+      move_blocks_(gap + n, old_end + n, gap);
       throw;
     }
-    for (; move_block > 0; --move_block) {
-      pointer p = this->map_.front();
-      this->map_.pop_front();
-      swap_buffer.push_back(p);
+  }
+  this->size_ += n;
+}
+
+template <class T, class Allocator, class BlockPolicy>
+template <class ForwardIterator>
+void deque<T, Allocator, BlockPolicy>::insert_n_(size_type pos,
+                                                 ForwardIterator first,
+                                                 size_type n, false_type) {
+  if (pos < size() - pos) {
+    // fewer element before pos, move them n slots to front
+    if (front_spare_() < n) add_front_capacity_(n);
+    iterator old_begin = begin();
+    iterator new_begin = old_begin - n;
+    if (n > pos) {
+      // [new_begin, new_begin + pos) takes the moved front element,
+      // gap [new_begin + pos, old_begin + pos) is raw slot in front part
+      auto mi = ::std::make_move_iterator(old_begin);
+      iterator iter = construct_n_(new_begin, mi, pos);
+      try {
+        construct_n_(iter, first, n - pos);
+      } catch (...) {
+        destroy_range_(new_begin, iter);
+        throw;
+      }
+      this->start_ -= n;
+      this->size_ += n;
+      for (iter = old_begin; iter != old_begin + pos; ++iter, ++first)
+        *iter = *first;
+    } else {
+      auto mi = ::std::make_move_iterator(old_begin);
+      construct_n_(new_begin, mi, n);
+      this->start_ -= n;
+      this->size_ += n;
+      iterator iter = move_blocks_(old_begin + n, old_begin + pos, old_begin);
+      for (; n > 0; --n, ++iter, ++first) *iter = *first;
+    }
+    return;
+  }
+  // fewer element after pos, move them n slots to back
+  if (back_spare_() < n) add_back_capacity_(n);
+  size_type tail = size() - pos;
+  iterator old_end = end();
+  iterator p = old_end - tail;
+  if (n > tail) {
+    // [p + n, old_end + n) takes the moved tail,
+    // gap [p, p + n) is raw slot in [old_end, p + n)
+    iterator new_tail = p + n;
+    auto mi = ::std::make_move_iterator(p);
+    iterator tail_end = construct_n_(new_tail, mi, tail);
+    try {
+      for (iterator iter = p; iter != old_end; ++iter, ++first) *iter = *first;
+      construct_n_(old_end, first, n - tail);
+    } catch (...) {
+      destroy_range_(new_tail, tail_end);
+      throw;
     }
-    for (map_iter_ iter = this->map_.end(); iter != this->map_.begin();)
-      swap_buffer.push_front(*--iter);
-    this->map_.swap(swap_buffer);
-    this->start_ -= diff_start;
+    this->size_ += n;
+  } else {
+    auto mi = ::std::make_move_iterator(old_end - n);
+    construct_n_(old_end, mi, n);
+    this->size_ += n;
+    move_blocks_backward_(p, old_end - n, old_end);
+    for (iterator iter = p; n > 0; --n, ++iter, ++first) *iter = *first;
   }
 }
 
+template <class T, class Allocator, class BlockPolicy>
+typename deque<T, Allocator, BlockPolicy>::iterator
+deque<T, Allocator, BlockPolicy>::move_blocks_(iterator first, iterator last,
+                                               iterator result) {
+  while (first != last) {
+    // the longest span in both the source block and the result block
+    difference_type n = last - first;
+    difference_type src = *first.map_iter_ + base_::block_size_() - first.ptr_;
+    difference_type dst = *result.map_iter_ + base_::block_size_() - result.ptr_;
+    if (src < n) n = src;
+    if (dst < n) n = dst;
+    move_span_(first.ptr_, first.ptr_ + n, result.ptr_, is_relocatable_());
+    first += n;
+    result += n;
+  }
+  return result;
+}
+
+template <class T, class Allocator, class BlockPolicy>
+typename deque<T, Allocator, BlockPolicy>::iterator
+deque<T, Allocator, BlockPolicy>::move_blocks_backward_(iterator first,
+                                                        iterator last,
+                                                        iterator result) {
+  while (first != last) {
+    // span ends at the last element of both source and result
+    iterator src_back = last - 1;
+    iterator dst_back = result - 1;
+    difference_type n = last - first;
+    difference_type src = src_back.ptr_ - *src_back.map_iter_ + 1;
+    difference_type dst = dst_back.ptr_ - *dst_back.map_iter_ + 1;
+    if (src < n) n = src;
+    if (dst < n) n = dst;
+    move_span_backward_(src_back.ptr_ + 1 - n, src_back.ptr_ + 1,
+                        dst_back.ptr_ + 1, is_relocatable_());
+    last -= n;
+    result -= n;
+  }
+  return result;
+}
+
 // append operation
-template <class T, class Allocator>
-void deque<T, Allocator>::append_(size_type n) {
-  if (back_spare_() < n) alloc_back_(n - back_spare_());
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::append_(size_type n) {
+  if (back_spare_() < n) add_back_capacity_(n);
   for (iterator iter = end(); n > 0; ++iter, --n, ++this->size_)
     alloc_traits_::construct(this->alloc_, iter.ptr_);
 }
 
-template <class T, class Allocator>
-void deque<T, Allocator>::append_(size_type n, const value_type &val) {
-  if (back_spare_() < n) alloc_back_(n - back_spare_());
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::append_(size_type n, const value_type &val) {
+  if (back_spare_() < n) add_back_capacity_(n);
   for (iterator iter = end(); n > 0; ++iter, --n, ++this->size_)
     alloc_traits_::construct(this->alloc_, iter.ptr_, val);
 }
 
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 template <class InputIterator>
-void deque<T, Allocator>::append_(
+void deque<T, Allocator, BlockPolicy>::append_(
     InputIterator first,
     typename enable_if<
         __is_input_iterator<InputIterator>::value &&
@@ -1129,9 +1737,9 @@ void deque<T, Allocator>::append_(
   for (; first != last; ++first) emplace_back(*first);
 }
 
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 template <class ForwardIterator>
-void deque<T, Allocator>::append_(
+void deque<T, Allocator, BlockPolicy>::append_(
     ForwardIterator first,
     typename enable_if<
         __is_forward_iterator<ForwardIterator>::value &&
@@ -1139,33 +1747,104 @@ void deque<T, Allocator>::append_(
                 value_type,
                 typename iterator_traits<ForwardIterator>::reference>::value,
         ForwardIterator>::type last) {
-  typename iterator_traits<ForwardIterator>::difference_type n =
-      ::std::distance(first, last);
-  if (back_spare_() < n) alloc_back_(n - back_spare_());
-  for (iterator iter = end(); first != last; ++iter, ++first, ++this->size_)
-    alloc_traits_::construct(this->alloc_, iter.ptr_, *first);
+  append_range_n_(first, static_cast<size_type>(::std::distance(first, last)));
+}
+
+// range insert at both end
+template <class T, class Allocator, class BlockPolicy>
+template <class InputIterator>
+void deque<T, Allocator, BlockPolicy>::append_range_(InputIterator first,
+                                                     InputIterator last) {
+  if (__is_forward_iterator<InputIterator>::value) {
+    append_range_n_(first,
+                    static_cast<size_type>(::std::distance(first, last)));
+    return;
+  }
+  // size is unknown, pop what is appended if a constructor throws
+  size_type old_size = size();
+  try {
+    for (; first != last; ++first) emplace_back(*first);
+  } catch (...) {
+    erase_at_end_(begin() + old_size);
+    throw;
+  }
+}
+
+template <class T, class Allocator, class BlockPolicy>
+template <class InputIterator>
+void deque<T, Allocator, BlockPolicy>::prepend_range_(InputIterator first,
+                                                      InputIterator last) {
+  if (__is_forward_iterator<InputIterator>::value) {
+    prepend_range_n_(first,
+                     static_cast<size_type>(::std::distance(first, last)));
+    return;
+  }
+  // size is unknown, collect element first
+  deque tmp(first, last, this->alloc_);
+  prepend_range_n_(::std::make_move_iterator(tmp.begin()), tmp.size());
+}
+
+template <class T, class Allocator, class BlockPolicy>
+template <class ForwardIterator>
+void deque<T, Allocator, BlockPolicy>::append_range_n_(ForwardIterator first,
+                                                       size_type n) {
+  if (n == 0) return;
+  if (back_spare_() < n) add_back_capacity_(n);
+  construct_n_(end(), first, n);
+  this->size_ += n;
+}
+
+template <class T, class Allocator, class BlockPolicy>
+template <class ForwardIterator>
+void deque<T, Allocator, BlockPolicy>::prepend_range_n_(ForwardIterator first,
+                                                        size_type n) {
+  if (n == 0) return;
+  if (front_spare_() < n) add_front_capacity_(n);
+  construct_n_(begin() - static_cast<difference_type>(n), first, n);
+  this->start_ -= n;
+  this->size_ += n;
+}
+
+// move assignment
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::move_assign_(deque &x, true_type) noexcept(
+    is_nothrow_move_assignable<allocator_type>::value) {
+  this->release_();
+  base_::move_assign_alloc_(x);
+  this->map_.alloc_ = pointer_allocator_type(this->alloc_);
+  this->steal_(x);
+}
+
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::move_assign_(deque &x, false_type) {
+  if (this->alloc_ == x.alloc_) {
+    this->release_();
+    this->steal_(x);
+  } else
+    assign(::std::make_move_iterator(x.begin()),
+           ::std::make_move_iterator(x.end()));
 }
 
 // >>> constructor
 // constructor with given size and value
-template <class T, class Allocator>
-deque<T, Allocator>::deque(size_type n) {
+template <class T, class Allocator, class BlockPolicy>
+deque<T, Allocator, BlockPolicy>::deque(size_type n) {
   append_(n);
 }
 
-template <class T, class Allocator>
-deque<T, Allocator>::deque(size_type n, const allocator_type &alloc)
+template <class T, class Allocator, class BlockPolicy>
+deque<T, Allocator, BlockPolicy>::deque(size_type n, const allocator_type &alloc)
     : base_(alloc) {
   append_(n);
 }
 
-template <class T, class Allocator>
-deque<T, Allocator>::deque(size_type n, const value_type &val) {
+template <class T, class Allocator, class BlockPolicy>
+deque<T, Allocator, BlockPolicy>::deque(size_type n, const value_type &val) {
   append_(n, val);
 }
 
-template <class T, class Allocator>
-deque<T, Allocator>::deque(size_type n, const value_type &val,
+template <class T, class Allocator, class BlockPolicy>
+deque<T, Allocator, BlockPolicy>::deque(size_type n, const value_type &val,
                            const allocator_type &alloc)
     : base_(alloc) {
   append_(n, val);
@@ -1173,9 +1852,9 @@ deque<T, Allocator>::deque(size_type n, const value_type &val,
 
 // constructor with given range
 // if const iterator is input iterator
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 template <class InputIterator>
-deque<T, Allocator>::deque(
+deque<T, Allocator, BlockPolicy>::deque(
     InputIterator first,
     typename enable_if<
         __is_input_iterator<InputIterator>::value &&
@@ -1186,9 +1865,9 @@ deque<T, Allocator>::deque(
   append_(first, last);
 }
 
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 template <class InputIterator>
-deque<T, Allocator>::deque(
+deque<T, Allocator, BlockPolicy>::deque(
     InputIterator first,
     typename enable_if<
         __is_input_iterator<InputIterator>::value &&
@@ -1201,9 +1880,9 @@ deque<T, Allocator>::deque(
   append_(first, last);
 }
 
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 template <class ForwardIterator>
-deque<T, Allocator>::deque(
+deque<T, Allocator, BlockPolicy>::deque(
     ForwardIterator first,
     typename enable_if<
         __is_forward_iterator<ForwardIterator>::value &&
@@ -1214,9 +1893,9 @@ deque<T, Allocator>::deque(
   append_(first, last);
 }
 
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 template <class ForwardIterator>
-deque<T, Allocator>::deque(
+deque<T, Allocator, BlockPolicy>::deque(
     ForwardIterator first,
     typename enable_if<
         __is_forward_iterator<ForwardIterator>::value &&
@@ -1229,195 +1908,409 @@ deque<T, Allocator>::deque(
   append_(first, last);
 }
 
-template <class T, class Allocator>
-deque<T, Allocator>::deque(const deque &x)
+template <class T, class Allocator, class BlockPolicy>
+deque<T, Allocator, BlockPolicy>::deque(const deque &x)
     : base_(alloc_traits_::select_on_container_copy_construction(x.alloc_)) {
   append_(x.begin(), x.end());
 }
 
-template <class T, class Allocator>
-deque<T, Allocator>::deque(deque &&x) noexcept(
+template <class T, class Allocator, class BlockPolicy>
+deque<T, Allocator, BlockPolicy>::deque(deque &&x) noexcept(
     is_nothrow_move_constructible<allocator_type>::value)
     : base_(::std::move(x)) {}
 
-template <class T, class Allocator>
-deque<T, Allocator>::deque(const deque &x, const allocator_type &alloc)
+template <class T, class Allocator, class BlockPolicy>
+deque<T, Allocator, BlockPolicy>::deque(const deque &x, const allocator_type &alloc)
     : base_(alloc) {
   append_(x.begin(), x.end());
 }
 
-template <class T, class Allocator>
-deque<T, Allocator>::deque(deque &&x, const allocator_type &alloc)
+template <class T, class Allocator, class BlockPolicy>
+deque<T, Allocator, BlockPolicy>::deque(deque &&x, const allocator_type &alloc)
     : base_(::std::move(x), alloc) {
-  if (this->alloc_ != x.alloc) {
-    append_(::std::move_iterator<iterator>(x.begin()),
-            ::std::move_iterator<iterator>(x.begin()));
-  }
+  // base_ takes nothing if allocators are not equal, move element one by one
+  if (this->alloc_ != x.alloc_)
+    append_(::std::make_move_iterator(x.begin()),
+            ::std::make_move_iterator(x.end()));
 }
 
-template <class T, class Allocator>
-deque<T, Allocator>::deque(initializer_list<value_type> init) {
+template <class T, class Allocator, class BlockPolicy>
+deque<T, Allocator, BlockPolicy>::deque(initializer_list<value_type> init) {
   append_(init.begin(), init.end());
 }
 
-template <class T, class Allocator>
-deque<T, Allocator>::deque(initializer_list<value_type> init,
+template <class T, class Allocator, class BlockPolicy>
+deque<T, Allocator, BlockPolicy>::deque(initializer_list<value_type> init,
                            const allocator_type &alloc)
     : base_(alloc) {
   append_(init.begin(), init.end());
 }
 
-// >>> assignment operation 
-template <class T, class Allocator>
-deque<T, Allocator> &deque<T, Allocator>::operator=(const deque &x);
-
-template <class T, class Allocator>
-deque<T, Allocator> &deque<T, Allocator>::operator=(deque &&x) noexcept(
-    allocator_type::propagate_on_container_move_assignment::value
-        &&is_nothrow_move_assignable<allocator_type>::value);
+// >>> assignment operation
+template <class T, class Allocator, class BlockPolicy>
+deque<T, Allocator, BlockPolicy> &deque<T, Allocator, BlockPolicy>::operator=(const deque &x) {
+  if (this != &x) {
+    base_::copy_assign_alloc_(x);
+    assign(x.begin(), x.end());
+  }
+  return *this;
+}
 
-template <class T, class Allocator>
-deque<T, Allocator> &deque<T, Allocator>::operator=(
-    initializer_list<value_type> init) {
+template <class T, class Allocator, class BlockPolicy>
+deque<T, Allocator, BlockPolicy> &deque<T, Allocator, BlockPolicy>::operator=(deque &&x) noexcept(
+    alloc_traits_::propagate_on_container_move_assignment::value
+        &&is_nothrow_move_assignable<allocator_type>::value) {
+  move_assign_(
+      x, integral_constant<
+             bool,
+             alloc_traits_::propagate_on_container_move_assignment::value>());
+  return *this;
 }
 
-template <class T, class Allocator>
-void deque<T, Allocator>::assign(size_type n, const value_type &val);
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::assign(size_type n, const value_type &val) {
+  if (n > size()) {
+    ::std::fill(begin(), end(), val);
+    append_(n - size(), val);
+  } else
+    erase_at_end_(::std::fill_n(begin(), n, val));
+}
 
 // assign with given range
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 template <class InputIterator>
-void deque<T, Allocator>::assign(
+void deque<T, Allocator, BlockPolicy>::assign(
     InputIterator first,
     typename enable_if<
         __is_input_iterator<InputIterator>::value &&
             !__is_forward_iterator<InputIterator>::value &&
             is_constructible<value_type, typename iterator_traits<
                                              InputIterator>::reference>::value,
-        InputIterator>::type last);
+        InputIterator>::type last) {
+  iterator iter = begin();
+  iterator old_end = end();
+  for (; first != last && iter != old_end; ++first, ++iter) *iter = *first;
+  if (iter != old_end)
+    erase_at_end_(iter);
+  else
+    append_(first, last);
+}
 
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 template <class ForwardIterator>
-void deque<T, Allocator>::assign(
+void deque<T, Allocator, BlockPolicy>::assign(
     ForwardIterator first,
     typename enable_if<
         __is_forward_iterator<ForwardIterator>::value &&
             is_constructible<
                 value_type,
                 typename iterator_traits<ForwardIterator>::reference>::value,
-        ForwardIterator>::type last);
+        ForwardIterator>::type last) {
+  size_type n = static_cast<size_type>(::std::distance(first, last));
+  if (n > size()) {
+    ForwardIterator mid = ::std::next(first, size());
+    ::std::copy(first, mid, begin());
+    append_(mid, last);
+  } else
+    erase_at_end_(::std::copy(first, last, begin()));
+}
 
 // >>> capacity
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::resize(size_type n) {
+  if (n > size())
+    append_(n - size());
+  else
+    erase_at_end_(begin() + n);
+}
 
-template <class T, class Allocator>
-void deque<T, Allocator>::resize(size_type n);
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::resize(size_type n, const value_type &val) {
+  if (n > size())
+    append_(n - size(), val);
+  else
+    erase_at_end_(begin() + n);
+}
+
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::shrink_to_fit() {
+  const size_type block_size = this->block_size_();
+  if (empty()) {
+    this->release_();
+    return;
+  }
+  for (; front_spare_() >= block_size; this->start_ -= block_size) {
+    this->deallocate_block_(this->map_.front());
+    this->map_.pop_front();
+  }
+  for (; back_spare_() >= block_size;) {
+    this->deallocate_block_(this->map_.back());
+    this->map_.pop_back();
+  }
+  this->map_.shrink_to_fit();
+}
 
-template <class T, class Allocator>
-void deque<T, Allocator>::resize(size_type n, const value_type &val);
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::trim(size_type max_spare_bytes) noexcept {
+  const size_type block_size = this->block_size_();
+  const size_type block_bytes = block_size * sizeof(value_type);
+  // whole empty block at both end, keep the inner ones
+  size_type front_block = front_spare_() / block_size;
+  size_type back_block = back_spare_() / block_size;
+  size_type keep = max_spare_bytes / block_bytes;
+  size_type keep_back = ::std::min(keep, back_block);
+  size_type keep_front = ::std::min(keep - keep_back, front_block);
+  front_block -= keep_front;
+  back_block -= keep_back;
+  if (advise_supported_ && block_bytes >= advise_min_pages_ * __page_size()) {
+    typename map_type_::iterator iter = this->map_.begin();
+    for (size_type i = 0; i < front_block; ++i) advise_block_(*iter++);
+    iter = this->map_.end();
+    for (size_type i = 0; i < back_block; ++i) advise_block_(*--iter);
+  } else {
+    for (; front_block > 0; --front_block, this->start_ -= block_size) {
+      this->deallocate_block_(this->map_.front());
+      this->map_.pop_front();
+    }
+    for (; back_block > 0; --back_block) {
+      this->deallocate_block_(this->map_.back());
+      this->map_.pop_back();
+    }
+  }
+  // map_ grown by a spike is much larger than needed
+  this->map_.shrink_to_fit();
+}
 
-template <class T, class Allocator>
-void deque<T, Allocator>::shrink_to_fit();
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::advise_block_(pointer p) noexcept {
+#ifdef __linux__
+  const ::std::uintptr_t page = __page_size();
+  const ::std::uintptr_t addr =
+      reinterpret_cast<::std::uintptr_t>(__to_raw_pointer(p));
+  const ::std::uintptr_t first = (addr + page - 1) & ~(page - 1);
+  const ::std::uintptr_t last =
+      (addr + base_::block_size_() * sizeof(value_type)) & ~(page - 1);
+  if (first < last)
+    ::madvise(reinterpret_cast<void *>(first), last - first, MADV_DONTNEED);
+#else
+  (void)p;
+#endif
+}
 
 // >>> element access
-template <class T, class Allocator>
-deque<T, Allocator>::reference deque<T, Allocator>::operator[](size_type n);
+template <class T, class Allocator, class BlockPolicy>
+inline typename deque<T, Allocator, BlockPolicy>::reference deque<T, Allocator, BlockPolicy>::
+operator[](size_type n) {
+  assert(n < size());
+  size_type p = this->start_ + n;
+  return *(*(this->map_.begin() + p / this->block_size_()) +
+           p % this->block_size_());
+}
 
-template <class T, class Allocator>
-deque<T, Allocator>::const_reference deque<T, Allocator>::operator[](
-    size_type n) const;
+template <class T, class Allocator, class BlockPolicy>
+inline typename deque<T, Allocator, BlockPolicy>::const_reference deque<T, Allocator, BlockPolicy>::
+operator[](size_type n) const {
+  assert(n < size());
+  size_type p = this->start_ + n;
+  return *(*(this->map_.begin() + p / this->block_size_()) +
+           p % this->block_size_());
+}
 
-template <class T, class Allocator>
-deque<T, Allocator>::reference deque<T, Allocator>::at(size_type n);
+template <class T, class Allocator, class BlockPolicy>
+typename deque<T, Allocator, BlockPolicy>::reference deque<T, Allocator, BlockPolicy>::at(size_type n) {
+  if (n >= size()) throw_out_of_range_();
+  return (*this)[n];
+}
 
-template <class T, class Allocator>
-deque<T, Allocator>::const_reference deque<T, Allocator>::at(size_type n) const;
+template <class T, class Allocator, class BlockPolicy>
+typename deque<T, Allocator, BlockPolicy>::const_reference deque<T, Allocator, BlockPolicy>::at(
+    size_type n) const {
+  if (n >= size()) throw_out_of_range_();
+  return (*this)[n];
+}
 
 // >>> modifier
 // insert
-template <class T, class Allocator>
-void deque<T, Allocator>::push_front(const value_type &val);
-
-template <class T, class Allocator>
-void deque<T, Allocator>::push_front(value_type &&val);
-
-template <class T, class Allocator>
-void deque<T, Allocator>::push_back(const value_type &val);
-
-template <class T, class Allocator>
-void deque<T, Allocator>::push_back(value_type &&val);
-
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 template <class... Args>
-deque<T, Allocator>::reference deque<T, Allocator>::emplace_front(
-    Args &&... args);
+typename deque<T, Allocator, BlockPolicy>::reference deque<T, Allocator, BlockPolicy>::emplace_front(
+    Args &&... args) {
+  if (front_spare_() == 0) add_front_capacity_(1);
+  iterator iter = --begin();
+  alloc_traits_::construct(this->alloc_, iter.ptr_,
+                           ::std::forward<Args>(args)...);
+  --this->start_;
+  ++this->size_;
+  return *iter;
+}
 
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 template <class... Args>
-deque<T, Allocator>::reference deque<T, Allocator>::emplace_back(
-    Args &&... args);
+typename deque<T, Allocator, BlockPolicy>::reference deque<T, Allocator, BlockPolicy>::emplace_back(
+    Args &&... args) {
+  if (back_spare_() == 0) add_back_capacity_(1);
+  iterator iter = end();
+  alloc_traits_::construct(this->alloc_, iter.ptr_,
+                           ::std::forward<Args>(args)...);
+  ++this->size_;
+  return *iter;
+}
 
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 template <class... Args>
-deque<T, Allocator>::iterator deque<T, Allocator>::emplace(const_iterator pos,
-                                                           Args &&... args);
-
-template <class T, class Allocator>
-deque<T, Allocator>::iterator deque<T, Allocator>::insert(
-    const_iterator pos, const value_type &val);
-
-template <class T, class Allocator>
-deque<T, Allocator>::iterator deque<T, Allocator>::insert(const_iterator pos,
-                                                          value_type &&val);
+typename deque<T, Allocator, BlockPolicy>::iterator deque<T, Allocator, BlockPolicy>::emplace(
+    const_iterator pos, Args &&... args) {
+  size_type index = static_cast<size_type>(pos - cbegin());
+  if (index == 0) {
+    emplace_front(::std::forward<Args>(args)...);
+    return begin();
+  }
+  if (index == size()) {
+    emplace_back(::std::forward<Args>(args)...);
+    return end() - 1;
+  }
+  // args may refer to element of *this, construct it before any move
+  value_type tmp(::std::forward<Args>(args)...);
+  return insert_n_(index, ::std::make_move_iterator(&tmp), 1);
+}
 
-template <class T, class Allocator>
-deque<T, Allocator>::iterator deque<T, Allocator>::insert(
-    const_iterator pos, size_type n, const value_type &val);
+template <class T, class Allocator, class BlockPolicy>
+typename deque<T, Allocator, BlockPolicy>::iterator deque<T, Allocator, BlockPolicy>::insert(
+    const_iterator pos, size_type n, const value_type &val) {
+  // val may be element of *this
+  value_type tmp(val);
+  return insert_n_(static_cast<size_type>(pos - cbegin()),
+                   __deque_repeat_iterator<value_type>(tmp), n);
+}
 
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 template <class InputIterator>
 typename enable_if<
     __is_input_iterator<InputIterator>::value &&
         !__is_forward_iterator<InputIterator>::value &&
-        is_constructible<value_type, typename iterator_traits<
-                                         InputIterator>::reference>::value,
-    deque<T, Allocator>::iterator>::type
-deque<T, Allocator>::insert(const_iterator pos, InputIterator first,
-                            InputIterator last);
+        is_constructible<T, typename iterator_traits<
+                                InputIterator>::reference>::value,
+    typename deque<T, Allocator, BlockPolicy>::iterator>::type
+deque<T, Allocator, BlockPolicy>::insert(const_iterator pos, InputIterator first,
+                            InputIterator last) {
+  // length of input range is unknown, buffer it first
+  deque buffer(first, last, this->alloc_);
+  return insert_n_(static_cast<size_type>(pos - cbegin()),
+                   ::std::make_move_iterator(buffer.begin()), buffer.size());
+}
 
-template <class T, class Allocator>
+template <class T, class Allocator, class BlockPolicy>
 template <class ForwardIterator>
 typename enable_if<
     __is_forward_iterator<ForwardIterator>::value &&
-        is_constructible<value_type, typename iterator_traits<
-                                         ForwardIterator>::reference>::value,
-    deque<T, Allocator>::iterator>::type
-deque<T, Allocator>::insert(const_iterator pos, ForwardIterator first,
-                            ForwardIterator last);
-
-template <class T, class Allocator>
-deque<T, Allocator>::deque<T, Allocator>::iterator deque<T, Allocator>::insert(
-    const_iterator pos, initializer_list<value_type> init);
+        is_constructible<T, typename iterator_traits<
+                                ForwardIterator>::reference>::value,
+    typename deque<T, Allocator, BlockPolicy>::iterator>::type
+deque<T, Allocator, BlockPolicy>::insert(const_iterator pos, ForwardIterator first,
+                            ForwardIterator last) {
+  return insert_n_(static_cast<size_type>(pos - cbegin()), first,
+                   static_cast<size_type>(::std::distance(first, last)));
+}
 
 // remove
-template <class T, class Allocator>
-void deque<T, Allocator>::pop_front();
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::pop_front() {
+  assert(!empty());
+  alloc_traits_::destroy(this->alloc_, begin().ptr_);
+  ++this->start_;
+  --this->size_;
+  trim_front_spare_();
+}
+
+template <class T, class Allocator, class BlockPolicy>
+void deque<T, Allocator, BlockPolicy>::pop_back() {
+  assert(!empty());
+  alloc_traits_::destroy(this->alloc_, (end() - 1).ptr_);
+  --this->size_;
+  trim_back_spare_();
+}
+
+template <class T, class Allocator, class BlockPolicy>
+typename deque<T, Allocator, BlockPolicy>::iterator deque<T, Allocator, BlockPolicy>::erase(
+    const_iterator pos) {
+  assert(pos != cend());
+  return erase(pos, pos + 1);
+}
+
+template <class T, class Allocator, class BlockPolicy>
+typename deque<T, Allocator, BlockPolicy>::iterator deque<T, Allocator, BlockPolicy>::erase(
+    const_iterator first, const_iterator last) {
+  size_type pos = static_cast<size_type>(first - cbegin());
+  size_type n = static_cast<size_type>(last - first);
+  iterator p = begin() + pos;
+  if (n == 0) return p;
+  // relocatable element is destroyed first, the shorter side is memmoved
+  // into the raw hole
+  if (is_relocatable_::value) destroy_range_(p, p + n);
+  if (pos < (size() - n) / 2) {
+    // fewer element before first, move them n slots to back
+    iterator old_begin = begin();
+    iterator new_begin = move_blocks_backward_(old_begin, p, p + n);
+    if (!is_relocatable_::value) destroy_range_(old_begin, new_begin);
+    this->start_ += n;
+    this->size_ -= n;
+    trim_front_spare_();
+  } else {
+    iterator new_end = move_blocks_(p + n, end(), p);
+    if (is_relocatable_::value) {
+      this->size_ -= n;
+      trim_back_spare_();
+    } else
+      erase_at_end_(new_end);
+  }
+  return begin() + pos;
+}
 
-template <class T, class Allocator>
-void deque<T, Allocator>::pop_back();
+// >>> nonmember funtion
 
-template <class T, class Allocator>
-deque<T, Allocator>::iterator deque<T, Allocator>::erase(const_iterator p);
+template <class T, class Allocator, class BlockPolicy>
+inline bool operator==(const deque<T, Allocator, BlockPolicy> &lhs,
+                       const deque<T, Allocator, BlockPolicy> &rhs) {
+  return lhs.size() == rhs.size() &&
+         ::std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Allocator, class BlockPolicy>
+inline bool operator!=(const deque<T, Allocator, BlockPolicy> &lhs,
+                       const deque<T, Allocator, BlockPolicy> &rhs) {
+  return !(lhs == rhs);
+}
+
+template <class T, class Allocator, class BlockPolicy>
+inline bool operator<(const deque<T, Allocator, BlockPolicy> &lhs,
+                      const deque<T, Allocator, BlockPolicy> &rhs) {
+  return ::std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                        rhs.end());
+}
 
-template <class T, class Allocator>
-deque<T, Allocator>::iterator deque<T, Allocator>::erase(const_iterator f,
-                                                         const_iterator l);
+template <class T, class Allocator, class BlockPolicy>
+inline bool operator>(const deque<T, Allocator, BlockPolicy> &lhs,
+                      const deque<T, Allocator, BlockPolicy> &rhs) {
+  return rhs < lhs;
+}
 
-template <class T, class Allocator>
-void deque<T, Allocator>::clear() noexcept;
+template <class T, class Allocator, class BlockPolicy>
+inline bool operator<=(const deque<T, Allocator, BlockPolicy> &lhs,
+                       const deque<T, Allocator, BlockPolicy> &rhs) {
+  return !(rhs < lhs);
+}
 
-template <class T, class Allocator>
-void deque<T, Allocator>::swap(deque &c) noexcept(
-    alloc_traits_::is_always_equal::value);
+template <class T, class Allocator, class BlockPolicy>
+inline bool operator>=(const deque<T, Allocator, BlockPolicy> &lhs,
+                       const deque<T, Allocator, BlockPolicy> &rhs) {
+  return !(lhs < rhs);
+}
+
+template <class T, class Allocator, class BlockPolicy>
+inline void swap(deque<T, Allocator, BlockPolicy> &lhs,
+                 deque<T, Allocator, BlockPolicy> &rhs) noexcept(noexcept(lhs.swap(rhs))) {
+  lhs.swap(rhs);
+}
 
 STL_END
 
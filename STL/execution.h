@@ -0,0 +1,786 @@
+#ifndef _STL_EXECUTION__
+#define _STL_EXECUTION__
+
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <type_traits>
+#include "Def/stldef.h"
+#include "__sort.h"
+#include "__thread_pool.h"
+#include "algorithm.h"
+
+STL_BEGIN
+
+// execution policy of algorithm, the policy is the first argument, e.g.
+// sort(execution::par, v.begin(), v.end()).
+// a parallel algorithm runs on the work-stealing pool of __thread_pool.h in
+// parts of grain element, par.with_grain(n) sets it, 0 lets the algorithm
+// choose about 8 part a thread. an exception leaving an element access
+// function calls terminate. the parallel one needs random access iterator,
+// it runs sequentially on other iterator.
+namespace execution {
+
+// run in the calling thread
+class sequenced_policy {};
+
+// run on the thread pool
+class parallel_policy {
+ public:
+  constexpr parallel_policy() noexcept : grain_(0) {}
+
+  constexpr explicit parallel_policy(::std::size_t grain) noexcept
+      : grain_(grain) {}
+
+  constexpr parallel_policy with_grain(::std::size_t grain) const noexcept {
+    return parallel_policy(grain);
+  }
+
+  constexpr ::std::size_t grain() const noexcept { return grain_; }
+
+ private:
+  ::std::size_t grain_;
+};
+
+// run on the thread pool, a part may also be vectorized. it is the same as
+// parallel_policy here, the sequential loop of a part is left to the
+// compiler.
+class parallel_unsequenced_policy {
+ public:
+  constexpr parallel_unsequenced_policy() noexcept : grain_(0) {}
+
+  constexpr explicit parallel_unsequenced_policy(::std::size_t grain) noexcept
+      : grain_(grain) {}
+
+  constexpr parallel_unsequenced_policy with_grain(
+      ::std::size_t grain) const noexcept {
+    return parallel_unsequenced_policy(grain);
+  }
+
+  constexpr ::std::size_t grain() const noexcept { return grain_; }
+
+ private:
+  ::std::size_t grain_;
+};
+
+constexpr sequenced_policy seq{};
+constexpr parallel_policy par{};
+constexpr parallel_unsequenced_policy par_unseq{};
+
+}  // namespace execution
+
+template <class T>
+struct is_execution_policy : false_type {};
+
+template <>
+struct is_execution_policy<execution::sequenced_policy> : true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_policy> : true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_unsequenced_policy>
+    : true_type {};
+
+// >>> utilities for parallel algorithm
+template <class ExecutionPolicy, class R>
+using __enable_if_execution_policy = enable_if<
+    is_execution_policy<typename ::std::decay<ExecutionPolicy>::type>::value,
+    R>;
+
+template <class... Iterators>
+struct __all_random_access : true_type {};
+
+template <class Iterator, class... Iterators>
+struct __all_random_access<Iterator, Iterators...>
+    : integral_constant<
+          bool, ::std::is_base_of<random_access_iterator_tag,
+                                  typename iterator_traits<
+                                      Iterator>::iterator_category>::value &&
+                    __all_random_access<Iterators...>::value> {};
+
+// true_type if the algorithm runs on the pool
+template <class ExecutionPolicy, class... Iterators>
+using __run_parallel = integral_constant<
+    bool, !::std::is_same<typename ::std::decay<ExecutionPolicy>::type,
+                          execution::sequenced_policy>::value &&
+              __all_random_access<Iterators...>::value>;
+
+inline ::std::size_t __policy_grain(const execution::sequenced_policy &) {
+  return 0;
+}
+
+inline ::std::size_t __policy_grain(const execution::parallel_policy &p) {
+  return p.grain();
+}
+
+inline ::std::size_t __policy_grain(
+    const execution::parallel_unsequenced_policy &p) {
+  return p.grain();
+}
+
+// >>> for_each
+template <class ExecutionPolicy, class ForwardIterator, class Function>
+void __for_each(ExecutionPolicy &, ForwardIterator first, ForwardIterator last,
+                Function &f, false_type) {
+  STL_NAME::for_each(first, last, f);
+}
+
+template <class ExecutionPolicy, class ForwardIterator, class Function>
+void __for_each(ExecutionPolicy &policy, ForwardIterator first,
+                ForwardIterator last, Function &f, true_type) {
+  __parallel_for(static_cast<::std::size_t>(last - first),
+                 __policy_grain(policy),
+                 [first, &f](::std::size_t begin, ::std::size_t end) {
+                   STL_NAME::for_each(first + begin, first + end, f);
+                 });
+}
+
+template <class ExecutionPolicy, class ForwardIterator, class Function>
+typename __enable_if_execution_policy<ExecutionPolicy, void>::type for_each(
+    ExecutionPolicy &&policy, ForwardIterator first, ForwardIterator last,
+    Function f) {
+  STL_NAME::__for_each(policy, first, last, f,
+                       __run_parallel<ExecutionPolicy, ForwardIterator>());
+}
+
+// >>> transform
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class UnaryOperation>
+ForwardIterator2 __transform(ExecutionPolicy &, ForwardIterator1 first,
+                             ForwardIterator1 last, ForwardIterator2 result,
+                             UnaryOperation &op, false_type) {
+  return STL_NAME::transform(first, last, result, op);
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class UnaryOperation>
+ForwardIterator2 __transform(ExecutionPolicy &policy, ForwardIterator1 first,
+                             ForwardIterator1 last, ForwardIterator2 result,
+                             UnaryOperation &op, true_type) {
+  const ::std::size_t n = static_cast<::std::size_t>(last - first);
+  __parallel_for(n, __policy_grain(policy),
+                 [first, result, &op](::std::size_t begin, ::std::size_t end) {
+                   STL_NAME::transform(first + begin, first + end,
+                                       result + begin, op);
+                 });
+  return result + n;
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class UnaryOperation>
+typename __enable_if_execution_policy<ExecutionPolicy, ForwardIterator2>::type
+transform(ExecutionPolicy &&policy, ForwardIterator1 first,
+          ForwardIterator1 last, ForwardIterator2 result, UnaryOperation op) {
+  return STL_NAME::__transform(
+      policy, first, last, result, op,
+      __run_parallel<ExecutionPolicy, ForwardIterator1, ForwardIterator2>());
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class ForwardIterator3,
+          class BinaryOperation>
+ForwardIterator3 __transform(ExecutionPolicy &, ForwardIterator1 first1,
+                             ForwardIterator1 last1, ForwardIterator2 first2,
+                             ForwardIterator3 result,
+                             BinaryOperation &binary_op, false_type) {
+  return STL_NAME::transform(first1, last1, first2, result, binary_op);
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class ForwardIterator3,
+          class BinaryOperation>
+ForwardIterator3 __transform(ExecutionPolicy &policy, ForwardIterator1 first1,
+                             ForwardIterator1 last1, ForwardIterator2 first2,
+                             ForwardIterator3 result,
+                             BinaryOperation &binary_op, true_type) {
+  const ::std::size_t n = static_cast<::std::size_t>(last1 - first1);
+  __parallel_for(n, __policy_grain(policy),
+                 [first1, first2, result, &binary_op](::std::size_t begin,
+                                                      ::std::size_t end) {
+                   STL_NAME::transform(first1 + begin, first1 + end,
+                                       first2 + begin, result + begin,
+                                       binary_op);
+                 });
+  return result + n;
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class ForwardIterator3,
+          class BinaryOperation>
+typename __enable_if_execution_policy<ExecutionPolicy, ForwardIterator3>::type
+transform(ExecutionPolicy &&policy, ForwardIterator1 first1,
+          ForwardIterator1 last1, ForwardIterator2 first2,
+          ForwardIterator3 result, BinaryOperation binary_op) {
+  return STL_NAME::__transform(
+      policy, first1, last1, first2, result, binary_op,
+      __run_parallel<ExecutionPolicy, ForwardIterator1, ForwardIterator2,
+                     ForwardIterator3>());
+}
+
+// >>> copy
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2>
+ForwardIterator2 __copy(ExecutionPolicy &, ForwardIterator1 first,
+                        ForwardIterator1 last, ForwardIterator2 result,
+                        false_type) {
+  return STL_NAME::copy(first, last, result);
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2>
+ForwardIterator2 __copy(ExecutionPolicy &policy, ForwardIterator1 first,
+                        ForwardIterator1 last, ForwardIterator2 result,
+                        true_type) {
+  const ::std::size_t n = static_cast<::std::size_t>(last - first);
+  __parallel_for(n, __policy_grain(policy),
+                 [first, result](::std::size_t begin, ::std::size_t end) {
+                   STL_NAME::copy(first + begin, first + end, result + begin);
+                 });
+  return result + n;
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2>
+typename __enable_if_execution_policy<ExecutionPolicy, ForwardIterator2>::type
+copy(ExecutionPolicy &&policy, ForwardIterator1 first, ForwardIterator1 last,
+     ForwardIterator2 result) {
+  return STL_NAME::__copy(
+      policy, first, last, result,
+      __run_parallel<ExecutionPolicy, ForwardIterator1, ForwardIterator2>());
+}
+
+// >>> fill
+template <class ExecutionPolicy, class ForwardIterator, class T>
+void __fill(ExecutionPolicy &, ForwardIterator first, ForwardIterator last,
+            const T &value, false_type) {
+  STL_NAME::fill(first, last, value);
+}
+
+template <class ExecutionPolicy, class ForwardIterator, class T>
+void __fill(ExecutionPolicy &policy, ForwardIterator first,
+            ForwardIterator last, const T &value, true_type) {
+  __parallel_for(static_cast<::std::size_t>(last - first),
+                 __policy_grain(policy),
+                 [first, &value](::std::size_t begin, ::std::size_t end) {
+                   STL_NAME::fill(first + begin, first + end, value);
+                 });
+}
+
+template <class ExecutionPolicy, class ForwardIterator, class T>
+typename __enable_if_execution_policy<ExecutionPolicy, void>::type fill(
+    ExecutionPolicy &&policy, ForwardIterator first, ForwardIterator last,
+    const T &value) {
+  STL_NAME::__fill(policy, first, last, value,
+                   __run_parallel<ExecutionPolicy, ForwardIterator>());
+}
+
+// >>> find
+template <class ExecutionPolicy, class ForwardIterator, class T>
+ForwardIterator __find(ExecutionPolicy &, ForwardIterator first,
+                       ForwardIterator last, const T &value, false_type) {
+  return STL_NAME::find(first, last, value);
+}
+
+// the least index found so far is shared, a part after it stops. a part is
+// searched a piece at a time to notice it soon.
+template <class ExecutionPolicy, class ForwardIterator, class T>
+ForwardIterator __find(ExecutionPolicy &policy, ForwardIterator first,
+                       ForwardIterator last, const T &value, true_type) {
+  const ::std::size_t n = static_cast<::std::size_t>(last - first);
+  const ::std::size_t piece = 4096;
+  ::std::atomic<::std::size_t> found(n);
+  __parallel_for(
+      n, __policy_grain(policy),
+      [first, &value, &found, piece](::std::size_t begin, ::std::size_t end) {
+        while (begin < end && begin < found.load(::std::memory_order_relaxed)) {
+          const ::std::size_t piece_end =
+              end - begin > piece ? begin + piece : end;
+          ForwardIterator iter =
+              STL_NAME::find(first + begin, first + piece_end, value);
+          if (iter != first + piece_end) {
+            const ::std::size_t index =
+                static_cast<::std::size_t>(iter - first);
+            ::std::size_t old = found.load(::std::memory_order_relaxed);
+            while (index < old &&
+                   !found.compare_exchange_weak(old, index,
+                                                ::std::memory_order_relaxed)) {
+            }
+            return;
+          }
+          begin = piece_end;
+        }
+      });
+  return first + found.load(::std::memory_order_relaxed);
+}
+
+template <class ExecutionPolicy, class ForwardIterator, class T>
+typename __enable_if_execution_policy<ExecutionPolicy, ForwardIterator>::type
+find(ExecutionPolicy &&policy, ForwardIterator first, ForwardIterator last,
+     const T &value) {
+  return STL_NAME::__find(policy, first, last, value,
+                          __run_parallel<ExecutionPolicy, ForwardIterator>());
+}
+
+// >>> count_if
+template <class ExecutionPolicy, class ForwardIterator, class Predicate>
+typename iterator_traits<ForwardIterator>::difference_type __count_if(
+    ExecutionPolicy &, ForwardIterator first, ForwardIterator last,
+    Predicate &pred, false_type) {
+  return STL_NAME::count_if(first, last, pred);
+}
+
+template <class ExecutionPolicy, class ForwardIterator, class Predicate>
+typename iterator_traits<ForwardIterator>::difference_type __count_if(
+    ExecutionPolicy &policy, ForwardIterator first, ForwardIterator last,
+    Predicate &pred, true_type) {
+  typedef typename iterator_traits<ForwardIterator>::difference_type
+      difference_type;
+  ::std::atomic<difference_type> count(0);
+  __parallel_for(
+      static_cast<::std::size_t>(last - first), __policy_grain(policy),
+      [first, &pred, &count](::std::size_t begin, ::std::size_t end) {
+        count.fetch_add(
+            STL_NAME::count_if(first + begin, first + end, pred),
+            ::std::memory_order_relaxed);
+      });
+  return count.load(::std::memory_order_relaxed);
+}
+
+template <class ExecutionPolicy, class ForwardIterator, class Predicate>
+typename __enable_if_execution_policy<
+    ExecutionPolicy,
+    typename iterator_traits<ForwardIterator>::difference_type>::type
+count_if(ExecutionPolicy &&policy, ForwardIterator first, ForwardIterator last,
+         Predicate pred) {
+  return STL_NAME::__count_if(
+      policy, first, last, pred,
+      __run_parallel<ExecutionPolicy, ForwardIterator>());
+}
+
+// >>> reduce
+// op is associative and commutative, the element is summed in any order
+template <class ExecutionPolicy, class ForwardIterator, class T,
+          class BinaryOperation>
+T __reduce(ExecutionPolicy &, ForwardIterator first, ForwardIterator last,
+           T init, BinaryOperation &op, false_type) {
+  for (; first != last; ++first) init = op(::std::move(init), *first);
+  return init;
+}
+
+// every part is summed alone, then added to init under a lock, there are
+// only a few part a thread
+template <class ExecutionPolicy, class ForwardIterator, class T,
+          class BinaryOperation>
+T __reduce(ExecutionPolicy &policy, ForwardIterator first,
+           ForwardIterator last, T init, BinaryOperation &op, true_type) {
+  ::std::mutex mutex;
+  __parallel_for(static_cast<::std::size_t>(last - first),
+                 __policy_grain(policy),
+                 [first, &op, &init, &mutex](::std::size_t begin,
+                                             ::std::size_t end) {
+                   T sum(first[begin]);
+                   for (::std::size_t i = begin + 1; i < end; ++i)
+                     sum = op(::std::move(sum), first[i]);
+                   ::std::lock_guard<::std::mutex> lock(mutex);
+                   init = op(::std::move(init), ::std::move(sum));
+                 });
+  return init;
+}
+
+template <class ExecutionPolicy, class ForwardIterator, class T,
+          class BinaryOperation>
+typename __enable_if_execution_policy<ExecutionPolicy, T>::type reduce(
+    ExecutionPolicy &&policy, ForwardIterator first, ForwardIterator last,
+    T init, BinaryOperation op) {
+  return STL_NAME::__reduce(policy, first, last, ::std::move(init), op,
+                            __run_parallel<ExecutionPolicy, ForwardIterator>());
+}
+
+template <class ExecutionPolicy, class ForwardIterator, class T>
+typename __enable_if_execution_policy<ExecutionPolicy, T>::type reduce(
+    ExecutionPolicy &&policy, ForwardIterator first, ForwardIterator last,
+    T init) {
+  return STL_NAME::reduce(policy, first, last, ::std::move(init),
+                          ::std::plus<>());
+}
+
+template <class ExecutionPolicy, class ForwardIterator>
+typename __enable_if_execution_policy<
+    ExecutionPolicy,
+    typename iterator_traits<ForwardIterator>::value_type>::type
+reduce(ExecutionPolicy &&policy, ForwardIterator first, ForwardIterator last) {
+  typedef typename iterator_traits<ForwardIterator>::value_type type;
+  return STL_NAME::reduce(policy, first, last, type(), ::std::plus<>());
+}
+
+// >>> inclusive_scan
+// without init, the first sum is the first element
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class BinaryOperation, class T>
+ForwardIterator2 __inclusive_scan(ExecutionPolicy &, ForwardIterator1 first,
+                                  ForwardIterator1 last,
+                                  ForwardIterator2 result,
+                                  BinaryOperation &op, T *init, false_type) {
+  if (first == last) return result;
+  T sum = init ? op(::std::move(*init), *first) : T(*first);
+  *result = sum;
+  for (++first, ++result; first != last; ++first, ++result) {
+    sum = op(::std::move(sum), *first);
+    *result = sum;
+  }
+  return result;
+}
+
+// three phase: every part but the last is summed in parallel, the sum
+// before every part is computed in turn, then every part is scanned from
+// its sum in parallel. op is only associative, so the part is fixed.
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class BinaryOperation, class T>
+ForwardIterator2 __inclusive_scan(ExecutionPolicy &policy,
+                                  ForwardIterator1 first,
+                                  ForwardIterator1 last,
+                                  ForwardIterator2 result,
+                                  BinaryOperation &op, T *init, true_type) {
+  const ::std::size_t n = static_cast<::std::size_t>(last - first);
+  ::std::size_t grain = __policy_grain(policy);
+  if (grain == 0)
+    grain = __parallel_grain(n, __thread_pool::instance().concurrency());
+  const ::std::size_t parts = (n + grain - 1) / grain;
+  if (parts <= 1)
+    return STL_NAME::__inclusive_scan(policy, first, last, result, op, init,
+                                      false_type());
+
+  // sums[p] is the sum of part p, then the sum before part p + 1
+  __temporary_buffer<T> sums(parts - 1);
+  __parallel_for(parts - 1, 1,
+                 [first, n, grain, &op, &sums](::std::size_t p_begin,
+                                               ::std::size_t p_end) {
+                   for (::std::size_t p = p_begin; p < p_end; ++p) {
+                     const ::std::size_t end = (p + 1) * grain;
+                     T sum(first[p * grain]);
+                     for (::std::size_t i = p * grain + 1; i < end; ++i)
+                       sum = op(::std::move(sum), first[i]);
+                     ::new (static_cast<void *>(sums.data + p))
+                         T(::std::move(sum));
+                   }
+                 });
+  sums.constructed = parts - 1;
+  if (init) sums.data[0] = op(*init, ::std::move(sums.data[0]));
+  for (::std::size_t p = 1; p < parts - 1; ++p)
+    sums.data[p] = op(sums.data[p - 1], ::std::move(sums.data[p]));
+
+  __parallel_for(parts, 1,
+                 [first, result, n, grain, &op, init, &sums](
+                     ::std::size_t p_begin, ::std::size_t p_end) {
+                   for (::std::size_t p = p_begin; p < p_end; ++p) {
+                     const ::std::size_t begin = p * grain;
+                     const ::std::size_t end =
+                         n - begin > grain ? begin + grain : n;
+                     T *before = p == 0 ? init : sums.data + (p - 1);
+                     execution::sequenced_policy seq;
+                     STL_NAME::__inclusive_scan(seq, first + begin,
+                                                first + end, result + begin,
+                                                op, before, false_type());
+                   }
+                 });
+  return result + n;
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class BinaryOperation, class T>
+typename __enable_if_execution_policy<ExecutionPolicy, ForwardIterator2>::type
+inclusive_scan(ExecutionPolicy &&policy, ForwardIterator1 first,
+               ForwardIterator1 last, ForwardIterator2 result,
+               BinaryOperation op, T init) {
+  return STL_NAME::__inclusive_scan(
+      policy, first, last, result, op, &init,
+      __run_parallel<ExecutionPolicy, ForwardIterator1, ForwardIterator2>());
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class BinaryOperation>
+typename __enable_if_execution_policy<ExecutionPolicy, ForwardIterator2>::type
+inclusive_scan(ExecutionPolicy &&policy, ForwardIterator1 first,
+               ForwardIterator1 last, ForwardIterator2 result,
+               BinaryOperation op) {
+  typedef typename iterator_traits<ForwardIterator1>::value_type type;
+  return STL_NAME::__inclusive_scan(
+      policy, first, last, result, op, static_cast<type *>(nullptr),
+      __run_parallel<ExecutionPolicy, ForwardIterator1, ForwardIterator2>());
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2>
+typename __enable_if_execution_policy<ExecutionPolicy, ForwardIterator2>::type
+inclusive_scan(ExecutionPolicy &&policy, ForwardIterator1 first,
+               ForwardIterator1 last, ForwardIterator2 result) {
+  return STL_NAME::inclusive_scan(policy, first, last, result,
+                                  ::std::plus<>());
+}
+
+// >>> merge
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class ForwardIterator3, class Compare>
+ForwardIterator3 __merge(ExecutionPolicy &, ForwardIterator1 first1,
+                         ForwardIterator1 last1, ForwardIterator2 first2,
+                         ForwardIterator2 last2, ForwardIterator3 result,
+                         Compare &comp, false_type) {
+  return STL_NAME::merge(first1, last1, first2, last2, result, comp);
+}
+
+// the output is cut into parts, the input of a part is found on its merge
+// path
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class ForwardIterator3, class Compare>
+ForwardIterator3 __merge(ExecutionPolicy &policy, ForwardIterator1 first1,
+                         ForwardIterator1 last1, ForwardIterator2 first2,
+                         ForwardIterator2 last2, ForwardIterator3 result,
+                         Compare &comp, true_type) {
+  const ::std::size_t n1 = static_cast<::std::size_t>(last1 - first1);
+  const ::std::size_t n2 = static_cast<::std::size_t>(last2 - first2);
+  __parallel_for(n1 + n2, __policy_grain(policy),
+                 [first1, n1, first2, n2, result, &comp](::std::size_t begin,
+                                                         ::std::size_t end) {
+                   const ::std::size_t i_begin = STL_NAME::__merge_path(
+                       first1, n1, first2, n2, begin, comp);
+                   const ::std::size_t i_end = STL_NAME::__merge_path(
+                       first1, n1, first2, n2, end, comp);
+                   STL_NAME::merge(first1 + i_begin, first1 + i_end,
+                                   first2 + (begin - i_begin),
+                                   first2 + (end - i_end), result + begin,
+                                   comp);
+                 });
+  return result + (n1 + n2);
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class ForwardIterator3, class Compare>
+typename __enable_if_execution_policy<ExecutionPolicy, ForwardIterator3>::type
+merge(ExecutionPolicy &&policy, ForwardIterator1 first1,
+      ForwardIterator1 last1, ForwardIterator2 first2, ForwardIterator2 last2,
+      ForwardIterator3 result, Compare comp) {
+  return STL_NAME::__merge(policy, first1, last1, first2, last2, result, comp,
+                           __run_parallel<ExecutionPolicy, ForwardIterator1,
+                                          ForwardIterator2,
+                                          ForwardIterator3>());
+}
+
+template <class ExecutionPolicy, class ForwardIterator1,
+          class ForwardIterator2, class ForwardIterator3>
+typename __enable_if_execution_policy<ExecutionPolicy, ForwardIterator3>::type
+merge(ExecutionPolicy &&policy, ForwardIterator1 first1,
+      ForwardIterator1 last1, ForwardIterator2 first2, ForwardIterator2 last2,
+      ForwardIterator3 result) {
+  typedef typename iterator_traits<ForwardIterator1>::value_type type1;
+  typedef typename iterator_traits<ForwardIterator2>::value_type type2;
+  return STL_NAME::merge(policy, first1, last1, first2, last2, result,
+                         algorithm_utility::__less<type2, type1>{});
+}
+
+// >>> sort and stable_sort
+// sort a run of every thread in parallel, then merge pairs of adjacent run
+// round by round between the range and a buffer, every merge is cut into
+// parts on its merge path. both stage use every thread in every round,
+// unlike quicksort whose first partition is sequential. stable if Stable.
+
+// the merge of pair p is [begin, end) of the range, its first run ends at
+// mid
+inline void __merge_round_pair(::std::size_t p, ::std::size_t n,
+                               ::std::size_t runs, ::std::size_t width,
+                               ::std::size_t &begin, ::std::size_t &mid,
+                               ::std::size_t &end) noexcept {
+  const ::std::size_t r = p * 2 * width;
+  begin = r * n / runs;
+  mid = r + width < runs ? (r + width) * n / runs : n;
+  end = r + 2 * width < runs ? (r + 2 * width) * n / runs : n;
+}
+
+// part j of a merge is [j * grain, (j + 1) * grain) of its output. every
+// cut of the round is searched before any part moves, a part moves element
+// of the run that a search of another part would read.
+template <class Compare, class InputIterator, class OutputIterator>
+void __parallel_merge_round(InputIterator in, OutputIterator out,
+                            ::std::size_t n, ::std::size_t runs,
+                            ::std::size_t width, ::std::size_t grain,
+                            Compare &comp) {
+  const ::std::size_t pairs = (runs + 2 * width - 1) / (2 * width);
+  // the cut of pair p are at first_cut[p], parts of p and one more
+  __temporary_buffer<::std::size_t> first_cut_buffer(pairs + 1);
+  ::std::size_t *first_cut = first_cut_buffer.data;
+  first_cut[0] = 0;
+  for (::std::size_t p = 0; p < pairs; ++p) {
+    ::std::size_t begin, mid, end;
+    STL_NAME::__merge_round_pair(p, n, runs, width, begin, mid, end);
+    first_cut[p + 1] = first_cut[p] + (end - begin + grain - 1) / grain + 1;
+  }
+  // the element of the first run before the cut
+  __temporary_buffer<::std::size_t> cut_buffer(first_cut[pairs]);
+  ::std::size_t *cuts = cut_buffer.data;
+  __parallel_for(pairs, 1, [=, &comp](::std::size_t p_begin,
+                                      ::std::size_t p_end) {
+    for (::std::size_t p = p_begin; p < p_end; ++p) {
+      ::std::size_t begin, mid, end;
+      STL_NAME::__merge_round_pair(p, n, runs, width, begin, mid, end);
+      const ::std::size_t n1 = mid - begin;
+      const ::std::size_t n2 = end - mid;
+      const ::std::size_t count = first_cut[p + 1] - first_cut[p];
+      __parallel_for(count, 1, [=, &comp](::std::size_t j_begin,
+                                          ::std::size_t j_end) {
+        for (::std::size_t j = j_begin; j < j_end; ++j) {
+          const ::std::size_t k = j * grain < n1 + n2 ? j * grain : n1 + n2;
+          cuts[first_cut[p] + j] = STL_NAME::__merge_path(
+              in + begin, n1, in + mid, n2, k, comp);
+        }
+      });
+    }
+  });
+  __parallel_for(pairs, 1, [=, &comp](::std::size_t p_begin,
+                                      ::std::size_t p_end) {
+    for (::std::size_t p = p_begin; p < p_end; ++p) {
+      ::std::size_t begin, mid, end;
+      STL_NAME::__merge_round_pair(p, n, runs, width, begin, mid, end);
+      InputIterator first1 = in + begin;
+      InputIterator first2 = in + mid;
+      const ::std::size_t len = end - begin;
+      const ::std::size_t *cut = cuts + first_cut[p];
+      const ::std::size_t parts = first_cut[p + 1] - first_cut[p] - 1;
+      __parallel_for(parts, 1, [=, &comp](::std::size_t j_begin,
+                                          ::std::size_t j_end) {
+        for (::std::size_t j = j_begin; j < j_end; ++j) {
+          const ::std::size_t b = j * grain;
+          const ::std::size_t e = b + grain < len ? b + grain : len;
+          STL_NAME::__merge_move(first1 + cut[j], first1 + cut[j + 1],
+                                 first2 + (b - cut[j]),
+                                 first2 + (e - cut[j + 1]),
+                                 out + (begin + b), comp);
+        }
+      });
+    }
+  });
+}
+
+template <bool Stable, class RandomAccessIterator, class Compare>
+void __parallel_sort(RandomAccessIterator first, RandomAccessIterator last,
+                     Compare &comp, ::std::size_t grain) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type
+      value_type;
+  const ::std::size_t n = static_cast<::std::size_t>(last - first);
+  const ::std::size_t concurrency = __thread_pool::instance().concurrency();
+  // a run a thread by default
+  if (grain == 0) grain = (n + concurrency - 1) / concurrency;
+  if (grain < 4096) grain = 4096;
+  if (concurrency == 1 || n <= grain) {
+    if (Stable)
+      STL_NAME::stable_sort(first, last, comp);
+    else
+      STL_NAME::sort(first, last, comp);
+    return;
+  }
+
+  const ::std::size_t runs = (n + grain - 1) / grain;
+  __parallel_for(runs, 1, [first, n, runs, &comp](::std::size_t r_begin,
+                                                  ::std::size_t r_end) {
+    for (::std::size_t r = r_begin; r < r_end; ++r) {
+      if (Stable)
+        STL_NAME::stable_sort(first + r * n / runs,
+                              first + (r + 1) * n / runs, comp);
+      else
+        STL_NAME::sort(first + r * n / runs, first + (r + 1) * n / runs,
+                       comp);
+    }
+  });
+
+  // the merge is cut into parts of a few per thread
+  const ::std::size_t merge_grain = __parallel_grain(n, concurrency);
+  __temporary_buffer<value_type> buffer(n);
+  bool in_buffer = false;
+  if (!::std::is_trivially_copyable<value_type>::value) {
+    value_type *data = buffer.data;
+    __parallel_for(n, merge_grain, [first, data](::std::size_t begin,
+                                                 ::std::size_t end) {
+      for (::std::size_t i = begin; i < end; ++i)
+        ::new (static_cast<void *>(data + i)) value_type(::std::move(first[i]));
+    });
+    buffer.constructed = n;
+    in_buffer = true;
+  }
+  for (::std::size_t width = 1; width < runs; width *= 2) {
+    if (in_buffer)
+      STL_NAME::__parallel_merge_round(buffer.data, first, n, runs, width,
+                                       merge_grain, comp);
+    else
+      STL_NAME::__parallel_merge_round(first, buffer.data, n, runs, width,
+                                       merge_grain, comp);
+    in_buffer = !in_buffer;
+  }
+  if (in_buffer) {
+    value_type *data = buffer.data;
+    __parallel_for(n, merge_grain, [first, data](::std::size_t begin,
+                                                 ::std::size_t end) {
+      ::std::move(data + begin, data + end, first + begin);
+    });
+  }
+}
+
+template <class ExecutionPolicy, class RandomAccessIterator, class Compare>
+void __sort(ExecutionPolicy &, RandomAccessIterator first,
+            RandomAccessIterator last, Compare &comp, false_type, false_type) {
+  STL_NAME::sort(first, last, comp);
+}
+
+template <class ExecutionPolicy, class RandomAccessIterator, class Compare>
+void __sort(ExecutionPolicy &policy, RandomAccessIterator first,
+            RandomAccessIterator last, Compare &comp, false_type, true_type) {
+  STL_NAME::__parallel_sort<false>(first, last, comp, __policy_grain(policy));
+}
+
+template <class ExecutionPolicy, class RandomAccessIterator, class Compare>
+void __sort(ExecutionPolicy &, RandomAccessIterator first,
+            RandomAccessIterator last, Compare &comp, true_type, false_type) {
+  STL_NAME::stable_sort(first, last, comp);
+}
+
+template <class ExecutionPolicy, class RandomAccessIterator, class Compare>
+void __sort(ExecutionPolicy &policy, RandomAccessIterator first,
+            RandomAccessIterator last, Compare &comp, true_type, true_type) {
+  STL_NAME::__parallel_sort<true>(first, last, comp, __policy_grain(policy));
+}
+
+template <class ExecutionPolicy, class RandomAccessIterator, class Compare>
+typename __enable_if_execution_policy<ExecutionPolicy, void>::type sort(
+    ExecutionPolicy &&policy, RandomAccessIterator first,
+    RandomAccessIterator last, Compare comp) {
+  STL_NAME::__sort(policy, first, last, comp, false_type(),
+                   __run_parallel<ExecutionPolicy, RandomAccessIterator>());
+}
+
+template <class ExecutionPolicy, class RandomAccessIterator>
+typename __enable_if_execution_policy<ExecutionPolicy, void>::type sort(
+    ExecutionPolicy &&policy, RandomAccessIterator first,
+    RandomAccessIterator last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::sort(policy, first, last, algorithm_utility::__less<type>{});
+}
+
+template <class ExecutionPolicy, class RandomAccessIterator, class Compare>
+typename __enable_if_execution_policy<ExecutionPolicy, void>::type stable_sort(
+    ExecutionPolicy &&policy, RandomAccessIterator first,
+    RandomAccessIterator last, Compare comp) {
+  STL_NAME::__sort(policy, first, last, comp, true_type(),
+                   __run_parallel<ExecutionPolicy, RandomAccessIterator>());
+}
+
+template <class ExecutionPolicy, class RandomAccessIterator>
+typename __enable_if_execution_policy<ExecutionPolicy, void>::type stable_sort(
+    ExecutionPolicy &&policy, RandomAccessIterator first,
+    RandomAccessIterator last) {
+  typedef typename iterator_traits<RandomAccessIterator>::value_type type;
+  STL_NAME::stable_sort(policy, first, last,
+                        algorithm_utility::__less<type>{});
+}
+
+STL_END
+
+#endif  // !_STL_EXECUTION__
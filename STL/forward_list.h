@@ -2,157 +2,1287 @@
 #define _STL_FORWARD_LIST__
 
 #include "Def/stldef.h"
+#include "__node_pool.h"
 
 STL_BEGIN
 
-/*
+template <class T, class VoidPtr>
+struct __forward_list_node;
+
+// forward_list node base type for pointer section
+// only one link, the node is one pointer plus value
+template <class T, class VoidPtr>
+struct __forward_list_node_base {
+  // >>> member types
+
+  typedef typename pointer_traits<VoidPtr>::template rebind<
+      __forward_list_node<T, VoidPtr>>
+      node_pointer_;
+  typedef typename pointer_traits<VoidPtr>::template rebind<
+      __forward_list_node_base<T, VoidPtr>>
+      link_pointer_;
+
+  __forward_list_node_base() : next_(nullptr) {}
+
+  // get pointer to base self
+  link_pointer_ self_() {
+    return pointer_traits<link_pointer_>::pointer_to(*this);
+  }
+
+  // a cast function from base to node
+  node_pointer_ as_node_() { return static_cast<node_pointer_>(self_()); }
+
+  // get position of value_
+  T *get_adressof_value_() { return ::std::addressof(as_node_()->value_); }
+
+  // pointer for link
+  link_pointer_ next_;
+};
+
+// forward_list node keep data section
+template <class T, class VoidPtr>
+struct __forward_list_node : public __forward_list_node_base<T, VoidPtr> {
+  // >>> member types
+  typedef __forward_list_node_base<T, VoidPtr> base_;
+  typedef typename base_::link_pointer_ link_pointer_;
+
+  // a cast function from node to base
+  link_pointer_ as_link_() {
+    return static_cast<link_pointer_>(base_::self_());
+  }
+
+  // data section
+  T value_;
+};
+
+template <class T, class Allocator>
+class forward_list;
+template <class T, class Allocator>
+class __forward_list_base;
+template <class T, class VoidPtr>
+class __forward_list_const_iterator;
+template <class T, class Allocator>
+class concurrent_stack;
+
+template <class T, class VoidPtr>
+class __forward_list_iterator {
+  // >>> memeber types
+
+  typedef typename __forward_list_node_base<T, VoidPtr>::link_pointer_
+      link_pointer_;
+
+ public:
+  // type traits
+  typedef forward_iterator_tag iterator_category;
+  typedef T value_type;
+  typedef value_type &reference;
+  typedef typename pointer_traits<VoidPtr>::template rebind<value_type> pointer;
+  typedef typename pointer_traits<pointer>::difference_type difference_type;
+
+ private:
+  // friend class
+  template <class, class>
+  friend class forward_list;
+  template <class, class>
+  friend class __forward_list_base;
+  template <class, class>
+  friend class __forward_list_const_iterator;
+
+ public:
+  // forward iterator interface
+  reference operator*() const { return ptr_->as_node_()->value_; }
+
+  pointer operator->() const {
+    return pointer_traits<pointer>::pointer_to(ptr_->as_node_()->value_);
+  }
+
+  __forward_list_iterator &operator++() {
+    ptr_ = ptr_->next_;
+    return *this;
+  }
+
+  __forward_list_iterator operator++(int) {
+    __forward_list_iterator old_iter(ptr_);
+    ptr_ = ptr_->next_;
+    return old_iter;
+  }
+
+  friend bool operator==(const __forward_list_iterator &lhs,
+                         const __forward_list_iterator &rhs) {
+    return lhs.ptr_ == rhs.ptr_;
+  }
+
+  friend bool operator!=(const __forward_list_iterator &lhs,
+                         const __forward_list_iterator &rhs) {
+    return !(lhs == rhs);
+  }
+
+  // >>> constructor
+ public:
+  // default constructor
+  __forward_list_iterator() noexcept : ptr_(nullptr) {}
+
+ private:
+  // for friend class
+  explicit __forward_list_iterator(link_pointer_ p) noexcept : ptr_(p) {}
+
+ private:
+  // data section
+  link_pointer_ ptr_;
+};
+
+template <class T, class VoidPtr>
+class __forward_list_const_iterator {
+  // >>> memeber types
+
+  typedef typename __forward_list_node_base<T, VoidPtr>::link_pointer_
+      link_pointer_;
+
+ public:
+  // type traits
+  typedef forward_iterator_tag iterator_category;
+  typedef T value_type;
+  typedef const value_type &reference;
+  typedef typename pointer_traits<VoidPtr>::template rebind<const value_type>
+      pointer;
+  typedef typename pointer_traits<pointer>::difference_type difference_type;
+
+ private:
+  template <class, class>
+  friend class forward_list;
+  template <class, class>
+  friend class __forward_list_base;
+
+ public:
+  // iterator interface
+  reference operator*() const { return ptr_->as_node_()->value_; }
+
+  pointer operator->() const {
+    return pointer_traits<pointer>::pointer_to(ptr_->as_node_()->value_);
+  }
+
+  __forward_list_const_iterator &operator++() {
+    ptr_ = ptr_->next_;
+    return *this;
+  }
+
+  __forward_list_const_iterator operator++(int) {
+    __forward_list_const_iterator old_iter(ptr_);
+    ptr_ = ptr_->next_;
+    return old_iter;
+  }
+
+  // iterator comparation
+  friend bool operator==(const __forward_list_const_iterator &lhs,
+                         const __forward_list_const_iterator &rhs) {
+    return lhs.ptr_ == rhs.ptr_;
+  }
+
+  friend bool operator!=(const __forward_list_const_iterator &lhs,
+                         const __forward_list_const_iterator &rhs) {
+    return !(lhs == rhs);
+  }
+
+  // >>> constructor
+ public:
+  // default constructor
+  __forward_list_const_iterator() noexcept : ptr_(nullptr) {}
+
+  // construct from __forward_list_iterator
+  __forward_list_const_iterator(
+      const __forward_list_iterator<T, VoidPtr> &iter)
+      : ptr_(iter.ptr_) {}
+
+ private:
+  // for friend class
+  explicit __forward_list_const_iterator(link_pointer_ p) noexcept : ptr_(p) {}
+
+ private:
+  // data section
+  link_pointer_ ptr_;
+};
+
+template <class T, class Allocator>
+class __forward_list_base {
+  // >>> member types
+
+ protected:
+  typedef T value_type;
+  typedef Allocator allocator_type;
+  typedef allocator_traits<allocator_type> alloc_traits_;
+  typedef typename alloc_traits_::size_type size_type;
+  typedef typename alloc_traits_::void_pointer void_pointer_;
+
+  // node and iterator
+  typedef __forward_list_node<value_type, void_pointer_> node_;
+  typedef __forward_list_node_base<value_type, void_pointer_> node_base_;
+  typedef typename node_::link_pointer_ link_pointer_;
+  typedef typename node_::node_pointer_ node_pointer_;
+  typedef __forward_list_iterator<value_type, void_pointer_> iterator;
+  typedef __forward_list_const_iterator<value_type, void_pointer_>
+      const_iterator;
+  typedef typename iterator::difference_type difference_type;
+  // rebind allocator type
+  typedef typename alloc_traits_::template rebind_alloc<node_>
+      node_allocator_type_;
+  typedef allocator_traits<node_allocator_type_> node_alloc_traits_;
+  // cache of released node
+  typedef __node_pool<node_allocator_type_> node_pool_type_;
+
+ protected:
+  // >>> constructor
+  // default constructor
+  __forward_list_base() noexcept(
+      is_nothrow_default_constructible<node_allocator_type_>::value)
+      : node_alloc_(node_allocator_type_()) {}
+
+  // no copy operation
+  __forward_list_base(const __forward_list_base &) = delete;
+
+  __forward_list_base &operator=(const __forward_list_base &) = delete;
+
+  // construct with given node allocator
+  explicit __forward_list_base(const allocator_type &alloc)
+      : node_alloc_(alloc) {}
+
+  // >>> destructor
+  ~__forward_list_base() {
+    clear();
+    node_pool_.release_(node_alloc_);
+  }
+
+  // access head_, remove cv qualifier before access head_
+  link_pointer_ before_head_link_() const noexcept {
+    return const_cast<node_base_ &>(head_).self_();
+  }
+
+  // >>> access
+  iterator before_begin() noexcept { return iterator(before_head_link_()); }
+
+  const_iterator before_begin() const noexcept {
+    return const_iterator(before_head_link_());
+  }
+
+  iterator begin() noexcept { return iterator(head_.next_); }
+
+  const_iterator begin() const noexcept { return const_iterator(head_.next_); }
+
+  iterator end() noexcept { return iterator(nullptr); }
+
+  const_iterator end() const noexcept { return const_iterator(nullptr); }
+
+  // check isempty
+  bool empty() const noexcept { return head_.next_ == nullptr; }
+
+  // swap operation
+  void swap(__forward_list_base &x) noexcept(
+      alloc_traits_::propagate_on_container_swap::value ||
+      alloc_traits_::is_always_equal::value);
+
+  // clear all node
+  void clear() noexcept;
+
+  // destroy value of node and give the node back to pool
+  void destroy_node_(link_pointer_ p) noexcept {
+    node_alloc_traits_::destroy(node_alloc_, p->get_adressof_value_());
+    node_pool_.deallocate_(node_alloc_, p->as_node_());
+  }
+
+  // copy assignment of allocator
+  void copy_assign_alloc_(const __forward_list_base &x) {
+    copy_assign_alloc_(
+        x, integral_constant<bool,
+                             node_alloc_traits_::
+                                 propagate_on_container_copy_assignment::value>());
+  }
+
+  // move assignment for allocator
+  void move_assign_alloc_(__forward_list_base &x) noexcept(
+      !node_alloc_traits_::propagate_on_container_move_assignment::value ||
+      ::std::is_nothrow_move_assignable<allocator_type>::value) {
+    move_assign_alloc_(
+        x,
+        integral_constant<bool,
+                          node_alloc_traits_::
+                              propagate_on_container_move_assignment::value>());
+  }
+
+ private:
+  // >>> private auxiliary function
+  // propagate_on_container_copy_assignment
+  // allocator need to be copied when container is copy-assigned
+  void copy_assign_alloc_(const __forward_list_base &x, true_type) {
+    // clear when allocators do not compare equal.
+    // cached node belong to the old allocator, release them too.
+    if (node_alloc_ != x.node_alloc_) {
+      clear();
+      node_pool_.release_(node_alloc_);
+    }
+    node_alloc_ = x.node_alloc_;
+  }
+
+  // noop for allocator.
+  void copy_assign_alloc_(const __forward_list_base &, false_type) {}
+
+  // propagate_on_container_move_assignment
+  // allocattor need to be moved when container is move-assigned
+  // noexcept if allocator is nothrow move assignable
+  void move_assign_alloc_(__forward_list_base &x, true_type) noexcept(
+      ::std::is_nothrow_move_assignable<allocator_type>::value) {
+    node_pool_.release_(node_alloc_);
+    node_alloc_ = ::std::move(x.node_alloc_);
+  }
+
+  // noop, allocator noexcept
+  void move_assign_alloc_(__forward_list_base &, false_type) noexcept {}
+
+  // >>> data member
+ protected:
+  node_base_ head_;
+  node_allocator_type_ node_alloc_;
+  node_pool_type_ node_pool_;
+};
+
+// clear all data in the forward_list base
+template <class T, class Allocator>
+void __forward_list_base<T, Allocator>::clear() noexcept {
+  link_pointer_ first = head_.next_;
+  while (first != nullptr) {
+    link_pointer_ next = first->next_;
+    destroy_node_(first);
+    first = next;
+  }
+  head_.next_ = nullptr;
+}
+
+// swap forward_list base class
+template <class T, class Allocator>
+void __forward_list_base<T, Allocator>::swap(__forward_list_base &x) noexcept(
+    alloc_traits_::propagate_on_container_swap::value ||
+    alloc_traits_::is_always_equal::value) {
+  __swap_allocator(node_alloc_, x.node_alloc_);
+  ::std::swap(head_.next_, x.head_.next_);
+  node_pool_.swap(x.node_pool_);
+}
+
 template <class T, class Allocator = allocator<T>>
-class forward_list
-{
-public:
-    typedef T         value_type;
-    typedef Allocator allocator_type;
-
-    typedef value_type&                                                reference;
-    typedef const value_type&                                          const_reference;
-    typedef typename allocator_traits<allocator_type>::pointer         pointer;
-    typedef typename allocator_traits<allocator_type>::const_pointer   const_pointer;
-    typedef typename allocator_traits<allocator_type>::size_type       size_type;
-    typedef typename allocator_traits<allocator_type>::difference_type difference_type;
-
-    typedef <details> iterator;
-    typedef <details> const_iterator;
-
-    forward_list()
-        noexcept(is_nothrow_default_constructible<allocator_type>::value);
-    explicit forward_list(const allocator_type& a);
-    explicit forward_list(size_type n);
-    explicit forward_list(size_type n, const allocator_type& a); // C++14
-    forward_list(size_type n, const value_type& v);
-    forward_list(size_type n, const value_type& v, const allocator_type& a);
-    template <class InputIterator>
-        forward_list(InputIterator first, InputIterator last);
-    template <class InputIterator>
-        forward_list(InputIterator first, InputIterator last, const allocator_type& a);
-    forward_list(const forward_list& x);
-    forward_list(const forward_list& x, const allocator_type& a);
-    forward_list(forward_list&& x)
-        noexcept(is_nothrow_move_constructible<allocator_type>::value);
-    forward_list(forward_list&& x, const allocator_type& a);
-    forward_list(initializer_list<value_type> il);
-    forward_list(initializer_list<value_type> il, const allocator_type& a);
-
-    ~forward_list();
-
-    forward_list& operator=(const forward_list& x);
-    forward_list& operator=(forward_list&& x)
-        noexcept(
-             allocator_type::propagate_on_container_move_assignment::value &&
-             is_nothrow_move_assignable<allocator_type>::value);
-    forward_list& operator=(initializer_list<value_type> il);
-
-    template <class InputIterator>
-        void assign(InputIterator first, InputIterator last);
-    void assign(size_type n, const value_type& v);
-    void assign(initializer_list<value_type> il);
-
-    allocator_type get_allocator() const noexcept;
-
-    iterator       begin() noexcept;
-    const_iterator begin() const noexcept;
-    iterator       end() noexcept;
-    const_iterator end() const noexcept;
-
-    const_iterator cbegin() const noexcept;
-    const_iterator cend() const noexcept;
-
-    iterator       before_begin() noexcept;
-    const_iterator before_begin() const noexcept;
-    const_iterator cbefore_begin() const noexcept;
-
-    bool empty() const noexcept;
-    size_type max_size() const noexcept;
-
-    reference       front();
-    const_reference front() const;
-
-    template <class... Args> reference emplace_front(Args&&... args);  // reference in C++17
-    void push_front(const value_type& v);
-    void push_front(value_type&& v);
-
-    void pop_front();
-
-    template <class... Args>
-        iterator emplace_after(const_iterator p, Args&&... args);
-    iterator insert_after(const_iterator p, const value_type& v);
-    iterator insert_after(const_iterator p, value_type&& v);
-    iterator insert_after(const_iterator p, size_type n, const value_type& v);
-    template <class InputIterator>
-        iterator insert_after(const_iterator p,
-                              InputIterator first, InputIterator last);
-    iterator insert_after(const_iterator p, initializer_list<value_type> il);
-
-    iterator erase_after(const_iterator p);
-    iterator erase_after(const_iterator first, const_iterator last);
-
-    void swap(forward_list& x)
-        noexcept(allocator_traits<allocator_type>::is_always_equal::value);  // C++17
-
-    void resize(size_type n);
-    void resize(size_type n, const value_type& v);
-    void clear() noexcept;
-
-    void splice_after(const_iterator p, forward_list& x);
-    void splice_after(const_iterator p, forward_list&& x);
-    void splice_after(const_iterator p, forward_list& x, const_iterator i);
-    void splice_after(const_iterator p, forward_list&& x, const_iterator i);
-    void splice_after(const_iterator p, forward_list& x,
-                      const_iterator first, const_iterator last);
-    void splice_after(const_iterator p, forward_list&& x,
-                      const_iterator first, const_iterator last);
-    void remove(const value_type& v);
-    template <class Predicate> void remove_if(Predicate pred);
-    void unique();
-    template <class BinaryPredicate> void unique(BinaryPredicate binary_pred);
-    void merge(forward_list& x);
-    void merge(forward_list&& x);
-    template <class Compare> void merge(forward_list& x, Compare comp);
-    template <class Compare> void merge(forward_list&& x, Compare comp);
-    void sort();
-    template <class Compare> void sort(Compare comp);
-    void reverse() noexcept;
+class forward_list : private __forward_list_base<T, Allocator> {
+  // >>> member types
+
+  typedef __forward_list_base<T, Allocator> base_;
+  typedef typename base_::node_ node_;
+  typedef typename base_::node_allocator_type_ node_allocator_type_;
+  typedef typename base_::node_alloc_traits_ node_alloc_traits_;
+  typedef typename base_::node_base_ node_base_;
+  typedef typename base_::link_pointer_ link_pointer_;
+  typedef typename base_::node_pointer_ node_pointer_;
+
+  // type for RAII to keep exception safe when constructor of value throw
+  typedef __allocator_destructor<node_allocator_type_> node_destructor_;
+  typedef unique_ptr<node_, node_destructor_> hold_pointer_;
+
+  // share the node layout, splice the whole chain in
+  template <class, class>
+  friend class concurrent_stack;
+
+ public:
+  typedef T value_type;
+  typedef Allocator allocator_type;
+  typedef value_type &reference;
+  typedef const value_type &const_reference;
+  typedef typename allocator_traits<allocator_type>::pointer pointer;
+  typedef typename allocator_traits<allocator_type>::const_pointer
+      const_pointer;
+  typedef typename base_::size_type size_type;
+  typedef typename base_::difference_type difference_type;
+  typedef typename base_::iterator iterator;
+  typedef typename base_::const_iterator const_iterator;
+
+  // >>> constructors
+
+ public:
+  forward_list() noexcept(
+      is_nothrow_default_constructible<allocator_type>::value) {}
+
+  explicit forward_list(const allocator_type &a) : base_(a) {}
+
+  explicit forward_list(size_type n);
+
+  explicit forward_list(size_type n, const allocator_type &a);
+
+  forward_list(size_type n, const value_type &value);
+
+  forward_list(size_type n, const value_type &value, const allocator_type &a);
+
+  // construct with given range
+  template <class InputIterator>
+  forward_list(InputIterator first,
+               typename enable_if<__is_input_iterator<InputIterator>::value,
+                                  InputIterator>::type last);
+
+  template <class InputIterator>
+  forward_list(InputIterator first,
+               typename enable_if<__is_input_iterator<InputIterator>::value,
+                                  InputIterator>::type last,
+               const allocator_type &a);
+
+  // copy constructor
+  forward_list(const forward_list &x);
+
+  forward_list(const forward_list &x, const allocator_type &a);
+
+  // move constructor
+  forward_list(forward_list &&x) noexcept(
+      is_nothrow_move_constructible<allocator_type>::value);
+
+  forward_list(forward_list &&x, const allocator_type &a);
+
+  // construct with given initializer
+  forward_list(initializer_list<value_type> init);
+
+  forward_list(initializer_list<value_type> init, const allocator_type &a);
+
+  // >>> assignment operator
+
+  forward_list &operator=(const forward_list &x);
+
+  forward_list &operator=(forward_list &&x) noexcept(
+      node_alloc_traits_::propagate_on_container_move_assignment::value
+          &&is_nothrow_move_assignable<allocator_type>::value);
+
+  forward_list &operator=(initializer_list<value_type> init);
+
+  template <class InputIterator>
+  void assign(InputIterator first,
+              typename enable_if<__is_input_iterator<InputIterator>::value,
+                                 InputIterator>::type last);
+
+  void assign(size_type n, const value_type &val);
+
+  void assign(initializer_list<value_type> init);
+
+  void swap(forward_list &x) noexcept(
+      allocator_traits<allocator_type>::is_always_equal::value);
+
+  // >>> allocator
+
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(this->node_alloc_);
+  }
+
+  // >>> iterator
+  iterator before_begin() noexcept { return base_::before_begin(); }
+
+  const_iterator before_begin() const noexcept {
+    return base_::before_begin();
+  }
+
+  iterator begin() noexcept { return base_::begin(); }
+
+  const_iterator begin() const noexcept { return base_::begin(); }
+
+  iterator end() noexcept { return base_::end(); }
+
+  const_iterator end() const noexcept { return base_::end(); }
+
+  // const iterator
+  const_iterator cbefore_begin() const noexcept { return before_begin(); }
+
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  const_iterator cend() const noexcept { return end(); }
+
+  // >>> capacity
+
+  bool empty() const noexcept { return base_::empty(); }
+
+  size_type max_size() const noexcept {
+    return node_alloc_traits_::max_size(this->node_alloc_);
+  }
+
+  // >>> element acces
+
+  reference front() {
+    assert(!empty());
+    return this->head_.next_->as_node_()->value_;
+  }
+
+  const_reference front() const {
+    assert(!empty());
+    return this->head_.next_->as_node_()->value_;
+  }
+
+  // >>> modifier
+  // front
+  template <class... Args>
+  reference emplace_front(Args &&... args);
+
+  void push_front(const value_type &val);
+
+  void push_front(value_type &&val);
+
+  void pop_front();
+
+  // insert after
+  template <class... Args>
+  iterator emplace_after(const_iterator position, Args &&... args);
+
+  iterator insert_after(const_iterator position, const value_type &val);
+
+  iterator insert_after(const_iterator position, value_type &&val);
+
+  iterator insert_after(const_iterator position, size_type n,
+                        const value_type &val);
+
+  template <class InputIterator>
+  iterator insert_after(
+      const_iterator position, InputIterator first,
+      typename enable_if<__is_input_iterator<InputIterator>::value,
+                         InputIterator>::type last);
+
+  iterator insert_after(const_iterator position,
+                        initializer_list<value_type> init);
+
+  // erase after
+  iterator erase_after(const_iterator position);
+
+  iterator erase_after(const_iterator first, const_iterator last);
+
+  void clear() noexcept;
+
+  // >>> size
+
+  void resize(size_type sz);
+
+  void resize(size_type sz, const value_type &val);
+
+  // >>> algorithm
+
+  void splice_after(const_iterator position, forward_list &x);
+
+  void splice_after(const_iterator position, forward_list &&x);
+
+  void splice_after(const_iterator position, forward_list &x,
+                    const_iterator i);
+
+  void splice_after(const_iterator position, forward_list &&x,
+                    const_iterator i);
+
+  void splice_after(const_iterator position, forward_list &x,
+                    const_iterator first, const_iterator last);
+
+  void splice_after(const_iterator position, forward_list &&x,
+                    const_iterator first, const_iterator last);
+
+  void remove(const value_type &val);
+
+  template <class Predicate>
+  void remove_if(Predicate pred);
+
+  void unique();
+
+  template <class BinaryPredicate>
+  void unique(BinaryPredicate binary_pred);
+
+  void merge(forward_list &x);
+
+  void merge(forward_list &&x);
+
+  template <class Compare>
+  void merge(forward_list &x, Compare comp);
+
+  template <class Compare>
+  void merge(forward_list &&x, Compare comp);
+
+  void sort();
+
+  template <class Compare>
+  void sort(Compare comp);
+
+  void reverse() noexcept;
+
+ private:
+  // >>> private auxiliary function
+  // get a node from pool or allocator
+  hold_pointer_ allocate_node_();
+
+  // create a unlinked node, value is constructed with args
+  template <class... Args>
+  node_pointer_ create_node_(Args &&... args);
+
+  // destroy a chain of unlinked node start at first
+  void destroy_chain_(link_pointer_ first) noexcept;
+
+  // link chain [first, last] after pos
+  static void link_chain_after_(link_pointer_ pos, link_pointer_ first,
+                                link_pointer_ last) noexcept;
+
+  // merge two sorted chain, return head of result chain
+  template <class Compare>
+  static link_pointer_ merge_chain_(link_pointer_ first1,
+                                    link_pointer_ first2, Compare &comp);
+
+  void move_assign_(forward_list &x, true_type);
+
+  void move_assign_(forward_list &x, false_type);
 };
 
+// >>> private auxiliary function
+
+template <class T, class Allocator>
+typename forward_list<T, Allocator>::hold_pointer_
+forward_list<T, Allocator>::allocate_node_() {
+  node_pointer_ p = this->node_pool_.allocate_(this->node_alloc_);
+  return hold_pointer_(p, node_destructor_(this->node_alloc_, 1));
+}
+
+template <class T, class Allocator>
+template <class... Args>
+typename forward_list<T, Allocator>::node_pointer_
+forward_list<T, Allocator>::create_node_(Args &&... args) {
+  hold_pointer_ hold_ptr = allocate_node_();
+  node_alloc_traits_::construct(this->node_alloc_,
+                                hold_ptr->get_adressof_value_(),
+                                ::std::forward<Args>(args)...);
+  hold_ptr->next_ = nullptr;
+  return hold_ptr.release();
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::destroy_chain_(link_pointer_ first) noexcept {
+  while (first != nullptr) {
+    link_pointer_ next = first->next_;
+    this->destroy_node_(first);
+    first = next;
+  }
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::link_chain_after_(link_pointer_ pos,
+                                                   link_pointer_ first,
+                                                   link_pointer_ last) noexcept {
+  last->next_ = pos->next_;
+  pos->next_ = first;
+}
+
+// stable merge, element of first1 goes first if equal
+template <class T, class Allocator>
+template <class Compare>
+typename forward_list<T, Allocator>::link_pointer_
+forward_list<T, Allocator>::merge_chain_(link_pointer_ first1,
+                                         link_pointer_ first2, Compare &comp) {
+  node_base_ head;
+  link_pointer_ tail = head.self_();
+  while (first1 != nullptr && first2 != nullptr) {
+    if (comp(first2->as_node_()->value_, first1->as_node_()->value_)) {
+      tail->next_ = first2;
+      first2 = first2->next_;
+    } else {
+      tail->next_ = first1;
+      first1 = first1->next_;
+    }
+    tail = tail->next_;
+  }
+  tail->next_ = first1 != nullptr ? first1 : first2;
+  return head.next_;
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::move_assign_(forward_list &x, true_type) {
+  clear();
+  base_::move_assign_alloc_(x);
+  this->head_.next_ = x.head_.next_;
+  x.head_.next_ = nullptr;
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::move_assign_(forward_list &x, false_type) {
+  if (this->node_alloc_ != x.node_alloc_)
+    // if node_alloc_ != x.node_alloc , result in member-wise move
+    assign(::std::move_iterator<iterator>(x.begin()),
+           ::std::move_iterator<iterator>(x.end()));
+  else
+    move_assign_(x, true_type());
+}
+
+// >>> constructor
+
+template <class T, class Allocator>
+forward_list<T, Allocator>::forward_list(size_type n) {
+  resize(n);
+}
+
+template <class T, class Allocator>
+forward_list<T, Allocator>::forward_list(size_type n, const allocator_type &a)
+    : base_(a) {
+  resize(n);
+}
+
+template <class T, class Allocator>
+forward_list<T, Allocator>::forward_list(size_type n, const value_type &value) {
+  insert_after(before_begin(), n, value);
+}
+
+template <class T, class Allocator>
+forward_list<T, Allocator>::forward_list(size_type n, const value_type &value,
+                                         const allocator_type &a)
+    : base_(a) {
+  insert_after(before_begin(), n, value);
+}
+
+// construct with given range
+template <class T, class Allocator>
+template <class InputIterator>
+forward_list<T, Allocator>::forward_list(
+    InputIterator first,
+    typename enable_if<__is_input_iterator<InputIterator>::value,
+                       InputIterator>::type last) {
+  insert_after(before_begin(), first, last);
+}
+
+template <class T, class Allocator>
+template <class InputIterator>
+forward_list<T, Allocator>::forward_list(
+    InputIterator first,
+    typename enable_if<__is_input_iterator<InputIterator>::value,
+                       InputIterator>::type last,
+    const allocator_type &a)
+    : base_(a) {
+  insert_after(before_begin(), first, last);
+}
+
+// copy constructor
+template <class T, class Allocator>
+forward_list<T, Allocator>::forward_list(const forward_list &x)
+    : base_(node_alloc_traits_::select_on_container_copy_construction(
+          x.node_alloc_)) {
+  insert_after(before_begin(), x.begin(), x.end());
+}
+
+template <class T, class Allocator>
+forward_list<T, Allocator>::forward_list(const forward_list &x,
+                                         const allocator_type &a)
+    : base_(a) {
+  insert_after(before_begin(), x.begin(), x.end());
+}
+
+// move constructor
+// cached node of x stay in x, only the chain is taken over
+template <class T, class Allocator>
+forward_list<T, Allocator>::forward_list(forward_list &&x) noexcept(
+    is_nothrow_move_constructible<allocator_type>::value)
+    : base_(x.node_alloc_) {
+  this->head_.next_ = x.head_.next_;
+  x.head_.next_ = nullptr;
+}
+
+template <class T, class Allocator>
+forward_list<T, Allocator>::forward_list(forward_list &&x,
+                                         const allocator_type &a)
+    : base_(a) {
+  if (this->node_alloc_ == x.node_alloc_) {
+    // take over the chain if allocator equal
+    this->head_.next_ = x.head_.next_;
+    x.head_.next_ = nullptr;
+  } else {
+    // if a != x.node_alloc_, result in member-wise move
+    insert_after(before_begin(), ::std::move_iterator<iterator>(x.begin()),
+                 ::std::move_iterator<iterator>(x.end()));
+  }
+}
+
+// construct with initilaizer_list
+template <class T, class Allocator>
+forward_list<T, Allocator>::forward_list(initializer_list<value_type> init) {
+  insert_after(before_begin(), init.begin(), init.end());
+}
+
+template <class T, class Allocator>
+forward_list<T, Allocator>::forward_list(initializer_list<value_type> init,
+                                         const allocator_type &a)
+    : base_(a) {
+  insert_after(before_begin(), init.begin(), init.end());
+}
+
+// >>> assignment operator
+template <class T, class Allocator>
+forward_list<T, Allocator> &forward_list<T, Allocator>::operator=(
+    const forward_list &x) {
+  // check self assignment
+  if (this != &x) {
+    base_::copy_assign_alloc_(x);
+    assign(x.begin(), x.end());
+  }
+  return *this;
+}
+
+template <class T, class Allocator>
+forward_list<T, Allocator> &forward_list<T, Allocator>::operator=(
+    forward_list &&x) noexcept(node_alloc_traits_::
+                                   propagate_on_container_move_assignment::value
+                                       &&is_nothrow_move_assignable<
+                                           allocator_type>::value) {
+  move_assign_(
+      x,
+      integral_constant<
+          bool,
+          node_alloc_traits_::propagate_on_container_move_assignment::value>());
+  return *this;
+}
+
+template <class T, class Allocator>
+forward_list<T, Allocator> &forward_list<T, Allocator>::operator=(
+    initializer_list<value_type> init) {
+  assign(init.begin(), init.end());
+  return *this;
+}
+
+// reuse the existing node first, then insert or erase the rest
+template <class T, class Allocator>
+template <class InputIterator>
+void forward_list<T, Allocator>::assign(
+    InputIterator first,
+    typename enable_if<__is_input_iterator<InputIterator>::value,
+                       InputIterator>::type last) {
+  iterator prev = before_begin(), iter = begin(), iter_end = end();
+  for (; iter != iter_end && first != last; ++first, ++iter, ++prev)
+    *iter = *first;
+  if (iter == iter_end)
+    insert_after(prev, first, last);
+  else
+    erase_after(prev, iter_end);
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::assign(size_type n, const value_type &val) {
+  iterator prev = before_begin(), iter = begin(), iter_end = end();
+  for (; iter != iter_end && n > 0; --n, ++iter, ++prev) *iter = val;
+  if (iter == iter_end)
+    insert_after(prev, n, val);
+  else
+    erase_after(prev, iter_end);
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::assign(initializer_list<value_type> init) {
+  assign(init.begin(), init.end());
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::swap(forward_list &x) noexcept(
+    allocator_traits<allocator_type>::is_always_equal::value) {
+  base_::swap(x);
+}
+
+// >>> modifier
+// front
+template <class T, class Allocator>
+template <class... Args>
+typename forward_list<T, Allocator>::reference
+forward_list<T, Allocator>::emplace_front(Args &&... args) {
+  node_pointer_ p = create_node_(::std::forward<Args>(args)...);
+  link_chain_after_(this->before_head_link_(), p->as_link_(), p->as_link_());
+  return p->value_;
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::push_front(const value_type &val) {
+  node_pointer_ p = create_node_(val);
+  link_chain_after_(this->before_head_link_(), p->as_link_(), p->as_link_());
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::push_front(value_type &&val) {
+  node_pointer_ p = create_node_(::std::move(val));
+  link_chain_after_(this->before_head_link_(), p->as_link_(), p->as_link_());
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::pop_front() {
+  assert(!empty());
+  link_pointer_ p = this->head_.next_;
+  this->head_.next_ = p->next_;
+  this->destroy_node_(p);
+}
+
+// insert after
+template <class T, class Allocator>
+template <class... Args>
+typename forward_list<T, Allocator>::iterator
+forward_list<T, Allocator>::emplace_after(const_iterator position,
+                                          Args &&... args) {
+  node_pointer_ p = create_node_(::std::forward<Args>(args)...);
+  link_chain_after_(position.ptr_, p->as_link_(), p->as_link_());
+  return iterator(p->as_link_());
+}
+
+template <class T, class Allocator>
+typename forward_list<T, Allocator>::iterator
+forward_list<T, Allocator>::insert_after(const_iterator position,
+                                         const value_type &val) {
+  node_pointer_ p = create_node_(val);
+  link_chain_after_(position.ptr_, p->as_link_(), p->as_link_());
+  return iterator(p->as_link_());
+}
+
+template <class T, class Allocator>
+typename forward_list<T, Allocator>::iterator
+forward_list<T, Allocator>::insert_after(const_iterator position,
+                                         value_type &&val) {
+  node_pointer_ p = create_node_(::std::move(val));
+  link_chain_after_(position.ptr_, p->as_link_(), p->as_link_());
+  return iterator(p->as_link_());
+}
+
+// build the whole chain first, so nothing is linked if a constructor throws
+template <class T, class Allocator>
+typename forward_list<T, Allocator>::iterator
+forward_list<T, Allocator>::insert_after(const_iterator position, size_type n,
+                                         const value_type &val) {
+  if (n > 0) {
+    link_pointer_ first = create_node_(val)->as_link_();
+    link_pointer_ last = first;
+    try {
+      // create the node chain
+      for (--n; n > 0; --n) {
+        // may throw
+        last->next_ = create_node_(val)->as_link_();
+        last = last->next_;
+      }
+    } catch (...) {
+      destroy_chain_(first);
+      throw;
+    }
+    link_chain_after_(position.ptr_, first, last);
+    // return the last insert position
+    return iterator(last);
+  }
+  // if n == 0, return position
+  return iterator(position.ptr_);
+}
+
+template <class T, class Allocator>
+template <class InputIterator>
+typename forward_list<T, Allocator>::iterator
+forward_list<T, Allocator>::insert_after(
+    const_iterator position, InputIterator first,
+    typename enable_if<__is_input_iterator<InputIterator>::value,
+                       InputIterator>::type last) {
+  if (first != last) {
+    link_pointer_ chain_first = create_node_(*first)->as_link_();
+    link_pointer_ chain_last = chain_first;
+    try {
+      // create the node chain
+      for (++first; first != last; ++first) {
+        // may throw
+        chain_last->next_ = create_node_(*first)->as_link_();
+        chain_last = chain_last->next_;
+      }
+    } catch (...) {
+      destroy_chain_(chain_first);
+      throw;
+    }
+    link_chain_after_(position.ptr_, chain_first, chain_last);
+    return iterator(chain_last);
+  }
+  return iterator(position.ptr_);
+}
+
+template <class T, class Allocator>
+typename forward_list<T, Allocator>::iterator
+forward_list<T, Allocator>::insert_after(const_iterator position,
+                                         initializer_list<value_type> init) {
+  return insert_after(position, init.begin(), init.end());
+}
+
+// erase after
+template <class T, class Allocator>
+typename forward_list<T, Allocator>::iterator
+forward_list<T, Allocator>::erase_after(const_iterator position) {
+  link_pointer_ p = position.ptr_->next_;
+  position.ptr_->next_ = p->next_;
+  this->destroy_node_(p);
+  return iterator(position.ptr_->next_);
+}
+
+// erase the open range (first, last)
+template <class T, class Allocator>
+typename forward_list<T, Allocator>::iterator
+forward_list<T, Allocator>::erase_after(const_iterator first,
+                                        const_iterator last) {
+  link_pointer_ p = first.ptr_->next_;
+  if (p != last.ptr_) {
+    first.ptr_->next_ = last.ptr_;
+    while (p != last.ptr_) {
+      link_pointer_ next = p->next_;
+      this->destroy_node_(p);
+      p = next;
+    }
+  }
+  return iterator(last.ptr_);
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::clear() noexcept {
+  base_::clear();
+}
+
+// >>> size
+template <class T, class Allocator>
+void forward_list<T, Allocator>::resize(size_type sz) {
+  iterator prev = before_begin(), iter = begin(), iter_end = end();
+  for (; iter != iter_end && sz > 0; --sz, ++iter, ++prev)
+    ;
+  if (iter != iter_end)
+    erase_after(prev, iter_end);
+  else
+    for (; sz > 0; --sz) prev = emplace_after(prev);
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::resize(size_type sz, const value_type &val) {
+  iterator prev = before_begin(), iter = begin(), iter_end = end();
+  for (; iter != iter_end && sz > 0; --sz, ++iter, ++prev)
+    ;
+  if (iter != iter_end)
+    erase_after(prev, iter_end);
+  else
+    insert_after(prev, sz, val);
+}
+
+// >>> algorithm
+// algorithm func with other forward_list x would be undefined-behavior if
+// x.node_alloc_ != this->node_alloc_
+
+// splice operation
+template <class T, class Allocator>
+void forward_list<T, Allocator>::splice_after(const_iterator position,
+                                              forward_list &x) {
+  if (!x.empty()) {
+    link_pointer_ ptr_last = x.head_.next_;
+    // find the last node of x
+    for (; ptr_last->next_ != nullptr; ptr_last = ptr_last->next_)
+      ;
+    link_chain_after_(position.ptr_, x.head_.next_, ptr_last);
+    x.head_.next_ = nullptr;
+  }
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::splice_after(const_iterator position,
+                                              forward_list &&x) {
+  splice_after(position, x);
+}
+
+// move the element after iter
+template <class T, class Allocator>
+void forward_list<T, Allocator>::splice_after(const_iterator position,
+                                              forward_list &,
+                                              const_iterator iter) {
+  link_pointer_ ptr = iter.ptr_->next_;
+  if (position.ptr_ != iter.ptr_ && position.ptr_ != ptr) {
+    // unlink ptr
+    iter.ptr_->next_ = ptr->next_;
+    link_chain_after_(position.ptr_, ptr, ptr);
+  }
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::splice_after(const_iterator position,
+                                              forward_list &&x,
+                                              const_iterator iter) {
+  splice_after(position, x, iter);
+}
+
+// move the open range (first, last)
+template <class T, class Allocator>
+void forward_list<T, Allocator>::splice_after(const_iterator position,
+                                              forward_list &,
+                                              const_iterator first,
+                                              const_iterator last) {
+  link_pointer_ ptr_first = first.ptr_->next_;
+  if (ptr_first != last.ptr_) {
+    link_pointer_ ptr_last = ptr_first;
+    // find the last node of the range
+    for (; ptr_last->next_ != last.ptr_; ptr_last = ptr_last->next_)
+      ;
+    // unlink [ptr_first, ptr_last]
+    first.ptr_->next_ = last.ptr_;
+    link_chain_after_(position.ptr_, ptr_first, ptr_last);
+  }
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::splice_after(const_iterator position,
+                                              forward_list &&x,
+                                              const_iterator first,
+                                              const_iterator last) {
+  splice_after(position, x, first, last);
+}
+
+// val may refer to an element of *this, so removed node is kept in a
+// chain and destroyed after the scan
+template <class T, class Allocator>
+void forward_list<T, Allocator>::remove(const value_type &val) {
+  node_base_ removed;
+  link_pointer_ removed_last = removed.self_();
+  for (link_pointer_ prev = this->before_head_link_(); prev->next_ != nullptr;) {
+    link_pointer_ p = prev->next_;
+    if (p->as_node_()->value_ == val) {
+      prev->next_ = p->next_;
+      removed_last->next_ = p;
+      removed_last = p;
+    } else
+      prev = p;
+  }
+  removed_last->next_ = nullptr;
+  destroy_chain_(removed.next_);
+}
+
+template <class T, class Allocator>
+template <class Predicate>
+void forward_list<T, Allocator>::remove_if(Predicate pred) {
+  for (link_pointer_ prev = this->before_head_link_(); prev->next_ != nullptr;) {
+    link_pointer_ p = prev->next_;
+    if (pred(p->as_node_()->value_)) {
+      prev->next_ = p->next_;
+      this->destroy_node_(p);
+    } else
+      prev = p;
+  }
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::unique() {
+  unique(::std::equal_to<value_type>{});
+}
+
+template <class T, class Allocator>
+template <class BinaryPredicate>
+void forward_list<T, Allocator>::unique(BinaryPredicate binary_pred) {
+  for (link_pointer_ p = this->head_.next_; p != nullptr; p = p->next_) {
+    // erase the range equal to *p
+    while (p->next_ != nullptr &&
+           binary_pred(p->as_node_()->value_, p->next_->as_node_()->value_)) {
+      link_pointer_ to_destroy = p->next_;
+      p->next_ = to_destroy->next_;
+      this->destroy_node_(to_destroy);
+    }
+  }
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::merge(forward_list &x) {
+  merge(x, ::std::less<value_type>{});
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::merge(forward_list &&x) {
+  merge(x);
+}
+
+template <class T, class Allocator>
+template <class Compare>
+void forward_list<T, Allocator>::merge(forward_list &x, Compare comp) {
+  if (this != &x) {
+    this->head_.next_ = merge_chain_(this->head_.next_, x.head_.next_, comp);
+    x.head_.next_ = nullptr;
+  }
+}
+
+template <class T, class Allocator>
+template <class Compare>
+void forward_list<T, Allocator>::merge(forward_list &&x, Compare comp) {
+  merge(x, comp);
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::sort() {
+  sort(::std::less<value_type>{});
+}
+
+// bottom-up merge sort on the chain, bucket i keeps a sorted run of 2^i node
+template <class T, class Allocator>
+template <class Compare>
+void forward_list<T, Allocator>::sort(Compare comp) {
+  link_pointer_ bucket[64] = {};
+  int bucket_top = 0;
+  for (link_pointer_ p = this->head_.next_; p != nullptr;) {
+    link_pointer_ carry = p;
+    p = p->next_;
+    carry->next_ = nullptr;
+    int i = 0;
+    for (; i < bucket_top && bucket[i] != nullptr; ++i) {
+      // bucket[i] keeps earlier element, merge it first for stability
+      carry = merge_chain_(bucket[i], carry, comp);
+      bucket[i] = nullptr;
+    }
+    bucket[i] = carry;
+    i == bucket_top ? ++bucket_top : 0;
+  }
+  link_pointer_ result = nullptr;
+  for (int i = 0; i < bucket_top; ++i)
+    result = merge_chain_(bucket[i], result, comp);
+  this->head_.next_ = result;
+}
+
+template <class T, class Allocator>
+void forward_list<T, Allocator>::reverse() noexcept {
+  link_pointer_ prev = nullptr;
+  for (link_pointer_ p = this->head_.next_; p != nullptr;) {
+    link_pointer_ next = p->next_;
+    p->next_ = prev;
+    prev = p;
+    p = next;
+  }
+  this->head_.next_ = prev;
+}
+
+// >>> nonmember funtion
+
 template <class T, class Allocator>
-    bool operator==(const forward_list<T, Allocator>& x,
-                    const forward_list<T, Allocator>& y);
+inline bool operator==(const forward_list<T, Allocator> &lhs,
+                       const forward_list<T, Allocator> &rhs) {
+  return ::std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
 
 template <class T, class Allocator>
-    bool operator< (const forward_list<T, Allocator>& x,
-                    const forward_list<T, Allocator>& y);
+inline bool operator!=(const forward_list<T, Allocator> &lhs,
+                       const forward_list<T, Allocator> &rhs) {
+  return !(lhs == rhs);
+}
 
 template <class T, class Allocator>
-    bool operator!=(const forward_list<T, Allocator>& x,
-                    const forward_list<T, Allocator>& y);
+inline bool operator<(const forward_list<T, Allocator> &lhs,
+                      const forward_list<T, Allocator> &rhs) {
+  return ::std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                        rhs.end());
+}
 
 template <class T, class Allocator>
-    bool operator> (const forward_list<T, Allocator>& x,
-                    const forward_list<T, Allocator>& y);
+inline bool operator>(const forward_list<T, Allocator> &lhs,
+                      const forward_list<T, Allocator> &rhs) {
+  return rhs < lhs;
+}
 
 template <class T, class Allocator>
-    bool operator>=(const forward_list<T, Allocator>& x,
-                    const forward_list<T, Allocator>& y);
+inline bool operator<=(const forward_list<T, Allocator> &lhs,
+                       const forward_list<T, Allocator> &rhs) {
+  return !(rhs < lhs);
+}
 
 template <class T, class Allocator>
-    bool operator<=(const forward_list<T, Allocator>& x,
-                    const forward_list<T, Allocator>& y);
+inline bool operator>=(const forward_list<T, Allocator> &lhs,
+                       const forward_list<T, Allocator> &rhs) {
+  return !(lhs < rhs);
+}
 
 template <class T, class Allocator>
-    void swap(forward_list<T, Allocator>& x, forward_list<T, Allocator>& y)
-         noexcept(noexcept(x.swap(y))) {
-         }
-*/
+inline void swap(forward_list<T, Allocator> &lhs,
+                 forward_list<T, Allocator> &rhs) noexcept(noexcept(lhs.swap(rhs))) {
+  lhs.swap(rhs);
+}
 
 STL_END
 
-#endif // !_STL_FORWARD_LIST__
\ No newline at end of file
+#endif  // !_STL_FORWARD_LIST__
@@ -2,6 +2,7 @@
 #define _STL_LIST__
 
 #include "Def/stldef.h"
+#include "__node_pool.h"
 
 STL_BEGIN
 
@@ -245,6 +246,8 @@ class __list_base {
   typedef typename alloc_traits_::template rebind_alloc<node_base_>
       node_base_allocator_type_;
   typedef allocator_traits<node_allocator_type_> node_base_alloc_traits_;
+  // cache of released node
+  typedef __node_pool<node_allocator_type_> node_pool_type_;
 
  protected:
   // >>> constructor
@@ -262,7 +265,10 @@ class __list_base {
   explicit __list_base(const allocator_type &alloc) : size_(0), node_alloc_(alloc) {}
 
   // >>> destructor
-  ~__list_base() { clear(); }
+  ~__list_base() {
+    clear();
+    node_pool_.release_(node_alloc_);
+  }
 
   // access end_, remove cv qualifier before access end_
   link_pointer_ end_link_() const noexcept {
@@ -293,6 +299,12 @@ class __list_base {
   // clear all node
   void clear() noexcept;
 
+  // destroy value of node and give the node back to pool
+  void destroy_node_(link_pointer_ p) noexcept {
+    node_alloc_traits_::destroy(node_alloc_, p->get_adressof_value_());
+    node_pool_.deallocate_(node_alloc_, p->as_node_());
+  }
+
   // copy assignment of allocator
   void copy_assign_alloc_(const __list_base &x) {
     copy_assign_alloc_(
@@ -318,7 +330,11 @@ class __list_base {
   // allocator need to be copied when container is copy-assigned
   void copy_assign_alloc_(const __list_base &x, true_type) {
     // clear when allocators do not compare equal.
-    if (node_alloc_ != x.node_alloc_) clear();
+    // cached node belong to the old allocator, release them too.
+    if (node_alloc_ != x.node_alloc_) {
+      clear();
+      node_pool_.release_(node_alloc_);
+    }
     node_alloc_ = x.node_alloc_;
   }
 
@@ -330,6 +346,7 @@ class __list_base {
   // noexcept if allocator is nothrow move assignable
   void move_assign_alloc_(const __list_base &x, true_type) noexcept(
       ::std::is_nothrow_move_assignable<allocator_type>::value) {
+    node_pool_.release_(node_alloc_);
     node_alloc_ = ::std::move(x.node_alloc_);
   }
 
@@ -341,6 +358,7 @@ class __list_base {
   node_base_ end_;
   size_type size_;
   node_allocator_type_ node_alloc_;
+  node_pool_type_ node_pool_;
 };
 
 // clear all data in the list base
@@ -350,9 +368,10 @@ void __list_base<T, Allocator>::clear() noexcept {
     link_pointer_ first = end_link_()->next_;
     link_pointer_ last = end_link_();
     while (first != last) {
-      node_alloc_traits_::destroy(node_alloc_, first->get_adressof_value_());
-      node_alloc_traits_::deallocate(node_alloc_, first->as_node_(), 1);
-      first = first->next_;
+      // read next_ before the node is given back
+      link_pointer_ next = first->next_;
+      destroy_node_(first);
+      first = next;
     }
     last->next_ = last;
     last->prev_ = last;
@@ -367,6 +386,7 @@ void __list_base<T, Allocator>::swap(__list_base &x) noexcept(
     alloc_traits_::is_always_equal::value) {
   // swap allocator and size
   __swap_allocator(node_alloc_, x.node_alloc_);
+  node_pool_.swap(x.node_pool_);
   ::std::swap(size_, x.size_);
   ::std::swap(end_, x.end_);
   if (size_ == 0)
@@ -644,7 +664,7 @@ class list : private __list_base<T, Allocator> {
 
  private:
   // >>> private auxiliary function
-  // allocate a node
+  // get a node from pool or allocator
   hold_pointer_ allocate_node_();
 
   // link nodes in ranges to pos
@@ -663,7 +683,7 @@ class list : private __list_base<T, Allocator> {
 template <class T, class Allocator>
 typename list<T, Allocator>::hold_pointer_
 list<T, Allocator>::allocate_node_() {
-  node_pointer_ p = node_alloc_traits_::allocate(this->node_alloc_, 1);
+  node_pointer_ p = this->node_pool_.allocate_(this->node_alloc_);
   return hold_pointer_(p, node_destructor_(this->node_alloc_, 1));
 }
 
@@ -828,6 +848,7 @@ template <class T, class Allocator>
 list<T, Allocator> &list<T, Allocator>::operator=(
     ::std::initializer_list<value_type> init) {
   assign(init.begin(), init.end());
+  return *this;
 }
 
 template <class T, class Allocator>
@@ -986,7 +1007,7 @@ typename list<T, Allocator>::iterator list<T, Allocator>::insert(
     try {
       // create the node list
       for (; num_to_insert > 0; --num_to_insert) {
-        node_pointer_ p = node_alloc_traits_::allocate(this->node_alloc_, 1);
+        node_pointer_ p = this->node_pool_.allocate_(this->node_alloc_);
         // may throw
         node_alloc_traits_::construct(this->node_alloc_,
                                       p->get_adressof_value_(), val);
@@ -1000,9 +1021,7 @@ typename list<T, Allocator>::iterator list<T, Allocator>::insert(
       for (; hold_end != hold_ptr.get();) {
         node_pointer_ to_destroy = hold_end;
         hold_end = hold_end->prev_->as_node_();
-        node_alloc_traits_::destroy(this->node_alloc_,
-                                    to_destroy->get_adressof_value_());
-        node_alloc_traits_::deallocate(this->node_alloc_, to_destroy, 1);
+        this->destroy_node_(to_destroy->as_link_());
       }
       node_alloc_traits_::destroy(this->node_alloc_,
                                   hold_ptr->get_adressof_value_());
@@ -1035,7 +1054,7 @@ typename list<T, Allocator>::iterator list<T, Allocator>::insert(
     try {
       // create node list
       for (; first != last; ++first, ++num_already_insert) {
-        node_pointer_ p = node_alloc_traits_::allocate(this->node_alloc_, 1);
+        node_pointer_ p = this->node_pool_.allocate_(this->node_alloc_);
         // may throw
         node_alloc_traits_::construct(this->node_alloc_,
                                       p->get_adressof_value_(), *first);
@@ -1049,9 +1068,7 @@ typename list<T, Allocator>::iterator list<T, Allocator>::insert(
       for (; hold_end != hold_ptr.get();) {
         node_pointer_ to_destroy = hold_end;
         hold_end = hold_end->prev_->as_node_();
-        node_alloc_traits_::destroy(this->node_alloc_,
-                                    to_destroy->get_adressof_value_());
-        node_alloc_traits_::deallocate(this->node_alloc_, to_destroy, 1);
+        this->destroy_node_(to_destroy->as_link_());
       }
       node_alloc_traits_::destroy(this->node_alloc_,
                                   hold_ptr->get_adressof_value_());
@@ -1068,7 +1085,7 @@ typename list<T, Allocator>::iterator list<T, Allocator>::insert(
 template <class T, class Allocator>
 typename list<T, Allocator>::iterator list<T, Allocator>::insert(
     const_iterator position, ::std::initializer_list<value_type> init) {
-  insert(position, init.begin(), init.end());
+  return insert(position, init.begin(), init.end());
 }
 
 // erase
@@ -1078,10 +1095,7 @@ typename list<T, Allocator>::iterator list<T, Allocator>::erase(
   position.ptr_->prev_->next_ = position.ptr_->next_;
   position.ptr_->next_->prev_ = position.ptr_->prev_;
   iterator return_pos = iterator(position.ptr_->next_);
-  node_alloc_traits_::destroy(this->node_alloc_,
-                              position.ptr_->get_adressof_value_());
-  node_alloc_traits_::deallocate(this->node_alloc_, position.ptr_->as_node_(),
-                                 1);
+  this->destroy_node_(position.ptr_);
   --this->size_;
   return return_pos;
 }
@@ -1095,10 +1109,7 @@ typename list<T, Allocator>::iterator list<T, Allocator>::erase(
   for (; first != last; ++num_to_destroy) {
     const_iterator to_destroy = first;
     ++first;
-    node_alloc_traits_::destroy(this->node_alloc_,
-                                to_destroy.ptr_->get_adressof_value_());
-    node_alloc_traits_::deallocate(this->node_alloc_,
-                                   to_destroy.ptr_->as_node_(), 1);
+    this->destroy_node_(to_destroy.ptr_);
   }
   this->size_ -= num_to_destroy;
   return iterator(last.ptr_);
@@ -0,0 +1,318 @@
+#ifndef _STL_MPMC_QUEUE__
+#define _STL_MPMC_QUEUE__
+
+#include <atomic>
+#include <cstdint>
+#include "Def/stldef.h"
+#include "__concurrency.h"
+
+STL_BEGIN
+
+// bounded lock-free multi-producer multi-consumer FIFO queue (Vyukov)
+// every cell of the ring keeps a sequence number:
+//   seq == pos: cell is free for the producer of position pos
+//   seq == pos + 1: cell holds the element of position pos
+// producer and consumer claim a position by CAS on tail_ or head_, and
+// publish the cell by storing its next sequence. tail_ and head_ are on
+// their own cache line.
+// a claimed cell must be published, so element is constructed before the
+// claim unless its constructor can not throw, and T must be nothrow movable.
+// blocking push and pop sleep on a futex when the queue is full or empty.
+template <class T, class Allocator = allocator<T>>
+class mpmc_queue {
+  static_assert(is_nothrow_move_constructible<T>::value &&
+                    is_nothrow_move_assignable<T>::value,
+                "element of mpmc_queue must be nothrow movable");
+
+  // >>> member types
+ public:
+  typedef T value_type;
+  typedef Allocator allocator_type;
+  typedef value_type &reference;
+  typedef const value_type &const_reference;
+  typedef ::std::size_t size_type;
+
+ private:
+  struct cell_ {
+    ::std::atomic<size_type> seq_;
+    typename ::std::aligned_storage<sizeof(value_type),
+                                    alignof(value_type)>::type storage_;
+
+    value_type *value() noexcept {
+      return reinterpret_cast<value_type *>(&storage_);
+    }
+  };
+
+  typedef allocator_traits<allocator_type> alloc_traits_;
+  typedef typename alloc_traits_::template rebind_alloc<cell_>
+      cell_allocator_type_;
+  typedef allocator_traits<cell_allocator_type_> cell_alloc_traits_;
+
+  static_assert(::std::is_same<typename alloc_traits_::void_pointer,
+                               void *>::value,
+                "mpmc_queue needs allocator with raw pointer");
+
+ public:
+  // >>> constructor
+  // capacity is rounded up to power of two
+  explicit mpmc_queue(size_type capacity,
+                      const allocator_type &alloc = allocator_type());
+
+  // no copy or move, address of head and tail is shared by threads
+  mpmc_queue(const mpmc_queue &) = delete;
+
+  mpmc_queue &operator=(const mpmc_queue &) = delete;
+
+  // >>> destructor
+  // no other thread may access the queue now
+  ~mpmc_queue();
+
+  // >>> allocator
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(alloc_);
+  }
+
+  // >>> capacity
+  // only a snapshot if other thread is running
+  bool empty() const noexcept { return size() == 0; }
+
+  size_type size() const noexcept {
+    size_type tail = tail_.load(::std::memory_order_relaxed);
+    size_type head = head_.load(::std::memory_order_relaxed);
+    return tail > head ? tail - head : 0;
+  }
+
+  size_type capacity() const noexcept { return mask_ + 1; }
+
+  // >>> modifier
+  // non-blocking, return false if queue is full
+  bool try_push(const value_type &val) { return try_emplace(val); }
+
+  bool try_push(value_type &&val) { return try_emplace(::std::move(val)); }
+
+  template <class... Args>
+  bool try_emplace(Args &&... args);
+
+  // non-blocking, return false if queue is empty
+  bool try_pop(value_type &val) noexcept;
+
+  // push at most n element from first by one claim, return the number pushed
+  template <class InputIterator>
+  typename enable_if<__is_input_iterator<InputIterator>::value,
+                     size_type>::type
+  try_push_n(InputIterator first, size_type n);
+
+  // pop at most n element to result by one claim, return the number popped
+  template <class OutputIterator>
+  size_type try_pop_n(OutputIterator result, size_type n);
+
+  // blocking, wait while queue is full
+  void push(const value_type &val) { emplace(val); }
+
+  void push(value_type &&val) { emplace(::std::move(val)); }
+
+  template <class... Args>
+  void emplace(Args &&... args);
+
+  // blocking, wait while queue is empty
+  void pop(value_type &val) noexcept;
+
+ private:
+  // >>> private auxiliary function
+  // claim position for n cell at most, return the first position and the
+  // number claimed in n. cell of position p is ready if seq is p + ready.
+  size_type claim_(::std::atomic<size_type> &pos, size_type ready,
+                   size_type &n) noexcept;
+
+  // construct element of position pos and publish it
+  template <class... Args>
+  void put_(size_type pos, Args &&... args) noexcept {
+    cell_ &cell = cells_[pos & mask_];
+    alloc_traits_::construct(alloc_, cell.value(),
+                             ::std::forward<Args>(args)...);
+    cell.seq_.store(pos + 1, ::std::memory_order_release);
+  }
+
+  // destroy element of position pos and release its cell for next round
+  void release_(size_type pos) noexcept {
+    cell_ &cell = cells_[pos & mask_];
+    alloc_traits_::destroy(alloc_, cell.value());
+    cell.seq_.store(pos + mask_ + 1, ::std::memory_order_release);
+  }
+
+  template <class... Args>
+  bool try_emplace_(true_type, Args &&... args) noexcept;
+
+  // constructor may throw, construct before the claim
+  template <class... Args>
+  bool try_emplace_(false_type, Args &&... args) {
+    value_type tmp(::std::forward<Args>(args)...);
+    return try_emplace_(true_type(), ::std::move(tmp));
+  }
+
+  // blocking operation retries this many times with backoff before it
+  // sleeps, a sleeper makes every operation of the other side a syscall
+  static const int spin_tries_ = 64;
+
+  // >>> data member
+  // tail_ is written by producers, head_ by consumers, keep them apart
+  alignas(__cache_line_size)::std::atomic<size_type> tail_;
+  alignas(__cache_line_size)::std::atomic<size_type> head_;
+  alignas(__cache_line_size) cell_ *cells_;
+  size_type mask_;
+  allocator_type alloc_;
+  __futex_event not_full_;
+  __futex_event not_empty_;
+};
+
+template <class T, class Allocator>
+mpmc_queue<T, Allocator>::mpmc_queue(size_type capacity,
+                                     const allocator_type &alloc)
+    : tail_(0), head_(0), cells_(nullptr), mask_(0), alloc_(alloc) {
+  size_type n = 1;
+  while (n < capacity) n <<= 1;
+  cell_allocator_type_ cell_alloc(alloc_);
+  cells_ = cell_alloc_traits_::allocate(cell_alloc, n);
+  for (size_type i = 0; i < n; ++i)
+    ::new (static_cast<void *>(&cells_[i].seq_)) ::std::atomic<size_type>(i);
+  mask_ = n - 1;
+}
+
+template <class T, class Allocator>
+mpmc_queue<T, Allocator>::~mpmc_queue() {
+  size_type tail = tail_.load(::std::memory_order_acquire);
+  for (size_type pos = head_.load(::std::memory_order_acquire); pos != tail;
+       ++pos)
+    alloc_traits_::destroy(alloc_, cells_[pos & mask_].value());
+  cell_allocator_type_ cell_alloc(alloc_);
+  cell_alloc_traits_::deallocate(cell_alloc, cells_, mask_ + 1);
+}
+
+template <class T, class Allocator>
+typename mpmc_queue<T, Allocator>::size_type mpmc_queue<T, Allocator>::claim_(
+    ::std::atomic<size_type> &pos, size_type ready, size_type &n) noexcept {
+  size_type first = pos.load(::std::memory_order_relaxed);
+  for (;;) {
+    // count the ready cell from first
+    size_type k = 0;
+    ::std::intptr_t diff = 0;
+    for (; k < n; ++k) {
+      size_type seq =
+          cells_[(first + k) & mask_].seq_.load(::std::memory_order_acquire);
+      diff = static_cast<::std::intptr_t>(seq - (first + k + ready));
+      if (diff != 0) break;
+    }
+    if (k > 0) {
+      if (pos.compare_exchange_weak(first, first + k,
+                                    ::std::memory_order_relaxed,
+                                    ::std::memory_order_relaxed)) {
+        n = k;
+        return first;
+      }
+    } else if (diff < 0) {
+      // cell of first is still used by last round, full or empty
+      n = 0;
+      return first;
+    } else
+      // another thread has claimed first
+      first = pos.load(::std::memory_order_relaxed);
+  }
+}
+
+template <class T, class Allocator>
+template <class... Args>
+bool mpmc_queue<T, Allocator>::try_emplace_(true_type,
+                                           Args &&... args) noexcept {
+  size_type n = 1;
+  size_type pos = claim_(tail_, 0, n);
+  if (n == 0) return false;
+  put_(pos, ::std::forward<Args>(args)...);
+  not_empty_.notify(1);
+  return true;
+}
+
+template <class T, class Allocator>
+template <class... Args>
+bool mpmc_queue<T, Allocator>::try_emplace(Args &&... args) {
+  return try_emplace_(
+      integral_constant<bool, ::std::is_nothrow_constructible<
+                                  value_type, Args &&...>::value>(),
+      ::std::forward<Args>(args)...);
+}
+
+template <class T, class Allocator>
+bool mpmc_queue<T, Allocator>::try_pop(value_type &val) noexcept {
+  size_type n = 1;
+  size_type pos = claim_(head_, 1, n);
+  if (n == 0) return false;
+  val = ::std::move(*cells_[pos & mask_].value());
+  release_(pos);
+  not_full_.notify(1);
+  return true;
+}
+
+template <class T, class Allocator>
+template <class InputIterator>
+typename enable_if<__is_input_iterator<InputIterator>::value,
+                   typename mpmc_queue<T, Allocator>::size_type>::type
+mpmc_queue<T, Allocator>::try_push_n(InputIterator first, size_type n) {
+  typedef typename iterator_traits<InputIterator>::reference reference_;
+  if (!::std::is_nothrow_constructible<value_type, reference_>::value) {
+    // element is constructed before its claim one by one
+    size_type pushed = 0;
+    for (; pushed < n && try_emplace(*first); ++pushed, ++first)
+      ;
+    return pushed;
+  }
+  if (n == 0) return 0;
+  size_type pos = claim_(tail_, 0, n);
+  for (size_type i = 0; i < n; ++i, ++first) put_(pos + i, *first);
+  if (n > 0) not_empty_.notify(static_cast<int>(n));
+  return n;
+}
+
+template <class T, class Allocator>
+template <class OutputIterator>
+typename mpmc_queue<T, Allocator>::size_type
+mpmc_queue<T, Allocator>::try_pop_n(OutputIterator result, size_type n) {
+  if (n == 0) return 0;
+  size_type pos = claim_(head_, 1, n);
+  size_type i = 0;
+  try {
+    for (; i < n; ++i, ++result) {
+      *result = ::std::move(*cells_[(pos + i) & mask_].value());
+      release_(pos + i);
+    }
+  } catch (...) {
+    // claimed cell must be released, the rest element is dropped
+    for (; i < n; ++i) release_(pos + i);
+    not_full_.notify(static_cast<int>(n));
+    throw;
+  }
+  if (n > 0) not_full_.notify(static_cast<int>(n));
+  return n;
+}
+
+template <class T, class Allocator>
+template <class... Args>
+void mpmc_queue<T, Allocator>::emplace(Args &&... args) {
+  // construct once, so a failed try does not consume args
+  value_type tmp(::std::forward<Args>(args)...);
+  __backoff<> backoff;
+  for (int i = 0; i < spin_tries_; ++i, backoff())
+    if (try_emplace_(true_type(), ::std::move(tmp))) return;
+  not_full_.wait(
+      [&]() noexcept { return try_emplace_(true_type(), ::std::move(tmp)); });
+}
+
+template <class T, class Allocator>
+void mpmc_queue<T, Allocator>::pop(value_type &val) noexcept {
+  __backoff<> backoff;
+  for (int i = 0; i < spin_tries_; ++i, backoff())
+    if (try_pop(val)) return;
+  not_empty_.wait([&]() noexcept { return try_pop(val); });
+}
+
+STL_END
+
+#endif  // !_STL_MPMC_QUEUE__
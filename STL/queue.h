@@ -0,0 +1,269 @@
+#ifndef _QUEUE_H__
+#define _QUEUE_H__
+
+#include <functional>
+#include "Def/stldef.h"
+#include "__heap.h"
+#include "deque.h"
+#include "vector.h"
+
+STL_BEGIN
+
+// FIFO adapter, Container needs front, back, push_back, emplace_back and
+// pop_front, e.g. deque and list
+template <class T, class Container = deque<T>>
+class queue {
+  // >>> member types
+ public:
+  typedef Container container_type;
+  typedef typename container_type::value_type value_type;
+  typedef typename container_type::reference reference;
+  typedef typename container_type::const_reference const_reference;
+  typedef typename container_type::size_type size_type;
+
+  static_assert(::std::is_same<T, value_type>::value,
+                "value_type of container must be T");
+
+  // >>> constructor
+  queue() : c() {}
+
+  explicit queue(const container_type &cont) : c(cont) {}
+
+  explicit queue(container_type &&cont) : c(::std::move(cont)) {}
+
+  template <class InputIterator,
+            class = typename enable_if<
+                __is_input_iterator<InputIterator>::value, void>::type>
+  queue(InputIterator first, InputIterator last) : c(first, last) {}
+
+  // >>> element access
+  reference front() {
+    assert(!empty());
+    return c.front();
+  }
+
+  const_reference front() const {
+    assert(!empty());
+    return c.front();
+  }
+
+  reference back() {
+    assert(!empty());
+    return c.back();
+  }
+
+  const_reference back() const {
+    assert(!empty());
+    return c.back();
+  }
+
+  // >>> capacity
+  bool empty() const { return c.empty(); }
+
+  size_type size() const { return c.size(); }
+
+  // >>> modifier
+  void push(const value_type &val) { c.push_back(val); }
+
+  void push(value_type &&val) { c.push_back(::std::move(val)); }
+
+  // push every element of rg in order
+  template <class Range>
+  void push_range(Range &&rg) {
+    __append_range(c, ::std::forward<Range>(rg));
+  }
+
+  template <class... Args>
+  void emplace(Args &&... args) {
+    c.emplace_back(::std::forward<Args>(args)...);
+  }
+
+  void pop() {
+    assert(!empty());
+    c.pop_front();
+  }
+
+  void swap(queue &x) noexcept(noexcept(::std::swap(::std::declval<Container &>(),
+                                                    ::std::declval<Container &>()))) {
+    using ::std::swap;
+    swap(c, x.c);
+  }
+
+  // >>> comparison
+  friend bool operator==(const queue &lhs, const queue &rhs) {
+    return lhs.c == rhs.c;
+  }
+
+  friend bool operator!=(const queue &lhs, const queue &rhs) {
+    return !(lhs == rhs);
+  }
+
+  friend bool operator<(const queue &lhs, const queue &rhs) {
+    return lhs.c < rhs.c;
+  }
+
+  friend bool operator<=(const queue &lhs, const queue &rhs) {
+    return !(rhs < lhs);
+  }
+
+  friend bool operator>(const queue &lhs, const queue &rhs) {
+    return rhs < lhs;
+  }
+
+  friend bool operator>=(const queue &lhs, const queue &rhs) {
+    return !(lhs < rhs);
+  }
+
+ protected:
+  container_type c;
+};
+
+template <class T, class Container>
+inline void swap(queue<T, Container> &lhs,
+                 queue<T, Container> &rhs) noexcept(noexcept(lhs.swap(rhs))) {
+  lhs.swap(rhs);
+}
+
+// max heap adapter, Container needs random access iterator, front,
+// push_back, emplace_back and pop_back, e.g. vector and deque.
+// Arity is the number of children of a heap node (2, 4 and 8 are usual).
+// a wider heap is shallower, pop does fewer level of sift-down, each level
+// compares Arity children lying next to each other, so fewer cache line is
+// touched on a large heap. push does fewer comparison too.
+template <class T, class Container = vector<T>,
+          class Compare = ::std::less<typename Container::value_type>,
+          ::std::size_t Arity = 2>
+class priority_queue {
+  // >>> member types
+ public:
+  typedef Container container_type;
+  typedef Compare value_compare;
+  typedef typename container_type::value_type value_type;
+  typedef typename container_type::reference reference;
+  typedef typename container_type::const_reference const_reference;
+  typedef typename container_type::size_type size_type;
+
+  static const ::std::size_t arity = Arity;
+
+  static_assert(::std::is_same<T, value_type>::value,
+                "value_type of container must be T");
+  static_assert(Arity >= 2, "heap node has 2 children at least");
+
+  // >>> constructor
+  priority_queue() : c(), comp() {}
+
+  explicit priority_queue(const value_compare &compare) : c(), comp(compare) {}
+
+  // element of cont is made into a heap
+  priority_queue(const value_compare &compare, const container_type &cont)
+      : c(cont), comp(compare) {
+    __make_heap<Arity>(c.begin(), c.end(), comp);
+  }
+
+  priority_queue(const value_compare &compare, container_type &&cont)
+      : c(::std::move(cont)), comp(compare) {
+    __make_heap<Arity>(c.begin(), c.end(), comp);
+  }
+
+  template <class InputIterator,
+            class = typename enable_if<
+                __is_input_iterator<InputIterator>::value, void>::type>
+  priority_queue(InputIterator first, InputIterator last,
+                 const value_compare &compare = value_compare())
+      : c(first, last), comp(compare) {
+    __make_heap<Arity>(c.begin(), c.end(), comp);
+  }
+
+  // >>> element access
+  const_reference top() const {
+    assert(!empty());
+    return c.front();
+  }
+
+  // >>> capacity
+  bool empty() const { return c.empty(); }
+
+  size_type size() const { return c.size(); }
+
+  // >>> modifier
+  void push(const value_type &val) {
+    c.push_back(val);
+    __push_heap<Arity>(c.begin(), c.end(), comp);
+  }
+
+  void push(value_type &&val) {
+    c.push_back(::std::move(val));
+    __push_heap<Arity>(c.begin(), c.end(), comp);
+  }
+
+  // push every element of rg, the heap is rebuilt at once if rg is not
+  // smaller than the heap, it is cheaper than sift-up of every element
+  template <class Range>
+  void push_range(Range &&rg);
+
+  template <class... Args>
+  void emplace(Args &&... args) {
+    c.emplace_back(::std::forward<Args>(args)...);
+    __push_heap<Arity>(c.begin(), c.end(), comp);
+  }
+
+  void pop() {
+    assert(!empty());
+    __pop_heap<Arity>(c.begin(), c.end(), comp);
+    c.pop_back();
+  }
+
+  // pop at most n top element to result in order, return end of result
+  template <class OutputIterator>
+  OutputIterator pop_n(size_type n, OutputIterator result);
+
+  void swap(priority_queue &x) noexcept(
+      noexcept(::std::swap(::std::declval<Container &>(),
+                           ::std::declval<Container &>())) &&
+      noexcept(::std::swap(::std::declval<Compare &>(),
+                           ::std::declval<Compare &>()))) {
+    using ::std::swap;
+    swap(c, x.c);
+    swap(comp, x.comp);
+  }
+
+ protected:
+  container_type c;
+  value_compare comp;
+};
+
+template <class T, class Container, class Compare, ::std::size_t Arity>
+template <class Range>
+void priority_queue<T, Container, Compare, Arity>::push_range(Range &&rg) {
+  const size_type old_size = size();
+  __append_range(c, ::std::forward<Range>(rg));
+  if (size() - old_size >= old_size) {
+    __make_heap<Arity>(c.begin(), c.end(), comp);
+    return;
+  }
+  for (auto iter = c.begin() + old_size; iter != c.end();)
+    __push_heap<Arity>(c.begin(), ++iter, comp);
+}
+
+template <class T, class Container, class Compare, ::std::size_t Arity>
+template <class OutputIterator>
+OutputIterator priority_queue<T, Container, Compare, Arity>::pop_n(
+    size_type n, OutputIterator result) {
+  for (; n > 0 && !empty(); --n, ++result) {
+    __pop_heap<Arity>(c.begin(), c.end(), comp);
+    *result = ::std::move(c.back());
+    c.pop_back();
+  }
+  return result;
+}
+
+template <class T, class Container, class Compare, ::std::size_t Arity>
+inline void swap(priority_queue<T, Container, Compare, Arity> &lhs,
+                 priority_queue<T, Container, Compare, Arity>
+                     &rhs) noexcept(noexcept(lhs.swap(rhs))) {
+  lhs.swap(rhs);
+}
+
+STL_END
+
+#endif  // !_QUEUE_H__
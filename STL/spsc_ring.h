@@ -0,0 +1,226 @@
+#ifndef _STL_SPSC_RING__
+#define _STL_SPSC_RING__
+
+#include <atomic>
+#include "Def/stldef.h"
+#include "__concurrency.h"
+
+STL_BEGIN
+
+// wait-free single-producer single-consumer ring buffer
+// the producer owns tail_ and the consumer owns head_, each side keeps a
+// cached copy of the other index and reloads it only when the ring looks
+// full or empty, so the cache line of the other side is seldom touched.
+// every index is on its own cache line.
+// besides element-wise push and pop, a batch is accessed in place:
+//   reserve(n) and commit(n): the producer writes free slots and publishes
+//   peek(n) and release(n): the consumer reads elements and frees them
+// they return the region as one or two spans (the ring may wrap), and need
+// trivially copyable T since the slots are used as plain memory.
+template <class T, class Allocator = allocator<T>>
+class spsc_ring {
+  // >>> member types
+ public:
+  typedef T value_type;
+  typedef Allocator allocator_type;
+  typedef value_type &reference;
+  typedef const value_type &const_reference;
+  typedef value_type *pointer;
+  typedef ::std::size_t size_type;
+
+  // contiguous part of the ring
+  struct span {
+    pointer data;
+    size_type size;
+
+    pointer begin() const noexcept { return data; }
+
+    pointer end() const noexcept { return data + size; }
+  };
+
+  // region of the ring, second is empty unless the region wraps
+  struct region {
+    span first;
+    span second;
+
+    size_type size() const noexcept { return first.size + second.size; }
+  };
+
+ private:
+  typedef allocator_traits<allocator_type> alloc_traits_;
+
+  static_assert(::std::is_same<typename alloc_traits_::pointer,
+                               value_type *>::value,
+                "spsc_ring needs allocator with raw pointer");
+
+ public:
+  // >>> constructor
+  // capacity is rounded up to power of two
+  explicit spsc_ring(size_type capacity,
+                     const allocator_type &alloc = allocator_type());
+
+  // no copy or move, address of head and tail is shared by threads
+  spsc_ring(const spsc_ring &) = delete;
+
+  spsc_ring &operator=(const spsc_ring &) = delete;
+
+  // >>> destructor
+  // no other thread may access the ring now
+  ~spsc_ring();
+
+  // >>> allocator
+  allocator_type get_allocator() const noexcept { return alloc_; }
+
+  // >>> capacity
+  // only a snapshot if other thread is running
+  bool empty() const noexcept { return size() == 0; }
+
+  // head is loaded before tail, and the count is clamped to [0, capacity()]
+  // since either may move between the loads
+  size_type size() const noexcept {
+    const size_type head = head_.load(::std::memory_order_acquire);
+    const size_type tail = tail_.load(::std::memory_order_acquire);
+    if (tail <= head) return 0;
+    return tail - head < capacity() ? tail - head : capacity();
+  }
+
+  size_type capacity() const noexcept { return mask_ + 1; }
+
+  // >>> producer
+  // return false if ring is full
+  bool try_push(const value_type &val) { return try_emplace(val); }
+
+  bool try_push(value_type &&val) { return try_emplace(::std::move(val)); }
+
+  template <class... Args>
+  bool try_emplace(Args &&... args);
+
+  // free slots for at most n element, they are written by the producer and
+  // published by commit
+  region reserve(size_type n) noexcept;
+
+  // publish first n slots of the last reserved region
+  void commit(size_type n) noexcept {
+    assert(n <= capacity() - (tail_.load(::std::memory_order_relaxed) -
+                              cached_head_));
+    tail_.store(tail_.load(::std::memory_order_relaxed) + n,
+                ::std::memory_order_release);
+  }
+
+  // >>> consumer
+  // return false if ring is empty
+  bool try_pop(value_type &val);
+
+  // at most n element in ring, they stay in ring until release
+  region peek(size_type n) noexcept;
+
+  // free first n element of the last peeked region
+  void release(size_type n) noexcept {
+    assert(n <= cached_tail_ - head_.load(::std::memory_order_relaxed));
+    head_.store(head_.load(::std::memory_order_relaxed) + n,
+                ::std::memory_order_release);
+  }
+
+ private:
+  // >>> private auxiliary function
+  // region of n slots from index i
+  region region_(size_type i, size_type n) const noexcept {
+    const size_type offset = i & mask_;
+    const size_type first = n < capacity() - offset ? n : capacity() - offset;
+    return region{span{slots_ + offset, first}, span{slots_, n - first}};
+  }
+
+  // >>> data member
+  // producer: tail_ and cached_head_, consumer: head_ and cached_tail_
+  alignas(__cache_line_size)::std::atomic<size_type> tail_;
+  alignas(__cache_line_size) size_type cached_head_;
+  alignas(__cache_line_size)::std::atomic<size_type> head_;
+  alignas(__cache_line_size) size_type cached_tail_;
+  alignas(__cache_line_size) pointer slots_;
+  size_type mask_;
+  allocator_type alloc_;
+};
+
+template <class T, class Allocator>
+spsc_ring<T, Allocator>::spsc_ring(size_type capacity,
+                                   const allocator_type &alloc)
+    : tail_(0),
+      cached_head_(0),
+      head_(0),
+      cached_tail_(0),
+      slots_(nullptr),
+      mask_(0),
+      alloc_(alloc) {
+  size_type n = 1;
+  while (n < capacity) n <<= 1;
+  slots_ = alloc_traits_::allocate(alloc_, n);
+  mask_ = n - 1;
+}
+
+template <class T, class Allocator>
+spsc_ring<T, Allocator>::~spsc_ring() {
+  size_type tail = tail_.load(::std::memory_order_acquire);
+  for (size_type i = head_.load(::std::memory_order_acquire); i != tail; ++i)
+    alloc_traits_::destroy(alloc_, slots_ + (i & mask_));
+  alloc_traits_::deallocate(alloc_, slots_, mask_ + 1);
+}
+
+template <class T, class Allocator>
+template <class... Args>
+bool spsc_ring<T, Allocator>::try_emplace(Args &&... args) {
+  const size_type tail = tail_.load(::std::memory_order_relaxed);
+  if (tail - cached_head_ == capacity()) {
+    cached_head_ = head_.load(::std::memory_order_acquire);
+    if (tail - cached_head_ == capacity()) return false;
+  }
+  alloc_traits_::construct(alloc_, slots_ + (tail & mask_),
+                           ::std::forward<Args>(args)...);
+  tail_.store(tail + 1, ::std::memory_order_release);
+  return true;
+}
+
+template <class T, class Allocator>
+typename spsc_ring<T, Allocator>::region spsc_ring<T, Allocator>::reserve(
+    size_type n) noexcept {
+  static_assert(::std::is_trivially_copyable<value_type>::value,
+                "reserve needs trivially copyable element");
+  const size_type tail = tail_.load(::std::memory_order_relaxed);
+  size_type free = capacity() - (tail - cached_head_);
+  if (free < n) {
+    cached_head_ = head_.load(::std::memory_order_acquire);
+    free = capacity() - (tail - cached_head_);
+  }
+  return region_(tail, n < free ? n : free);
+}
+
+template <class T, class Allocator>
+bool spsc_ring<T, Allocator>::try_pop(value_type &val) {
+  const size_type head = head_.load(::std::memory_order_relaxed);
+  if (head == cached_tail_) {
+    cached_tail_ = tail_.load(::std::memory_order_acquire);
+    if (head == cached_tail_) return false;
+  }
+  pointer p = slots_ + (head & mask_);
+  val = ::std::move(*p);
+  alloc_traits_::destroy(alloc_, p);
+  head_.store(head + 1, ::std::memory_order_release);
+  return true;
+}
+
+template <class T, class Allocator>
+typename spsc_ring<T, Allocator>::region spsc_ring<T, Allocator>::peek(
+    size_type n) noexcept {
+  static_assert(::std::is_trivially_copyable<value_type>::value,
+                "peek needs trivially copyable element");
+  const size_type head = head_.load(::std::memory_order_relaxed);
+  size_type ready = cached_tail_ - head;
+  if (ready < n) {
+    cached_tail_ = tail_.load(::std::memory_order_acquire);
+    ready = cached_tail_ - head;
+  }
+  return region_(head, n < ready ? n : ready);
+}
+
+STL_END
+
+#endif  // !_STL_SPSC_RING__
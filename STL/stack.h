@@ -0,0 +1,116 @@
+#ifndef _STACK_H__
+#define _STACK_H__
+
+#include "Def/stldef.h"
+#include "deque.h"
+
+STL_BEGIN
+
+// LIFO adapter, Container needs back, push_back, emplace_back and pop_back,
+// e.g. deque, vector and list
+template <class T, class Container = deque<T>>
+class stack {
+  // >>> member types
+ public:
+  typedef Container container_type;
+  typedef typename container_type::value_type value_type;
+  typedef typename container_type::reference reference;
+  typedef typename container_type::const_reference const_reference;
+  typedef typename container_type::size_type size_type;
+
+  static_assert(::std::is_same<T, value_type>::value,
+                "value_type of container must be T");
+
+  // >>> constructor
+  stack() : c() {}
+
+  explicit stack(const container_type &cont) : c(cont) {}
+
+  explicit stack(container_type &&cont) : c(::std::move(cont)) {}
+
+  template <class InputIterator,
+            class = typename enable_if<
+                __is_input_iterator<InputIterator>::value, void>::type>
+  stack(InputIterator first, InputIterator last) : c(first, last) {}
+
+  // >>> element access
+  reference top() {
+    assert(!empty());
+    return c.back();
+  }
+
+  const_reference top() const {
+    assert(!empty());
+    return c.back();
+  }
+
+  // >>> capacity
+  bool empty() const { return c.empty(); }
+
+  size_type size() const { return c.size(); }
+
+  // >>> modifier
+  void push(const value_type &val) { c.push_back(val); }
+
+  void push(value_type &&val) { c.push_back(::std::move(val)); }
+
+  // push every element of rg in order, the last one is on top
+  template <class Range>
+  void push_range(Range &&rg) {
+    __append_range(c, ::std::forward<Range>(rg));
+  }
+
+  template <class... Args>
+  void emplace(Args &&... args) {
+    c.emplace_back(::std::forward<Args>(args)...);
+  }
+
+  void pop() {
+    assert(!empty());
+    c.pop_back();
+  }
+
+  void swap(stack &x) noexcept(noexcept(::std::swap(::std::declval<Container &>(),
+                                                    ::std::declval<Container &>()))) {
+    using ::std::swap;
+    swap(c, x.c);
+  }
+
+  // >>> comparison
+  friend bool operator==(const stack &lhs, const stack &rhs) {
+    return lhs.c == rhs.c;
+  }
+
+  friend bool operator!=(const stack &lhs, const stack &rhs) {
+    return !(lhs == rhs);
+  }
+
+  friend bool operator<(const stack &lhs, const stack &rhs) {
+    return lhs.c < rhs.c;
+  }
+
+  friend bool operator<=(const stack &lhs, const stack &rhs) {
+    return !(rhs < lhs);
+  }
+
+  friend bool operator>(const stack &lhs, const stack &rhs) {
+    return rhs < lhs;
+  }
+
+  friend bool operator>=(const stack &lhs, const stack &rhs) {
+    return !(lhs < rhs);
+  }
+
+ protected:
+  container_type c;
+};
+
+template <class T, class Container>
+inline void swap(stack<T, Container> &lhs,
+                 stack<T, Container> &rhs) noexcept(noexcept(lhs.swap(rhs))) {
+  lhs.swap(rhs);
+}
+
+STL_END
+
+#endif  // !_STACK_H__
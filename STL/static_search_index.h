@@ -0,0 +1,292 @@
+#ifndef _STL_STATIC_SEARCH_INDEX__
+#define _STL_STATIC_SEARCH_INDEX__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include "Def/stldef.h"
+#include "__concurrency.h"
+#include "vector.h"
+
+STL_BEGIN
+
+// read-only index of sorted arithmetic key, lower_bound and upper_bound
+// return the rank of the key in the sorted input. the key is laid out so
+// that a search touches fewer cache line than binary search of the sorted
+// array, where every level but the last few misses cache.
+//   eytzinger: the binary search tree in BFS order, node k has children
+//     2k and 2k + 1 (Eytzinger). the search is branch-free and prefetches
+//     the 64 byte of descendant a cache line of levels below, the miss of
+//     a level is issued several levels ahead.
+//   s_tree: a static B+ tree of node of 16 key (Khuong and Morin, S+ tree).
+//     the leaves are the sorted key, an inner node holds the least key of
+//     its children but the first, a node is searched by counting its key
+//     less than x, a loop of 16 comparison the compiler vectorizes. a
+//     search reads log17(n) node, one or two cache line each.
+// both are built in O(n) and padded with the largest key.
+enum class search_layout { eytzinger, s_tree };
+
+template <class T, search_layout Layout = search_layout::s_tree,
+          class Allocator = allocator<T>>
+class static_search_index {
+  // >>> member types
+ public:
+  typedef T key_type;
+  typedef Allocator allocator_type;
+  typedef ::std::size_t size_type;
+
+  static_assert(::std::is_arithmetic<T>::value,
+                "key of static_search_index is arithmetic");
+
+  static const search_layout layout = Layout;
+  // key of a node of s_tree
+  static const size_type node_keys = 16;
+
+ private:
+  // key of a cache line, storage is aligned to it
+  static const size_type line_keys_ =
+      __cache_line_size / sizeof(T) > 0 ? __cache_line_size / sizeof(T) : 1;
+
+ public:
+  // >>> constructor
+  explicit static_search_index(const allocator_type &alloc = allocator_type())
+      : storage_(alloc), offset_(0), size_(0), height_(0) {}
+
+  // [first, last) is sorted ascending by <
+  template <class RandomAccessIterator>
+  static_search_index(RandomAccessIterator first, RandomAccessIterator last,
+                      const allocator_type &alloc = allocator_type())
+      : storage_(alloc),
+        offset_(0),
+        size_(static_cast<size_type>(last - first)),
+        height_(0) {
+    build_(first, integral_constant<bool, Layout == search_layout::s_tree>());
+  }
+
+  // the copy is aligned again
+  static_search_index(const static_search_index &x)
+      : storage_(x.storage_),
+        offset_(x.offset_),
+        size_(x.size_),
+        height_(x.height_),
+        layer_offset_(x.layer_offset_) {
+    realign_();
+  }
+
+  static_search_index(static_search_index &&x) noexcept
+      : storage_(::std::move(x.storage_)),
+        offset_(x.offset_),
+        size_(x.size_),
+        height_(x.height_),
+        layer_offset_(::std::move(x.layer_offset_)) {
+    x.offset_ = 0;
+    x.size_ = 0;
+    x.height_ = 0;
+  }
+
+  static_search_index &operator=(const static_search_index &x) {
+    if (this != &x) {
+      static_search_index tmp(x);
+      *this = ::std::move(tmp);
+    }
+    return *this;
+  }
+
+  static_search_index &operator=(static_search_index &&x) noexcept {
+    storage_ = ::std::move(x.storage_);
+    offset_ = x.offset_;
+    size_ = x.size_;
+    height_ = x.height_;
+    layer_offset_ = ::std::move(x.layer_offset_);
+    x.offset_ = 0;
+    x.size_ = 0;
+    x.height_ = 0;
+    return *this;
+  }
+
+  // >>> allocator
+  allocator_type get_allocator() const noexcept {
+    return storage_.get_allocator();
+  }
+
+  // >>> capacity
+  bool empty() const noexcept { return size_ == 0; }
+
+  size_type size() const noexcept { return size_; }
+
+  // >>> search
+  // rank of the first key not less than x, size() if there is none
+  size_type lower_bound(const key_type &x) const noexcept {
+    return search_<false>(
+        x, integral_constant<bool, Layout == search_layout::s_tree>());
+  }
+
+  // rank of the first key greater than x, size() if there is none
+  size_type upper_bound(const key_type &x) const noexcept {
+    return search_<true>(
+        x, integral_constant<bool, Layout == search_layout::s_tree>());
+  }
+
+ private:
+  const T *data_() const noexcept { return storage_.data() + offset_; }
+
+  // key before x, x not less than key for upper_bound
+  template <bool Upper>
+  static bool before_(const T &key, const T &x) noexcept {
+    return Upper ? !(x < key) : key < x;
+  }
+
+  // storage of n key aligned to a cache line
+  void allocate_(size_type n) {
+    storage_.resize(n + line_keys_ - 1, ::std::numeric_limits<T>::max());
+    offset_ = align_offset_();
+  }
+
+  size_type align_offset_() const noexcept {
+    const ::std::uintptr_t addr =
+        reinterpret_cast<::std::uintptr_t>(storage_.data());
+    const ::std::uintptr_t misalign = addr % __cache_line_size;
+    return misalign == 0 || misalign % sizeof(T) != 0
+               ? 0
+               : (__cache_line_size - misalign) / sizeof(T);
+  }
+
+  // move the key to the aligned offset of a new storage
+  void realign_() noexcept {
+    if (storage_.empty()) return;
+    const size_type offset = align_offset_();
+    if (offset == offset_) return;
+    ::std::memmove(storage_.data() + offset, storage_.data() + offset_,
+                   (storage_.size() - (line_keys_ - 1)) * sizeof(T));
+    offset_ = offset;
+  }
+
+  // >>> eytzinger
+  // floor(log2(k)), k > 0
+  static size_type log2_(size_type k) noexcept {
+    return static_cast<size_type>(63 - __builtin_clzll(k));
+  }
+
+  // rank of node k in the sorted order. in the perfect tree of height_
+  // level the rank of node k of depth d is ((k - 2^d) * 2 + 1) *
+  // 2^(height_ - 1 - d) - 1, the leaves missing from the last level before
+  // it are subtracted, the missing leaf p has rank 2p.
+  size_type eytzinger_rank_(size_type k) const noexcept {
+    const size_type depth = log2_(k);
+    const size_type rank =
+        (((k - (size_type(1) << depth)) * 2 + 1) << (height_ - 1 - depth)) -
+        1;
+    const size_type last_level =
+        size_ - ((size_type(1) << (height_ - 1)) - 1);
+    const size_type before = (rank + 1) / 2;
+    return before > last_level ? rank - (before - last_level) : rank;
+  }
+
+  // node k of the 1-based tree is at k, 0 is unused
+  template <class RandomAccessIterator>
+  void build_(RandomAccessIterator first, false_type) {
+    if (size_ == 0) return;
+    height_ = log2_(size_) + 1;
+    allocate_(size_ + 1);
+    T *tree = storage_.data() + offset_;
+    for (size_type k = 1; k <= size_; ++k) tree[k] = first[eytzinger_rank_(k)];
+  }
+
+  // the bit of k is the path, 1 where the key was before x. the answer is
+  // the last node where the search went left, the lowest 0 bit.
+  template <bool Upper>
+  size_type search_(const key_type &x, false_type) const noexcept {
+    const T *tree = data_();
+    size_type k = 1;
+    while (k <= size_) {
+      __builtin_prefetch(reinterpret_cast<const void *>(
+          reinterpret_cast<::std::uintptr_t>(tree) + k * __cache_line_size));
+      k = 2 * k + (before_<Upper>(tree[k], x) ? 1 : 0);
+    }
+    k >>= __builtin_ctzll(~k) + 1;
+    return k == 0 ? size_ : eytzinger_rank_(k);
+  }
+
+  // >>> s_tree
+  // key of the layer above a layer of n key, a node of node_keys + 1
+  // children has node_keys key
+  static size_type parent_keys_(size_type n) noexcept {
+    const size_type nodes = (n + node_keys - 1) / node_keys;
+    return (nodes + node_keys) / (node_keys + 1) * node_keys;
+  }
+
+  // layer 0 is the leaves, the sorted key padded to a node, layer h starts
+  // at layer_offset_[h]
+  template <class RandomAccessIterator>
+  void build_(RandomAccessIterator first, true_type) {
+    if (size_ == 0) return;
+    size_type keys = (size_ + node_keys - 1) / node_keys * node_keys;
+    layer_offset_.push_back(0);
+    for (;;) {
+      layer_offset_.push_back(layer_offset_.back() + keys);
+      if (keys <= node_keys) break;
+      keys = parent_keys_(keys);
+    }
+    height_ = layer_offset_.size() - 1;
+    allocate_(layer_offset_.back());
+    T *tree = storage_.data() + offset_;
+    for (size_type i = 0; i < size_; ++i) tree[i] = first[i];
+    // key j of node i of layer h is the least key of child j + 1, the
+    // least leaf under it is the leftmost path from there
+    for (size_type h = 1; h < height_; ++h) {
+      const size_type layer_keys = layer_offset_[h + 1] - layer_offset_[h];
+      T *layer = tree + layer_offset_[h];
+      for (size_type i = 0; i < layer_keys; ++i) {
+        size_type child = i / node_keys * (node_keys + 1) + i % node_keys + 1;
+        for (size_type l = 1; l < h; ++l) child *= node_keys + 1;
+        const size_type leaf = child * node_keys;
+        layer[i] = leaf < size_ ? tree[leaf] : ::std::numeric_limits<T>::max();
+      }
+    }
+  }
+
+  // number of key of a node before x
+  template <bool Upper>
+  static size_type node_rank_(const T *node, const T &x) noexcept {
+    // a counter of 32 bits, a wider one is widened lane by lane
+    unsigned rank = 0;
+    for (size_type j = 0; j < node_keys; ++j)
+      rank += before_<Upper>(node[j], x) ? 1 : 0;
+    return rank;
+  }
+
+  // k is the offset of the node in its layer, child i of node k / 16 is at
+  // (k / 16 * 17 + i) * 16. x after the padding of the last node (the
+  // largest key, NaN) goes to its last child, the rank is size() then.
+  template <bool Upper>
+  size_type search_(const key_type &x, true_type) const noexcept {
+    if (size_ == 0) return 0;
+    const T *tree = data_();
+    size_type k = 0;
+    for (size_type h = height_ - 1; h > 0; --h) {
+      const size_type i = node_rank_<Upper>(tree + layer_offset_[h] + k, x);
+      const size_type last =
+          layer_offset_[h] - layer_offset_[h - 1] - node_keys;
+      k = k * (node_keys + 1) + i * node_keys;
+      k = k < last ? k : last;
+    }
+    const size_type rank = k + node_rank_<Upper>(tree + k, x);
+    return rank < size_ ? rank : size_;
+  }
+
+  vector<T, Allocator> storage_;
+  // first key in storage_, aligned to a cache line
+  size_type offset_;
+  size_type size_;
+  // level of the tree, layer of s_tree
+  size_type height_;
+  // offset of every layer of s_tree and its end
+  vector<size_type> layer_offset_;
+};
+
+STL_END
+
+#endif  // !_STL_STATIC_SEARCH_INDEX__
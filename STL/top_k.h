@@ -0,0 +1,155 @@
+#ifndef _STL_TOP_K__
+#define _STL_TOP_K__
+
+#include <functional>
+#include <iterator>
+#include <utility>
+#include "Def/stldef.h"
+#include "algorithm.h"
+#include "vector.h"
+
+STL_BEGIN
+
+// streaming accumulator of the k first element by comp (the k least for
+// less, the k largest for greater), as partial_sort of everything pushed
+// would put in front.
+// a buffer of 2k (64 at least) holds candidates, once it is full the k
+// first are selected by nth_element and the rest is dropped. the k-th then
+// is the threshold, an element not before it is rejected by one
+// comparison. a selection drops k at least, O(1) amortized per push in
+// worst case, and few element passes the threshold on random input.
+// every thread may accumulate its own part and merge them at the end.
+template <class T, class Compare = ::std::less<T>,
+          class Allocator = allocator<T>>
+class top_k {
+  // >>> member types
+ public:
+  typedef T value_type;
+  typedef Compare value_compare;
+  typedef Allocator allocator_type;
+  typedef vector<T, Allocator> container_type;
+  typedef const value_type &const_reference;
+  typedef ::std::size_t size_type;
+
+  // >>> constructor
+  // the buffer is allocated at once
+  explicit top_k(size_type k, const value_compare &comp = value_compare(),
+                 const allocator_type &alloc = allocator_type())
+      : buffer_(alloc),
+        comp_(comp),
+        k_(k),
+        window_(2 * k > static_cast<size_type>(__partial_select_min_window)
+                    ? 2 * k
+                    : static_cast<size_type>(__partial_select_min_window)),
+        pruned_(false) {
+    if (k_ != 0) buffer_.reserve(window_);
+  }
+
+  // >>> capacity
+  size_type k() const noexcept { return k_; }
+
+  // number of element kept, min(k, pushed)
+  size_type size() const noexcept {
+    return buffer_.size() < k_ ? buffer_.size() : k_;
+  }
+
+  bool empty() const noexcept { return buffer_.empty(); }
+
+  // >>> modifier
+  void push(const value_type &val) {
+    if (accepts_(val)) append_(val);
+  }
+
+  void push(value_type &&val) {
+    if (accepts_(val)) append_(::std::move(val));
+  }
+
+  template <class InputIterator,
+            class = typename enable_if<
+                __is_input_iterator<InputIterator>::value, void>::type>
+  void push(InputIterator first, InputIterator last) {
+    for (; first != last; ++first)
+      if (accepts_(*first)) append_(*first);
+  }
+
+  // keep the k first of both, other must have the same k. merging itself
+  // pushes a copy of its candidates, every element is counted twice.
+  void merge(const top_k &other) {
+    if (&other == this) {
+      const container_type copy(buffer_);
+      push(copy.begin(), copy.end());
+      return;
+    }
+    push(other.buffer_.begin(), other.buffer_.end());
+  }
+
+  void merge(top_k &&other) {
+    if (&other == this) {
+      merge(static_cast<const top_k &>(other));
+      return;
+    }
+    for (value_type &val : other.buffer_)
+      if (accepts_(val)) append_(::std::move(val));
+    other.clear();
+  }
+
+  void clear() noexcept {
+    buffer_.clear();
+    pruned_ = false;
+  }
+
+  // >>> result
+  // the k first sorted by comp
+  container_type sorted() const & {
+    container_type result(buffer_);
+    sort_(result);
+    return result;
+  }
+
+  // the accumulator is empty after it
+  container_type sorted() && {
+    container_type result(::std::move(buffer_));
+    clear();
+    sort_(result);
+    return result;
+  }
+
+ private:
+  bool accepts_(const value_type &val) {
+    return k_ != 0 && (!pruned_ || comp_(val, buffer_[k_ - 1]));
+  }
+
+  template <class U>
+  void append_(U &&val) {
+    buffer_.push_back(::std::forward<U>(val));
+    if (buffer_.size() == window_) prune_();
+  }
+
+  // the k first to the front, the k-th at k - 1
+  void prune_() {
+    STL_NAME::nth_element(buffer_.begin(), buffer_.begin() + (k_ - 1),
+                          buffer_.end(), comp_);
+    buffer_.erase(buffer_.begin() + k_, buffer_.end());
+    pruned_ = true;
+  }
+
+  void sort_(container_type &c) const {
+    value_compare comp = comp_;
+    if (c.size() > k_) {
+      STL_NAME::nth_element(c.begin(), c.begin() + k_, c.end(), comp);
+      c.erase(c.begin() + k_, c.end());
+    }
+    STL_NAME::sort(c.begin(), c.end(), comp);
+  }
+
+  container_type buffer_;
+  value_compare comp_;
+  size_type k_;
+  size_type window_;
+  // buffer_[k_ - 1] is the threshold
+  bool pruned_;
+};
+
+STL_END
+
+#endif  // !_STL_TOP_K__
@@ -236,6 +236,7 @@ class vector : private __vector_base<T, Allocator> {
       alloc_traits_::is_always_equal::value);
   vector &operator=(::std::initializer_list<value_type> init) {
     assign(init.begin(), init.end());
+    return *this;
   }
 
   // assign
@@ -598,6 +599,7 @@ void vector<T, Allocator>::move_range_(pointer src_first, pointer src_last,
 template <class T, class Allocator>
 void vector<T, Allocator>::move_assign_(vector &x, true_type) noexcept(
     ::std::is_nothrow_move_assignable<allocator_type>::value) {
+  deallocate_();
   base_::move_assign_alloc_(x);
   this->begin_ = x.begin_;
   this->end_ = x.end_;
@@ -765,7 +767,7 @@ vector<T, Allocator>::vector(
                 typename iterator_traits<ForwardIterator>::reference>::value,
         ForwardIterator>::type last) {
   // gets the element number for allocating enough space
-  size_type new_size = static_cast<size_type>(::std::distance(last, first));
+  size_type new_size = static_cast<size_type>(::std::distance(first, last));
   if (new_size > 0) {
     allocate_(new_size);
     copy_construct_at_end_(first, last);
@@ -860,8 +862,8 @@ template <class T, class Allocator>
 vector<T, Allocator> &vector<T, Allocator>::operator=(const vector &x) {
   // self assignment check
   if (this != &x) {
-    base_::copy_assign_alloc_(x.alloc_);
-    assgin(x.begin_, x.end_);
+    base_::copy_assign_alloc_(x);
+    assign(x.begin_, x.end_);
   }
   return *this;
 }
@@ -1206,7 +1208,7 @@ vector<T, Allocator>::insert(const_iterator position, ForwardIterator first,
 template <class T, class Allocator>
 typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(
     const_iterator position, ::std::initializer_list<value_type> init) {
-  insert(position, init.begin(), init.end());
+  return insert(position, init.begin(), init.end());
 }
 
 template <class T, class Allocator>
@@ -1298,48 +1300,48 @@ void vector<T, Allocator>::swap(vector &x) noexcept(
 
 // lexicographical comparation
 template <class T, class Allocator>
-inline bool operator==(const vector<T, Allocator> lhs,
-                       const vector<T, Allocator> rhs) {
+inline bool operator==(const vector<T, Allocator> &lhs,
+                       const vector<T, Allocator> &rhs) {
   return lhs.size() == rhs.size() &&
          ::std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
 template <class T, class Allocator>
-inline bool operator!=(const vector<T, Allocator> lhs,
-                       const vector<T, Allocator> rhs) {
-  return !(rhs == rhs);
+inline bool operator!=(const vector<T, Allocator> &lhs,
+                       const vector<T, Allocator> &rhs) {
+  return !(lhs == rhs);
 }
 
 template <class T, class Allocator>
-inline bool operator<(const vector<T, Allocator> lhs,
-                      const vector<T, Allocator> rhs) {
+inline bool operator<(const vector<T, Allocator> &lhs,
+                      const vector<T, Allocator> &rhs) {
   return ::std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
                                         rhs.end());
 }
 
 template <class T, class Allocator>
-inline bool operator>(const vector<T, Allocator> lhs,
-                      const vector<T, Allocator> rhs) {
+inline bool operator>(const vector<T, Allocator> &lhs,
+                      const vector<T, Allocator> &rhs) {
   return rhs < lhs;
 }
 
 template <class T, class Allocator>
-inline bool operator<=(const vector<T, Allocator> lhs,
-                       const vector<T, Allocator> rhs) {
+inline bool operator<=(const vector<T, Allocator> &lhs,
+                       const vector<T, Allocator> &rhs) {
   return !(rhs < lhs);
 }
 
 template <class T, class Allocator>
-inline bool operator>=(const vector<T, Allocator> lhs,
-                       const vector<T, Allocator> rhs) {
+inline bool operator>=(const vector<T, Allocator> &lhs,
+                       const vector<T, Allocator> &rhs) {
   return !(lhs < rhs);
 }
 
 // swap fucntion
 template <class T, class Allocator>
 inline void swap(
-    const vector<T, Allocator> lhs,
-    const vector<T, Allocator> rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    vector<T, Allocator> &lhs,
+    vector<T, Allocator> &rhs) noexcept(noexcept(lhs.swap(rhs))) {
   lhs.swap(rhs);
 }
 
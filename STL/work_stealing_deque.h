@@ -0,0 +1,252 @@
+#ifndef _STL_WORK_STEALING_DEQUE__
+#define _STL_WORK_STEALING_DEQUE__
+
+#include <atomic>
+#include <cstdint>
+#include "Def/stldef.h"
+#include "__concurrency.h"
+
+STL_BEGIN
+
+// Chase-Lev work-stealing deque, C11 memory model version of
+// Le, Pop, Cohen and Zappa Nardelli (PPoPP 2013).
+// only one thread (the owner) may push and pop at the bottom, any thread may
+// steal from the top. owner never takes a lock, thief takes an element by one
+// CAS on top.
+// element lives in a growable circular array of power of two capacity.
+// a thief may still read the old array after the owner grows it, so old
+// array is retired into a list and freed with the deque. the retired arrays
+// are at most as large as the current one.
+// a thief reads the slot before its CAS decides the element is its, the
+// read may race with the owner overwriting it, so T must be trivially
+// copyable, e.g. a pointer to task.
+template <class T, class Allocator = allocator<T>>
+class work_stealing_deque {
+  static_assert(::std::is_trivially_copyable<T>::value,
+                "element of work_stealing_deque must be trivially copyable");
+
+  // >>> member types
+ public:
+  typedef T value_type;
+  typedef Allocator allocator_type;
+  typedef value_type &reference;
+  typedef const value_type &const_reference;
+  typedef ::std::size_t size_type;
+
+ private:
+  typedef ::std::int64_t index_type_;
+  typedef ::std::atomic<value_type> slot_;
+
+  // circular array, slot of index i is slots_[i & mask_]
+  struct array_ {
+    index_type_ mask_;
+    slot_ *slots_;
+    array_ *retired_;  // array replaced by this one
+
+    index_type_ capacity() const noexcept { return mask_ + 1; }
+
+    value_type get(index_type_ i) const noexcept {
+      return slots_[i & mask_].load(::std::memory_order_relaxed);
+    }
+
+    void put(index_type_ i, const value_type &val) noexcept {
+      slots_[i & mask_].store(val, ::std::memory_order_relaxed);
+    }
+  };
+
+  typedef allocator_traits<allocator_type> alloc_traits_;
+  typedef typename alloc_traits_::template rebind_alloc<slot_>
+      slot_allocator_type_;
+  typedef allocator_traits<slot_allocator_type_> slot_alloc_traits_;
+  typedef typename alloc_traits_::template rebind_alloc<array_>
+      array_allocator_type_;
+  typedef allocator_traits<array_allocator_type_> array_alloc_traits_;
+
+  static_assert(::std::is_same<typename alloc_traits_::void_pointer,
+                               void *>::value,
+                "work_stealing_deque needs allocator with raw pointer");
+
+ public:
+  // >>> constructor
+  work_stealing_deque() : work_stealing_deque(default_capacity_) {}
+
+  // capacity is rounded up to power of two
+  explicit work_stealing_deque(size_type capacity,
+                               const allocator_type &alloc = allocator_type());
+
+  // no copy or move, address of top and bottom is shared by threads
+  work_stealing_deque(const work_stealing_deque &) = delete;
+
+  work_stealing_deque &operator=(const work_stealing_deque &) = delete;
+
+  // >>> destructor
+  // no other thread may access the deque now
+  ~work_stealing_deque();
+
+  // >>> allocator
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(slot_alloc_);
+  }
+
+  // >>> capacity
+  // only a snapshot if other thread is running
+  bool empty() const noexcept { return size() == 0; }
+
+  size_type size() const noexcept {
+    index_type_ b = bottom_.load(::std::memory_order_relaxed);
+    index_type_ t = top_.load(::std::memory_order_relaxed);
+    return b > t ? static_cast<size_type>(b - t) : 0;
+  }
+
+  // capacity of current array, only for owner
+  size_type capacity() const noexcept {
+    return static_cast<size_type>(
+        array_ptr_.load(::std::memory_order_relaxed)->capacity());
+  }
+
+  // >>> modifier
+  // owner only: push val at bottom, grow the array if it is full
+  void push(const value_type &val);
+
+  // owner only: pop the bottom element into val (LIFO)
+  // return false if deque is empty or the last element is stolen, val is
+  // unchanged then
+  bool pop(value_type &val) noexcept;
+
+  // any thread: steal the top element into val (FIFO)
+  // return false if deque is empty or another thread takes it first
+  bool steal(value_type &val) noexcept;
+
+ private:
+  // >>> private auxiliary function
+  array_ *allocate_array_(index_type_ capacity);
+
+  void deallocate_array_(array_ *a) noexcept;
+
+  // copy [t, b) to a new array of double capacity and publish it
+  array_ *grow_(array_ *a, index_type_ t, index_type_ b);
+
+  static const size_type default_capacity_ = 64;
+
+  // >>> data member
+  // top_ is written by thieves, bottom_ and array by owner, keep them apart
+  alignas(__cache_line_size)::std::atomic<index_type_> top_;
+  alignas(__cache_line_size)::std::atomic<index_type_> bottom_;
+  ::std::atomic<array_ *> array_ptr_;
+  slot_allocator_type_ slot_alloc_;
+};
+
+template <class T, class Allocator>
+work_stealing_deque<T, Allocator>::work_stealing_deque(
+    size_type capacity, const allocator_type &alloc)
+    : top_(0), bottom_(0), array_ptr_(nullptr), slot_alloc_(alloc) {
+  index_type_ n = 1;
+  while (static_cast<size_type>(n) < capacity) n <<= 1;
+  array_ptr_.store(allocate_array_(n), ::std::memory_order_relaxed);
+}
+
+template <class T, class Allocator>
+work_stealing_deque<T, Allocator>::~work_stealing_deque() {
+  array_ *a = array_ptr_.load(::std::memory_order_acquire);
+  while (a != nullptr) {
+    array_ *retired = a->retired_;
+    deallocate_array_(a);
+    a = retired;
+  }
+}
+
+template <class T, class Allocator>
+typename work_stealing_deque<T, Allocator>::array_ *
+work_stealing_deque<T, Allocator>::allocate_array_(index_type_ capacity) {
+  array_allocator_type_ array_alloc(slot_alloc_);
+  array_ *a = array_alloc_traits_::allocate(array_alloc, 1);
+  try {
+    a->slots_ = slot_alloc_traits_::allocate(slot_alloc_, capacity);
+  } catch (...) {
+    array_alloc_traits_::deallocate(array_alloc, a, 1);
+    throw;
+  }
+  // atomic of trivially copyable T, no constructor can throw
+  for (index_type_ i = 0; i < capacity; ++i)
+    ::new (static_cast<void *>(a->slots_ + i)) slot_();
+  a->mask_ = capacity - 1;
+  a->retired_ = nullptr;
+  return a;
+}
+
+template <class T, class Allocator>
+void work_stealing_deque<T, Allocator>::deallocate_array_(array_ *a) noexcept {
+  array_allocator_type_ array_alloc(slot_alloc_);
+  slot_alloc_traits_::deallocate(slot_alloc_, a->slots_, a->capacity());
+  array_alloc_traits_::deallocate(array_alloc, a, 1);
+}
+
+template <class T, class Allocator>
+typename work_stealing_deque<T, Allocator>::array_ *
+work_stealing_deque<T, Allocator>::grow_(array_ *a, index_type_ t,
+                                         index_type_ b) {
+  array_ *new_a = allocate_array_(a->capacity() * 2);
+  for (index_type_ i = t; i != b; ++i) new_a->put(i, a->get(i));
+  new_a->retired_ = a;
+  // release: slots of new array are visible to the thief loading it
+  array_ptr_.store(new_a, ::std::memory_order_release);
+  return new_a;
+}
+
+template <class T, class Allocator>
+void work_stealing_deque<T, Allocator>::push(const value_type &val) {
+  index_type_ b = bottom_.load(::std::memory_order_relaxed);
+  index_type_ t = top_.load(::std::memory_order_acquire);
+  array_ *a = array_ptr_.load(::std::memory_order_relaxed);
+  if (b - t > a->mask_) a = grow_(a, t, b);
+  a->put(b, val);
+  // release: slot is visible to the thief seeing the new bottom
+  bottom_.store(b + 1, ::std::memory_order_release);
+}
+
+template <class T, class Allocator>
+bool work_stealing_deque<T, Allocator>::pop(value_type &val) noexcept {
+  index_type_ b = bottom_.load(::std::memory_order_relaxed) - 1;
+  array_ *a = array_ptr_.load(::std::memory_order_relaxed);
+  // seq_cst store and load: a thief can not miss the reserved bottom while
+  // the owner misses its top, they agree on who takes the last element
+  bottom_.store(b, ::std::memory_order_seq_cst);
+  index_type_ t = top_.load(::std::memory_order_seq_cst);
+  if (t > b) {
+    // empty, restore bottom
+    bottom_.store(b + 1, ::std::memory_order_relaxed);
+    return false;
+  }
+  value_type x = a->get(b);
+  if (t < b) {
+    val = x;
+    return true;
+  }
+  // the last element, race with thieves for it, val is kept if one wins
+  bool taken = top_.compare_exchange_strong(t, t + 1,
+                                            ::std::memory_order_seq_cst,
+                                            ::std::memory_order_relaxed);
+  bottom_.store(b + 1, ::std::memory_order_relaxed);
+  if (taken) val = x;
+  return taken;
+}
+
+template <class T, class Allocator>
+bool work_stealing_deque<T, Allocator>::steal(value_type &val) noexcept {
+  index_type_ t = top_.load(::std::memory_order_seq_cst);
+  index_type_ b = bottom_.load(::std::memory_order_seq_cst);
+  if (t >= b) return false;
+  // the array may be replaced after the load, but slot t of the old one
+  // keeps its value until top passes t
+  array_ *a = array_ptr_.load(::std::memory_order_acquire);
+  value_type x = a->get(t);
+  if (!top_.compare_exchange_strong(t, t + 1, ::std::memory_order_seq_cst,
+                                    ::std::memory_order_relaxed))
+    return false;
+  val = x;
+  return true;
+}
+
+STL_END
+
+#endif  // !_STL_WORK_STEALING_DEQUE__